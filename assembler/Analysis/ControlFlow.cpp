@@ -0,0 +1,287 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "ControlFlow.h"
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+constexpr int PC = 7;
+constexpr int LR = 6;
+
+enum class Flow { NEXT, BRANCH, CONDITIONAL, CALL, RETURN, STOP, JUMP, INDIRECT };
+
+struct Decoded {
+    Flow flow;
+    int target;
+};
+
+int signExtend9(uint16_t word) {
+    return (word & 0x100) ? static_cast<int>(word & 0x1FF) - 0x200 : (word & 0x1FF);
+}
+
+Decoded decode(uint16_t word, int address) {
+    const int opcode = word >> 13;
+    const bool immediate = (word & 0x1000) != 0;
+    const int rX = (word >> 9) & 7;
+
+    if (word == 0x21FF || ((word & 0xE1F0) == 0xE1F0 && !immediate)) {
+        return {Flow::STOP, 0};
+    }
+    if (opcode == 1 && !immediate) {
+        const int target = address + 1 + signExtend9(word);
+        if (rX == 0) return {Flow::BRANCH, target};
+        if (rX == 7) return {Flow::CALL, target};
+        return {Flow::CONDITIONAL, target};
+    }
+    if (rX != PC) {
+        return {Flow::NEXT, 0};
+    }
+
+    // Everything below writes pc, except st, push and cmp.
+    if (opcode == 5 || (opcode == 7 && (immediate || !(word & 0x100)))) {
+        return {Flow::NEXT, 0};
+    }
+    if (opcode == 0 && !immediate && (word & 7) == LR) return {Flow::RETURN, 0};
+    if (opcode == 4 && immediate) return {Flow::RETURN, 0};     // pop pc
+    if (opcode == 0 && immediate) return {Flow::JUMP, signExtend9(word) & 0xFFFF};
+    return {Flow::INDIRECT, 0};
+}
+
+std::string hexAddress(int address) {
+    std::ostringstream text;
+    text << "0x" << std::hex << address;
+    return text.str();
+}
+}
+
+int ControlFlowGraph::blockAt(int address) const {
+    if (address < 0 || static_cast<size_t>(address) >= blockIndex.size()) return -1;
+    return blockIndex[address];
+}
+
+void ControlFlowGraph::discoverBlocks(const std::vector<uint16_t>& words, const std::vector<bool>& isData) {
+    const int size = static_cast<int>(words.size());
+    std::vector<char> reached(size, 0);
+    std::set<int> leaders = {0};
+    std::set<int> entries = {0};
+    std::vector<int> work = {0};
+
+    auto check = [&](int target, int from) {
+        if (target < 0 || target >= size) {
+            throw std::runtime_error("Control flow at " + hexAddress(from) + " leaves the program (" +
+                                     hexAddress(target) + ")");
+        }
+    };
+
+    while (!work.empty()) {
+        int address = work.back();
+        work.pop_back();
+        if (reached[address]) continue;
+        if (address < static_cast<int>(isData.size()) && isData[address]) {
+            throw std::runtime_error("Control flow reaches data at " + hexAddress(address));
+        }
+        reached[address] = 1;
+
+        Decoded d = decode(words[address], address);
+        switch (d.flow) {
+            case Flow::NEXT:
+                check(address + 1, address);
+                work.push_back(address + 1);
+                break;
+            case Flow::CONDITIONAL:
+            case Flow::CALL:
+                check(address + 1, address);
+                leaders.insert(address + 1);
+                work.push_back(address + 1);
+                // fall through
+            case Flow::BRANCH:
+            case Flow::JUMP:
+                check(d.target, address);
+                leaders.insert(d.target);
+                work.push_back(d.target);
+                if (d.flow == Flow::CALL) entries.insert(d.target);
+                break;
+            case Flow::RETURN:
+            case Flow::STOP:
+                break;
+            case Flow::INDIRECT:
+                throw std::runtime_error("Indirect jump at " + hexAddress(address) +
+                                         " cannot be analyzed (only mv pc, lr and pop pc return)");
+        }
+    }
+
+    blocks.clear();
+    blockIndex.assign(size, -1);
+    for (int address = 0; address < size; ) {
+        if (!reached[address]) {
+            address++;
+            continue;
+        }
+        BasicBlock block;
+        block.start = address;
+        Decoded d;
+        for (;;) {
+            d = decode(words[address], address);
+            blockIndex[address] = static_cast<int>(blocks.size());
+            address++;
+            if (d.flow != Flow::NEXT || address >= size || !reached[address] || leaders.count(address)) {
+                break;
+            }
+        }
+        block.end = address;
+        block.returns = d.flow == Flow::RETURN;
+        block.stops = d.flow == Flow::STOP;
+        if (d.flow == Flow::CALL) block.callee = d.target;
+        blocks.push_back(block);
+    }
+
+    // Successors as block indices, now that every leader starts a block.
+    for (auto& block : blocks) {
+        const int last = block.end - 1;
+        Decoded d = decode(words[last], last);
+        if (d.flow == Flow::BRANCH || d.flow == Flow::JUMP || d.flow == Flow::CONDITIONAL) {
+            block.successors.push_back(blockIndex[d.target]);
+        }
+        if (d.flow == Flow::NEXT || d.flow == Flow::CONDITIONAL || d.flow == Flow::CALL) {
+            int next = blockIndex[block.end];
+            if (std::find(block.successors.begin(), block.successors.end(), next) == block.successors.end()) {
+                block.successors.push_back(next);
+            }
+        }
+    }
+
+    routines.clear();
+    for (int entry : entries) {
+        Routine routine;
+        routine.entry = entry;
+        routines.push_back(routine);
+    }
+}
+
+void ControlFlowGraph::buildRoutine(Routine& routine) const {
+    const int count = static_cast<int>(blocks.size());
+    const int entry = blockIndex[routine.entry];
+
+    // Reverse postorder of the blocks reachable from the entry.
+    std::vector<int> order;
+    std::vector<char> visited(count, 0);
+    std::vector<std::pair<int, size_t>> stack = {{entry, 0}};
+    visited[entry] = 1;
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        const auto& successors = blocks[top.first].successors;
+        if (top.second < successors.size()) {
+            int next = successors[top.second++];
+            if (!visited[next]) {
+                visited[next] = 1;
+                stack.push_back({next, 0});
+            }
+        } else {
+            order.push_back(top.first);
+            stack.pop_back();
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    routine.blocks = order;
+
+    std::vector<int> rpo(count, -1);
+    for (size_t i = 0; i < order.size(); i++) rpo[order[i]] = static_cast<int>(i);
+    std::vector<std::vector<int>> predecessors(count);
+    for (int b : order) {
+        for (int s : blocks[b].successors) predecessors[s].push_back(b);
+    }
+
+    // Dominators (Cooper, Harvey, Kennedy).
+    std::vector<int> idom(count, -1);
+    idom[entry] = entry;
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (size_t i = 1; i < order.size(); i++) {
+            int b = order[i];
+            int dominator = -1;
+            for (int p : predecessors[b]) {
+                if (idom[p] < 0) continue;
+                if (dominator < 0) {
+                    dominator = p;
+                    continue;
+                }
+                int x = p, y = dominator;
+                while (x != y) {
+                    while (rpo[x] > rpo[y]) x = idom[x];
+                    while (rpo[y] > rpo[x]) y = idom[y];
+                }
+                dominator = x;
+            }
+            if (dominator != idom[b]) {
+                idom[b] = dominator;
+                changed = true;
+            }
+        }
+    }
+    auto dominates = [&](int a, int b) {
+        for (;;) {
+            if (a == b) return true;
+            if (b == entry) return false;
+            b = idom[b];
+        }
+    };
+
+    // Natural loops, one per header, merged over all of its back edges.
+    std::vector<int> loopOfHeader(count, -1);
+    for (int b : order) {
+        for (int s : blocks[b].successors) {
+            if (!dominates(s, b)) continue;
+            if (loopOfHeader[s] < 0) {
+                loopOfHeader[s] = static_cast<int>(routine.loops.size());
+                Loop loop;
+                loop.header = s;
+                loop.body.push_back(s);
+                routine.loops.push_back(loop);
+            }
+            Loop& loop = routine.loops[loopOfHeader[s]];
+            loop.latches.push_back(b);
+
+            std::vector<char> inBody(count, 0);
+            for (int x : loop.body) inBody[x] = 1;
+            std::vector<int> work = {b};
+            while (!work.empty()) {
+                int x = work.back();
+                work.pop_back();
+                if (inBody[x]) continue;
+                inBody[x] = 1;
+                loop.body.push_back(x);
+                for (int p : predecessors[x]) work.push_back(p);
+            }
+        }
+    }
+
+    std::stable_sort(routine.loops.begin(), routine.loops.end(),
+                     [](const Loop& a, const Loop& b) { return a.body.size() < b.body.size(); });
+    for (size_t i = 0; i < routine.loops.size(); i++) {
+        for (size_t j = i + 1; j < routine.loops.size(); j++) {
+            const auto& outer = routine.loops[j].body;
+            if (std::find(outer.begin(), outer.end(), routine.loops[i].header) != outer.end()) {
+                routine.loops[i].parent = static_cast<int>(j);
+                break;
+            }
+        }
+    }
+}
+
+void ControlFlowGraph::build(const std::vector<uint16_t>& words, const std::vector<bool>& isData) {
+    blocks.clear();
+    blockIndex.clear();
+    routines.clear();
+    if (words.empty()) {
+        return;
+    }
+    discoverBlocks(words, isData);
+    for (auto& routine : routines) {
+        buildRoutine(routine);
+    }
+}
@@ -0,0 +1,56 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Basic-block control-flow graph of an encoded qCore image.
+//              Blocks are discovered by following branches, bl calls and
+//              writes to pc from address 0, so data words are never decoded.
+//              Each routine (address 0 and every bl target) gets dominators
+//              and natural loops for the timing analysis in Wcet.h.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct BasicBlock {
+    int start = 0;                  // first word address
+    int end = 0;                    // one past the last word
+    std::vector<int> successors;    // block indices, calls excluded
+    int callee = -1;                // entry address when the block ends in bl
+    bool returns = false;           // ends in mv pc, lr or pop pc
+    bool stops = false;             // ends in halt or a branch to itself
+};
+
+struct Loop {
+    int header;                     // block index
+    std::vector<int> body;          // block indices, header included
+    std::vector<int> latches;       // blocks with a back edge to header
+    int parent = -1;                // innermost enclosing loop, -1 if none
+};
+
+struct Routine {
+    int entry;                      // address
+    std::vector<int> blocks;        // reachable without following calls, RPO
+    std::vector<Loop> loops;        // ordered innermost first
+};
+
+class ControlFlowGraph {
+private:
+    std::vector<BasicBlock> blocks;
+    std::vector<int> blockIndex;    // per address, -1 outside any block
+    std::vector<Routine> routines;
+
+    void discoverBlocks(const std::vector<uint16_t>& words, const std::vector<bool>& isData);
+    void buildRoutine(Routine& routine) const;
+
+public:
+    // Throws std::runtime_error when control reaches data or the end of the
+    // image, or jumps through a register other than lr.
+    void build(const std::vector<uint16_t>& words, const std::vector<bool>& isData);
+
+    const std::vector<BasicBlock>& getBlocks() const { return blocks; }
+    const std::vector<Routine>& getRoutines() const { return routines; }
+    // -1 when address is not the start or inside of a reachable block.
+    int blockAt(int address) const;
+};
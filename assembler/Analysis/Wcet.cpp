@@ -0,0 +1,268 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "Wcet.h"
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+
+int CycleTable::cycles(uint16_t word) const {
+    const bool immediate = (word & 0x1000) != 0;
+    switch (word >> 13) {
+        case 0: return move;
+        case 1: return immediate ? move : branch;
+        case 2:
+        case 3:
+        case 6: return alu;
+        case 4: return load;
+        case 5: return store;
+        default: return (immediate || !(word & 0x100)) ? compare : alu;
+    }
+}
+
+WcetAnalysis::WcetAnalysis(const AssembleResult& result, const CycleTable& table)
+    : result(result), table(table) {}
+
+void WcetAnalysis::addLoopBound(const std::string& label, uint64_t bound) {
+    for (const auto& symbol : result.symbols) {
+        if (symbol.isLabel && symbol.name == label) {
+            bounds[symbol.value] = bound;
+            return;
+        }
+    }
+    throw std::runtime_error("Unknown label in loop bound: " + label);
+}
+
+void WcetAnalysis::addSourceBounds(const std::string& source) {
+    std::map<int, int> addressOfLine;
+    for (const auto& row : result.lineTable) {
+        addressOfLine.emplace(row.line, row.address);
+    }
+
+    int line = 1;
+    for (size_t begin = 0; begin < source.length(); line++) {
+        size_t end = source.find('\n', begin);
+        if (end == std::string::npos) end = source.length();
+        // Searches stay inside the line; a file without markers is one pass.
+        static const std::string COMMENT = "//";
+        static const std::string BOUND = "@bound";
+        const auto lineEnd = source.begin() + end;
+        const auto comment = std::search(source.begin() + begin, lineEnd, COMMENT.begin(), COMMENT.end());
+        if (comment != lineEnd) {
+            const size_t marker = std::search(comment, lineEnd, BOUND.begin(), BOUND.end()) - source.begin();
+            if (marker < end) {
+                auto address = addressOfLine.find(line);
+                if (address == addressOfLine.end()) {
+                    throw AssemblyError("@bound on a line without an instruction", line);
+                }
+                std::istringstream value(source.substr(marker + 6, end - marker - 6));
+                uint64_t bound;
+                if (!(value >> bound)) {
+                    throw AssemblyError("Expected a number after @bound", line);
+                }
+                bounds[address->second] = bound;
+            }
+        }
+        begin = end + 1;
+    }
+}
+
+std::string WcetAnalysis::nameOf(int address) const {
+    for (const auto& symbol : result.symbols) {
+        if (symbol.isLabel && symbol.value == address) return symbol.name;
+    }
+    std::ostringstream text;
+    text << "0x" << std::hex << address;
+    return text.str();
+}
+
+int WcetAnalysis::lineOf(int address) const {
+    auto row = std::upper_bound(rows.begin(), rows.end(), address,
+                                [](int a, const LineEntry& e) { return a < e.address; });
+    return row == rows.begin() ? 0 : (row - 1)->line;
+}
+
+uint64_t WcetAnalysis::blockCycles(int index) {
+    const BasicBlock& block = cfg.getBlocks()[index];
+    uint64_t cycles = 0;
+    for (int address = block.start; address < block.end; address++) {
+        cycles += table.cycles(words[address]);
+    }
+    if (block.callee >= 0) {
+        const auto& routines = cfg.getRoutines();
+        size_t callee = 0;
+        while (routines[callee].entry != block.callee) callee++;
+        if (state[callee] == 1) {
+            throw std::runtime_error("recursive call to " + nameOf(block.callee));
+        }
+        analyzeRoutine(callee);
+        if (!reports[callee].bounded) {
+            throw std::runtime_error("calls " + reports[callee].name + ", which is unbounded");
+        }
+        cycles += reports[callee].cycles;
+    }
+    return cycles;
+}
+
+void WcetAnalysis::analyzeRoutine(size_t index) {
+    if (state[index] != 0) return;
+    state[index] = 1;
+
+    const Routine& routine = cfg.getRoutines()[index];
+    const auto& blocks = cfg.getBlocks();
+    const int blockCount = static_cast<int>(blocks.size());
+    const int loopCount = static_cast<int>(routine.loops.size());
+    RoutineReport& report = reports[index];
+    report.name = nameOf(routine.entry);
+    report.entry = routine.entry;
+    report.words = 0;
+    for (int b : routine.blocks) report.words += blocks[b].end - blocks[b].start;
+
+    // Nodes 0..blockCount-1 are blocks, blockCount + l stands for loop l
+    // collapsed into a single node.
+    std::vector<int> innermost(blockCount, -1);
+    std::vector<std::vector<char>> inLoop(loopCount, std::vector<char>(blockCount, 0));
+    for (int l = 0; l < loopCount; l++) {
+        for (int b : routine.loops[l].body) {
+            inLoop[l][b] = 1;
+            if (innermost[b] < 0) innermost[b] = l;
+        }
+    }
+    std::vector<uint64_t> loopCycles(loopCount, 0);
+    std::vector<char> loopTerminal(loopCount, 0);
+    std::vector<std::vector<int>> loopExits(loopCount);
+
+    try {
+        std::vector<uint64_t> cost(blockCount, 0);
+        for (int b : routine.blocks) cost[b] = blockCycles(b);
+
+        // Node standing for block b inside region (loop index, -1 = routine).
+        auto representative = [&](int b, int region) {
+            int l = innermost[b];
+            if (l == region) return b;
+            while (routine.loops[l].parent != region) l = routine.loops[l].parent;
+            return blockCount + l;
+        };
+
+        // Longest paths from a node to the region's back edges (latch) and
+        // to anything leaving the region or ending the routine (exit);
+        // -1 when no such path exists.
+        struct Distance { int64_t latch; int64_t exit; };
+        auto longestPaths = [&](int region, int start) {
+            std::vector<Distance> memo(blockCount + loopCount, {-1, -1});
+            std::vector<char> visit(blockCount + loopCount, 0);
+            const int header = region >= 0 ? routine.loops[region].header : -1;
+
+            std::function<Distance(int)> walk = [&](int node) -> Distance {
+                if (visit[node] == 2) return memo[node];
+                if (visit[node] == 1) {
+                    throw std::runtime_error("irreducible control flow at " +
+                                             nameOf(blocks[node < blockCount ? node : routine.loops[node - blockCount].header].start));
+                }
+                visit[node] = 1;
+
+                uint64_t nodeCost;
+                bool terminal;
+                const std::vector<int>* successors;
+                if (node < blockCount) {
+                    nodeCost = cost[node];
+                    terminal = blocks[node].returns || blocks[node].stops;
+                    successors = &blocks[node].successors;
+                } else {
+                    nodeCost = loopCycles[node - blockCount];
+                    terminal = loopTerminal[node - blockCount] != 0;
+                    successors = &loopExits[node - blockCount];
+                }
+
+                Distance d = {-1, terminal ? 0 : -1};
+                for (int s : *successors) {
+                    if (s == header) {
+                        d.latch = std::max<int64_t>(d.latch, 0);
+                    } else if (region >= 0 && !inLoop[region][s]) {
+                        d.exit = std::max<int64_t>(d.exit, 0);
+                    } else {
+                        Distance next = walk(representative(s, region));
+                        d.latch = std::max(d.latch, next.latch);
+                        d.exit = std::max(d.exit, next.exit);
+                    }
+                }
+                if (d.latch >= 0) d.latch += nodeCost;
+                if (d.exit >= 0) d.exit += nodeCost;
+
+                visit[node] = 2;
+                memo[node] = d;
+                return d;
+            };
+            return walk(start);
+        };
+
+        for (int l = 0; l < loopCount; l++) {
+            const Loop& loop = routine.loops[l];
+            for (int b : loop.body) {
+                if (blocks[b].returns || blocks[b].stops) loopTerminal[l] = 1;
+                for (int s : blocks[b].successors) {
+                    if (!inLoop[l][s] && std::find(loopExits[l].begin(), loopExits[l].end(), s) == loopExits[l].end()) {
+                        loopExits[l].push_back(s);
+                    }
+                }
+            }
+
+            const int headerAddress = blocks[loop.header].start;
+            auto bound = bounds.find(headerAddress);
+            if (bound == bounds.end()) {
+                throw std::runtime_error("loop at " + nameOf(headerAddress) + " (line " +
+                                         std::to_string(lineOf(headerAddress)) + ") has no bound");
+            }
+            Distance pass = longestPaths(l, loop.header);
+            uint64_t iteration = static_cast<uint64_t>(std::max(pass.latch, pass.exit));
+            loopCycles[l] = bound->second * iteration;
+            report.loops.push_back({headerAddress, lineOf(headerAddress), bound->second, iteration});
+        }
+
+        Distance whole = longestPaths(-1, representative(routine.blocks.front(), -1));
+        if (whole.exit < 0) {
+            throw std::runtime_error("never returns");
+        }
+        report.cycles = static_cast<uint64_t>(whole.exit);
+        report.bounded = true;
+    } catch (const std::exception& e) {
+        report.problem = e.what();
+    }
+    state[index] = 2;
+}
+
+const std::vector<RoutineReport>& WcetAnalysis::run() {
+    expandSegments(result.words, result.isData, result.segments, words, isData);
+    rows = result.lineTable;
+    std::stable_sort(rows.begin(), rows.end(),
+                     [](const LineEntry& a, const LineEntry& b) { return a.address < b.address; });
+    cfg.build(words, isData);
+    reports.assign(cfg.getRoutines().size(), RoutineReport());
+    state.assign(cfg.getRoutines().size(), 0);
+    for (size_t i = 0; i < reports.size(); i++) {
+        analyzeRoutine(i);
+    }
+    return reports;
+}
+
+void writeWcetReport(std::ostream& out, const std::vector<RoutineReport>& reports) {
+    out << std::left << std::setw(20) << "Routine" << std::right << std::setw(8) << "Entry"
+        << std::setw(8) << "Words" << std::setw(16) << "WCET (cycles)" << "\n";
+    for (const auto& report : reports) {
+        std::ostringstream entry;
+        entry << "0x" << std::hex << report.entry;
+        out << std::left << std::setw(20) << report.name << std::right << std::setw(8) << entry.str()
+            << std::setw(8) << report.words << std::setw(16)
+            << (report.bounded ? std::to_string(report.cycles) : "unbounded") << "\n";
+        for (const auto& loop : report.loops) {
+            out << "    loop at line " << loop.line << ": " << loop.bound << " x "
+                << loop.iterationCycles << " cycles\n";
+        }
+        if (!report.bounded) {
+            out << "    " << report.problem << "\n";
+        }
+    }
+}
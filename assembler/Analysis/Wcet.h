@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Worst-case cycle bounds per routine. Each loop is collapsed,
+//              innermost first, into a node costing bound x its longest
+//              iteration. The routine bound is then the longest path through
+//              the resulting DAG, with bl calls charged the callee's bound.
+//
+//              Loop bounds give the maximum number of times the loop header
+//              runs per entry into the loop. They come from --loop-bound
+//              LABEL=N or from a "// @bound N" comment on the line of the
+//              header's first instruction.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "Assembler/Assembler.h"
+#include "ControlFlow.h"
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Cycles per instruction class. The defaults follow the qCore multicycle
+// FSM from the lab: three fetch states, then one state for moves and
+// branches, two for compares and stores, three for ALU ops and loads.
+struct CycleTable {
+    int move = 4;       // mv, mvt
+    int branch = 4;     // b<cond>, bl, taken or not
+    int alu = 6;        // add, sub, and, xor, lsl, lsr, asr, ror
+    int compare = 5;    // cmp
+    int load = 6;       // ld, pop
+    int store = 5;      // st, push
+
+    int cycles(uint16_t word) const;
+};
+
+struct LoopReport {
+    int header;                 // address
+    int line;                   // 0 when unknown
+    uint64_t bound;
+    uint64_t iterationCycles;   // longest single pass through the body
+};
+
+struct RoutineReport {
+    std::string name;
+    int entry;
+    int words;                  // own words, callees excluded
+    bool bounded = false;
+    uint64_t cycles = 0;        // worst case including callees
+    std::string problem;        // why the routine is unbounded
+    std::vector<LoopReport> loops;
+};
+
+class WcetAnalysis {
+private:
+    const AssembleResult& result;
+    std::vector<uint16_t> words;    // result's image indexed by address
+    std::vector<bool> isData;
+    std::vector<LineEntry> rows;    // result's line table sorted by address
+    CycleTable table;
+    ControlFlowGraph cfg;
+    std::map<int, uint64_t> bounds;     // header address -> bound
+    std::vector<RoutineReport> reports;
+    std::vector<int> state;             // per routine: 0 new, 1 running, 2 done
+
+    std::string nameOf(int address) const;
+    int lineOf(int address) const;
+    uint64_t blockCycles(int block);
+    void analyzeRoutine(size_t index);
+
+public:
+    // result must come from a successful assembly with debugInfo set.
+    WcetAnalysis(const AssembleResult& result, const CycleTable& table = CycleTable());
+
+    // LABEL=N bounds from the command line. Throws for unknown labels.
+    void addLoopBound(const std::string& label, uint64_t bound);
+    // Reads "// @bound N" comments from the source text.
+    void addSourceBounds(const std::string& source);
+
+    // Throws std::runtime_error when the CFG cannot be built.
+    const std::vector<RoutineReport>& run();
+
+    const ControlFlowGraph& getGraph() const { return cfg; }
+};
+
+void writeWcetReport(std::ostream& out, const std::vector<RoutineReport>& reports);
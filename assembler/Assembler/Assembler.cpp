@@ -0,0 +1,523 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "Assembler.h"
+#include "InstructionEncoder/InstructionEncoder.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+void AssembleResult::clear() {
+    success = false;
+    depth = 256;
+    words.clear();
+    isData.clear();
+    segments.clear();
+    symbols.clear();
+    lineTable.clear();
+    diagnostics.clear();
+    elimination = EliminationReport();
+    peephole = PeepholeReport();
+}
+
+int scanMemoryDepth(const std::string& source, int defaultDepth) {
+    int depth = defaultDepth;
+    size_t pos = source.find("DEPTH");
+
+    while (pos != std::string::npos) {
+        size_t lineStart = source.rfind('\n', pos);
+        lineStart = (lineStart == std::string::npos) ? 0 : lineStart + 1;
+        size_t lineEnd = source.find('\n', pos);
+        if (lineEnd == std::string::npos) lineEnd = source.length();
+
+        const char* begin = source.data() + lineStart;
+        const char* end = source.data() + lineEnd;
+        const char* equals = static_cast<const char*>(std::memchr(begin, '=', end - begin));
+        if (equals) {
+            const char* p = equals + 1;
+            while (p < end && charscan::is(*p, charscan::SPACE)) p++;
+            const char* digits = p;
+            while (p < end && charscan::is(*p, charscan::DIGIT)) p++;
+
+            int64_t value = 0;
+            if (p != digits && parseNumericLiteral(digits, p, value) == NumberStatus::OK && value <= INT32_MAX) {
+                depth = static_cast<int>(value);
+            }
+        }
+        pos = source.find("DEPTH", lineEnd);
+    }
+    return depth;
+}
+
+void AssemblerContext::traceTokens(std::ostream& out) const {
+    out << "Tokens:\n";
+    for (const auto& token : tokens) {
+        out << "Line " << token.line << ", Col " << token.column
+            << ": Type=" << static_cast<int>(token.type)
+            << ", Value=\"" << token.value << "\"\n";
+    }
+}
+
+void AssemblerContext::traceStatements(std::ostream& out) const {
+    out << "Abstract Syntax Tree:\n";
+    for (const auto& stmt : ast) {
+        out << "Line " << stmt->line << ", Col " << stmt->column << ": ";
+        switch(stmt->type) {
+            case StatementType::LABEL: {
+                auto label = static_cast<Label*>(stmt.get());
+                out << "LABEL \"" << label->name << "\"\n";
+                break;
+            }
+            case StatementType::DIRECTIVE: {
+                auto directive = static_cast<Directive*>(stmt.get());
+                out << "DIRECTIVE " << directive->name;
+                if (!directive->label.empty())
+                    out << " " << directive->label;
+                if (!directive->value.empty())
+                    out << " " << directive->value;
+                out << "\n";
+                break;
+            }
+            case StatementType::INSTRUCTION: {
+                auto instr = static_cast<Instruction*>(stmt.get());
+                out << "INSTRUCTION " << instr->opcode;
+                if (!instr->operand1.empty())
+                    out << " " << instr->operand1;
+                if (!instr->operand2.empty())
+                    out << " " << instr->operand2;
+                out << "\n";
+                break;
+            }
+        }
+    }
+}
+
+void layoutStatements(const std::vector<Statement*>& statements, SymbolTable& symbolTable,
+                      std::vector<bool>& isData, std::vector<Segment>& segments, int depth,
+                      std::vector<int>* addresses, std::ostream* trace) {
+    int currentAddress = 0;
+    segments.clear();
+    std::vector<const Statement*> segmentStart;
+    std::vector<const Statement*> segmentOrg;   // last .org before the segment, if any
+    const Statement* lastOrg = nullptr;
+    if (addresses) {
+        addresses->clear();
+        addresses->reserve(statements.size());
+    }
+
+    // Continues the last segment when the words follow it directly and are
+    // of the same kind, otherwise opens a new one at currentAddress.
+    auto place = [&](const Statement* stmt, int count, bool data) {
+        if (count == 0) {
+            return;
+        }
+        if (segments.empty() || segments.back().isData != data || segments.back().end() != currentAddress) {
+            segments.push_back({currentAddress, 0, isData.size(), data});
+            segmentStart.push_back(stmt);
+            segmentOrg.push_back(lastOrg);
+        }
+        segments.back().length += count;
+        isData.insert(isData.end(), count, data);
+    };
+
+    for (Statement* stmt : statements) {
+        if (addresses) {
+            addresses->push_back(currentAddress);
+        }
+        try {
+            switch(stmt->type) {
+                case StatementType::LABEL: {
+                    auto label = static_cast<Label*>(stmt);
+                    if (trace) {
+                        *trace << "Adding label: " << label->name << " at address 0x"
+                               << std::hex << currentAddress << std::dec << "\n";
+                    }
+                    symbolTable.addLabel(label->name, currentAddress);
+                    break;
+                }
+                case StatementType::DIRECTIVE: {
+                    auto directive = static_cast<Directive*>(stmt);
+                    if(directive->name == ".define") {
+                        int64_t value = directive->number;
+
+                        if (trace) {
+                            *trace << "Adding define: " << directive->label << " = 0x"
+                                   << std::hex << value << std::dec << "\n";
+                        }
+                        symbolTable.addDefine(directive->label, value);
+                    } else if(directive->name == ".word") {
+                        if (trace) {
+                            *trace << "Word directive at address 0x"
+                                   << std::hex << currentAddress << std::dec << "\n";
+                        }
+                        const int count = Encoder::wordCount(stmt);
+                        place(stmt, count, true);
+                        currentAddress += count;
+                    } else {
+                        const int64_t amount = directive->name == ".space" || directive->name == ".org"
+                                                   ? directive->number : directive->count;
+                        const int64_t end = directive->name == ".org" ? amount : currentAddress + amount;
+                        if (amount < 0 || end > (directive->name == ".org" ? ADDRESS_SPACE_WORDS - 1
+                                                                           : ADDRESS_SPACE_WORDS)) {
+                            throw std::runtime_error(directive->name + " " + std::to_string(amount) +
+                                                     " leaves the 64K-word address space");
+                        }
+                        if (trace) {
+                            *trace << directive->name << " at address 0x" << std::hex << currentAddress
+                                   << " -> 0x" << end << std::dec << "\n";
+                        }
+                        place(stmt, Encoder::wordCount(stmt), true);
+                        currentAddress = static_cast<int>(end);
+                        if (directive->name == ".org") {
+                            lastOrg = stmt;
+                        }
+                    }
+                    break;
+                }
+                case StatementType::INSTRUCTION: {
+                    int numWords = Encoder::wordCount(stmt);
+
+                    if (trace) {
+                        *trace << "Instruction at address 0x"
+                               << std::hex << currentAddress << std::dec
+                               << " (size=" << numWords << ")\n";
+                    }
+
+                    place(stmt, numWords, false);
+                    currentAddress += numWords;
+                    break;
+                }
+            }
+        } catch (AssemblyError& e) {
+            e.file = stmt->file;
+            throw;
+        } catch (const std::exception& e) {
+            throw AssemblyError(e.what(), stmt->line, stmt->column, stmt->file);
+        }
+    }
+
+    // Writers and lookups walk the image in address order; .org may have
+    // placed later statements below earlier ones, but never on top of them.
+    std::vector<size_t> order(segments.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return segments[a].base < segments[b].base; });
+    for (size_t i = 1; i < order.size(); i++) {
+        const Segment& lower = segments[order[i - 1]];
+        const Segment& upper = segments[order[i]];
+        if (upper.base < lower.end()) {
+            const Statement* stmt = segmentStart[std::max(order[i - 1], order[i])];
+            std::ostringstream message;
+            message << "Code or data at 0x" << std::hex << std::max(lower.base, upper.base)
+                    << " overlaps words placed there earlier";
+            throw AssemblyError(message.str(), stmt->line, stmt->column, stmt->file);
+        }
+    }
+
+    // The MIF holds depth words; blame the .org that moved code past them.
+    for (size_t i : order) {
+        const Segment& segment = segments[i];
+        if (segment.end() > depth) {
+            const Statement* stmt = segmentOrg[i] ? segmentOrg[i] : segmentStart[i];
+            std::ostringstream message;
+            message << "Code or data at 0x" << std::hex << std::max(segment.base, depth) << std::dec
+                    << " is past the end of memory (DEPTH = " << depth << ")";
+            throw AssemblyError(message.str(), stmt->line, stmt->column, stmt->file);
+        }
+    }
+
+    std::vector<Segment> sorted;
+    sorted.reserve(segments.size());
+    for (size_t i : order) sorted.push_back(segments[i]);
+    segments.swap(sorted);
+}
+
+void collectSymbolInfo(const SymbolTable& symbolTable, std::vector<SymbolInfo>& symbols) {
+    symbols.clear();
+    for (const auto& label : symbolTable.getLabels()) {
+        symbols.push_back({label.first, label.second, true});
+    }
+    for (const auto& define : symbolTable.getDefines()) {
+        symbols.push_back({define.first, define.second, false});
+    }
+    std::sort(symbols.begin(), symbols.end(),
+              [](const SymbolInfo& a, const SymbolInfo& b) {
+                  return a.value != b.value ? a.value < b.value : a.name < b.name;
+              });
+}
+
+void AssemblerContext::layoutAndEncode(const AssembleOptions& options) {
+    std::ostream* trace = options.trace;
+    if (trace) {
+        *trace << "\n=== First Pass: Symbol Collection ===\n";
+    }
+    statementView.clear();
+    for (const auto& stmt : ast) {
+        statementView.push_back(stmt.get());
+    }
+    symbolTable.clear();
+    result.isData.clear();
+    layoutStatements(statementView, symbolTable, result.isData, result.segments, result.depth, &addresses,
+                     trace);
+
+    Encoder encoder(symbolTable);
+    encoder.setLineTable(options.debugInfo ? &result.lineTable : nullptr);
+    std::vector<uint16_t> machineCode = options.jobs > 1 ? encoder.encodeParallel(ast, options.jobs)
+                                                         : encoder.encode(ast);
+    result.words.swap(machineCode);
+}
+
+void AssemblerContext::addPredefined(const AssembleOptions& options, SymbolTable& predefined) {
+    for (const auto& define : options.defines) {
+        predefined.addDefine(define.first, define.second);
+        auto directive = std::make_unique<Directive>(".define", define.first, std::to_string(define.second), 0, 0);
+        directive->number = define.second;
+        directive->hasNumber = true;
+        ast.push_back(std::move(directive));
+    }
+}
+
+void AssemblerContext::runBackEnd(const AssembleOptions& options) {
+    std::ostream* trace = options.trace;
+    if (options.optimize) {
+        result.peephole = optimizeStatements(ast);
+    }
+    layoutAndEncode(options);
+
+    if (options.eliminateDeadCode) {
+        std::vector<uint16_t> denseWords;
+        std::vector<bool> denseIsData;
+        expandSegments(result.words, result.isData, result.segments, denseWords, denseIsData);
+        result.elimination = eliminateDeadCode(ast, addresses, denseWords, denseIsData);
+        if (!result.elimination.removed.empty()) {
+            if (trace) {
+                *trace << "\n=== Dead Code Elimination: " << result.elimination.wordsSaved
+                       << " words removed ===\n";
+            }
+            if (options.optimize) {
+                // Removed code can leave branches to the next word behind.
+                PeepholeReport again = optimizeStatements(ast);
+                for (size_t i = 0; i < again.rules.size(); i++) {
+                    result.peephole.rules[i].applied += again.rules[i].applied;
+                }
+                result.peephole.wordsSaved += again.wordsSaved;
+            }
+            layoutAndEncode(options);
+        }
+    }
+
+    if (trace) {
+        *trace << "\n=== Final Machine Code ===\n";
+        for (const auto& segment : result.segments) {
+            for (int i = 0; i < segment.length; i++) {
+                *trace << " " << std::hex << std::setw(3) << std::setfill('0') << segment.base + i
+                       << ":  " << std::setw(4) << std::setfill('0')
+                       << result.words[segment.offset + i] << std::dec << "\n";
+            }
+        }
+    }
+
+    collectSymbolInfo(symbolTable, result.symbols);
+    result.success = true;
+}
+
+void AssemblerContext::dropFailedImage() {
+    if (!result.success) {
+        result.words.clear();
+        result.isData.clear();
+        result.segments.clear();
+        result.symbols.clear();
+        result.lineTable.clear();
+    }
+}
+
+std::vector<std::string> AssemblerContext::getIncludedFiles() const {
+    std::vector<std::string> paths;
+    paths.reserve(includedFiles.size());
+    for (const auto& file : includedFiles) {
+        paths.push_back(file.first);
+    }
+    return paths;
+}
+
+const AssembleResult& AssemblerContext::assemble(const std::string& source,
+                                                 const AssembleOptions& options) {
+    std::ostream* trace = options.trace;
+    result.clear();
+    ast.clear();
+    symbolTable.clear();
+    includedFiles.clear();
+
+    try {
+        result.depth = scanMemoryDepth(source, options.defaultDepth);
+
+        if (trace) {
+            *trace << "\n=== Lexical Analysis ===\n";
+        }
+        SymbolTable predefined;
+        addPredefined(options, predefined);
+        Lexer::tokenizeParallel(source, options.jobs, tokens, &predefined);
+        MacroExpander::expand(tokens);
+        if (trace) {
+            traceTokens(*trace);
+        }
+
+        if (trace) {
+            *trace << "\n=== Parsing ===\n";
+        }
+        Parser parser(tokens);
+        parser.parse(ast);
+        if (trace) {
+            traceStatements(*trace);
+        }
+        resolveBinaryIncludes(ast, options.includeDirectory, options.incbinBigEndian, includedFiles);
+
+        runBackEnd(options);
+    } catch (const AssemblyError& e) {
+        result.diagnostics.push_back({e.line, e.column, e.what(), ""});
+    } catch (const std::exception& e) {
+        result.diagnostics.push_back({0, 0, e.what(), ""});
+    }
+
+    dropFailedImage();
+    return result;
+}
+
+const AssembleResult& AssemblerContext::assembleFiles(const std::vector<SourceFile>& files,
+                                                      const AssembleOptions& options) {
+    std::ostream* trace = options.trace;
+    result.clear();
+    ast.clear();
+    symbolTable.clear();
+    includedFiles.clear();
+    tokens.clear();
+
+    struct Definition {
+        const std::string* name;
+        bool isLabel;
+        int line;
+        int column;
+    };
+    struct FrontEnd {
+        std::vector<std::unique_ptr<Statement>> statements;
+        std::vector<Definition> definitions;
+        std::exception_ptr error;
+    };
+    std::vector<FrontEnd> units(files.size());
+
+    try {
+        // Like a single source: the last DEPTH line wins.
+        int depth = options.defaultDepth;
+        for (const SourceFile& file : files) {
+            depth = scanMemoryDepth(file.text, depth);
+        }
+        result.depth = depth;
+        SymbolTable predefined;
+        addPredefined(options, predefined);
+
+        // Front end: files are handed out to up to `jobs` workers; a file
+        // gets several lexer threads only when there are fewer files.
+        const unsigned workers = static_cast<unsigned>(
+            std::max<size_t>(1, std::min<size_t>(options.jobs, files.size())));
+        const unsigned lexerThreads = std::max(1u, options.jobs / workers);
+        std::atomic<size_t> next(0);
+        auto work = [&]() {
+            std::vector<Token> fileTokens;
+            for (size_t i; (i = next++) < files.size();) {
+                FrontEnd& unit = units[i];
+                try {
+                    Lexer::tokenizeParallel(files[i].text, lexerThreads, fileTokens, &predefined);
+                    MacroExpander::expand(fileTokens);
+                    Parser parser(fileTokens);
+                    parser.parse(unit.statements);
+                    for (const auto& stmt : unit.statements) {
+                        stmt->file = static_cast<int>(i);
+                        if (stmt->type == StatementType::LABEL) {
+                            unit.definitions.push_back({&static_cast<Label*>(stmt.get())->name, true,
+                                                        stmt->line, stmt->column});
+                        } else if (stmt->type == StatementType::DIRECTIVE &&
+                                   static_cast<Directive*>(stmt.get())->name == ".define") {
+                            unit.definitions.push_back({&static_cast<Directive*>(stmt.get())->label, false,
+                                                        stmt->line, stmt->column});
+                        }
+                    }
+                } catch (...) {
+                    unit.error = std::current_exception();
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < workers; t++) {
+            threads.emplace_back(work);
+        }
+        work();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        // Merge in command-line order: the first error wins, and every
+        // name may be defined once across all files and -D.
+        std::unordered_map<std::string, std::pair<int, int>> labels, defines;
+        for (const auto& define : options.defines) {
+            defines.emplace(define.first, std::make_pair(-1, 0));
+        }
+        for (size_t i = 0; i < files.size(); i++) {
+            FrontEnd& unit = units[i];
+            if (unit.error) {
+                try {
+                    std::rethrow_exception(unit.error);
+                } catch (AssemblyError& e) {
+                    e.file = static_cast<int>(i);
+                    throw;
+                } catch (const std::exception& e) {
+                    throw AssemblyError(e.what(), 0, 0, static_cast<int>(i));
+                }
+            }
+            for (const Definition& definition : unit.definitions) {
+                auto& names = definition.isLabel ? labels : defines;
+                auto inserted = names.emplace(*definition.name, std::make_pair(static_cast<int>(i), definition.line));
+                if (!inserted.second) {
+                    const std::pair<int, int>& first = inserted.first->second;
+                    throw AssemblyError(std::string(definition.isLabel ? "Duplicate label '" : "Duplicate define '") +
+                                        *definition.name + "' at line " + std::to_string(definition.line) +
+                                        ", first defined at " +
+                                        (first.first < 0 ? std::string("-D") :
+                                         files[first.first].name + ":" + std::to_string(first.second)),
+                                        definition.line, definition.column, static_cast<int>(i));
+                }
+            }
+
+            const size_t slash = files[i].name.find_last_of("/\\");
+            const std::string directory = slash == std::string::npos ? options.includeDirectory
+                                                                    : files[i].name.substr(0, std::max<size_t>(slash, 1));
+            resolveBinaryIncludes(unit.statements, directory, options.incbinBigEndian, includedFiles);
+            std::move(unit.statements.begin(), unit.statements.end(), std::back_inserter(ast));
+        }
+        if (trace) {
+            *trace << "\n=== Parsed " << files.size() << " files ===\n";
+            traceStatements(*trace);
+        }
+
+        runBackEnd(options);
+    } catch (const AssemblyError& e) {
+        const bool known = e.file >= 0 && static_cast<size_t>(e.file) < files.size();
+        result.diagnostics.push_back({e.line, e.column, e.what(), known ? files[e.file].name : ""});
+    } catch (const std::exception& e) {
+        result.diagnostics.push_back({0, 0, e.what(), ""});
+    }
+
+    dropFailedImage();
+    return result;
+}
+
+AssembleResult assemble(const std::string& source, const AssembleOptions& options) {
+    AssemblerContext context;
+    return context.assemble(source, options);
+}
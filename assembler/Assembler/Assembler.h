@@ -0,0 +1,140 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: In-memory assembler facade. Runs the whole pipeline (DEPTH
+//              scan, lexer, macro expansion, parser, symbol pass, encoder)
+//              on a source buffer and returns the image, symbols and
+//              diagnostics without touching the filesystem. main.cpp and the C ABI in sbasm.h
+//              are thin wrappers around it.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "common.h"
+#include "Lexer/Lexer.h"
+#include "Parser/Parser.h"
+#include "Parser/MacroExpander.h"
+#include "InstructionEncoder/InstructionEncoder.h"
+#include "InstructionEncoder/SymbolTable.h"
+#include "Optimizer/DeadCode.h"
+#include "Optimizer/Peephole.h"
+#include "BinaryInclude.h"
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct AssembleOptions {
+    // Memory depth used when the source has no DEPTH line.
+    int defaultDepth = 256;
+    // Threads for lexing and encoding, see Lexer/Encoder::...Parallel.
+    unsigned jobs = 1;
+    // When set, every stage dumps its intermediate results here (-v).
+    std::ostream* trace = nullptr;
+    // Fill AssembleResult::lineTable for the debug-info sidecar (-g).
+    bool debugInfo = false;
+    // Drop code unreachable from address 0 and unused .word tables (--strip-unused).
+    bool eliminateDeadCode = false;
+    // Peephole rewrites of the statement list before encoding (-O).
+    bool optimize = false;
+    // Relative .incbin paths start here (main uses the source's directory).
+    std::string includeDirectory;
+    // Byte order of .incbin payloads; little-endian unless set.
+    bool incbinBigEndian = false;
+    // Defined before the first line (-D NAME=value): seen by .if/.ifdef
+    // and usable in the code like a .define.
+    std::vector<std::pair<std::string, int>> defines;
+};
+
+struct SourceFile {
+    std::string name;   // used in diagnostics; .incbin paths start in its directory
+    std::string text;
+};
+
+struct Diagnostic {
+    int line;       // 0 when the error has no source position
+    int column;
+    std::string message;
+    std::string file;   // source name from assembleFiles(), otherwise empty
+};
+
+struct SymbolInfo {
+    std::string name;
+    int value;
+    bool isLabel;   // label address, otherwise a .define constant
+};
+
+struct AssembleResult {
+    bool success = false;
+    int depth = 256;
+    std::vector<uint16_t> words;           // packed in statement order
+    std::vector<bool> isData;              // parallel to words
+    std::vector<Segment> segments;         // where words live, sorted by base
+    std::vector<SymbolInfo> symbols;       // sorted by value, then name
+    std::vector<LineEntry> lineTable;      // only with AssembleOptions::debugInfo
+    std::vector<Diagnostic> diagnostics;
+    EliminationReport elimination;         // only with eliminateDeadCode
+    PeepholeReport peephole;               // only with optimize
+
+    void clear();
+};
+
+// Reusable pipeline state. Token, statement and result buffers keep their
+// capacity between assemble() calls, so tools that assemble many programs
+// should keep one context per thread.
+class AssemblerContext {
+private:
+    std::vector<Token> tokens;
+    std::vector<std::unique_ptr<Statement>> ast;
+    std::vector<Statement*> statementView;
+    std::vector<int> addresses;
+    SymbolTable symbolTable;
+    AssembleResult result;
+    std::map<std::string, std::unique_ptr<MappedFile>> includedFiles;
+
+    void addPredefined(const AssembleOptions& options, SymbolTable& predefined);
+    void layoutAndEncode(const AssembleOptions& options);
+    void runBackEnd(const AssembleOptions& options);
+    void dropFailedImage();
+    void traceTokens(std::ostream& out) const;
+    void traceStatements(std::ostream& out) const;
+
+public:
+    // The returned reference stays valid until the next assemble() call.
+    const AssembleResult& assemble(const std::string& source,
+                                   const AssembleOptions& options = AssembleOptions());
+    // Assembles several sources into one image. Files are lexed and parsed
+    // on up to options.jobs threads, then laid out back to back in the
+    // given order; labels and defines are global across files. Diagnostics
+    // carry the name of the file. lineTable lines are per file.
+    const AssembleResult& assembleFiles(const std::vector<SourceFile>& files,
+                                        const AssembleOptions& options = AssembleOptions());
+
+    const AssembleResult& getResult() const { return result; }
+    const std::vector<Token>& getTokens() const { return tokens; }
+    const std::vector<std::unique_ptr<Statement>>& getStatements() const { return ast; }
+    const SymbolTable& getSymbolTable() const { return symbolTable; }
+    // Paths of the files mapped by .incbin during the last call, as opened.
+    std::vector<std::string> getIncludedFiles() const;
+};
+
+// First pass: assigns addresses in statement order, adds labels and
+// defines to symbolTable, appends one isData flag per emitted word and
+// replaces segments with the placement of those words, sorted by base.
+// Throws when .org/.space/.fill leave the address space, words overlap or
+// words land at or above depth (at the .org that placed them, if any).
+// When addresses is given it receives the start address of every statement.
+void layoutStatements(const std::vector<Statement*>& statements, SymbolTable& symbolTable,
+                      std::vector<bool>& isData, std::vector<Segment>& segments, int depth,
+                      std::vector<int>* addresses, std::ostream* trace);
+
+// Fills symbols from symbolTable, sorted by value, then name.
+void collectSymbolInfo(const SymbolTable& symbolTable, std::vector<SymbolInfo>& symbols);
+
+// Returns the value of the last line that mentions DEPTH and has a number
+// after its '=' (usually a "// DEPTH = n" comment), or defaultDepth.
+int scanMemoryDepth(const std::string& source, int defaultDepth);
+
+// One-shot convenience wrapper around AssemblerContext.
+AssembleResult assemble(const std::string& source,
+                        const AssembleOptions& options = AssembleOptions());
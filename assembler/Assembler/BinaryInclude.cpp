@@ -0,0 +1,118 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "BinaryInclude.h"
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+MappedFile::MappedFile(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Could not open included file '" + path + "'");
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Could not read included file '" + path + "'");
+    }
+    length = static_cast<size_t>(size.QuadPart);
+    if (length > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            bytes = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (!bytes) {
+            if (mapping) CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("Could not map included file '" + path + "'");
+        }
+    }
+    CloseHandle(file);
+}
+
+MappedFile::~MappedFile() {
+    if (bytes) UnmapViewOfFile(bytes);
+    if (mapping) CloseHandle(mapping);
+}
+#else
+MappedFile::MappedFile(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open included file '" + path + "'");
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Could not read included file '" + path + "'");
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Could not map included file '" + path + "'");
+        }
+        bytes = static_cast<const uint8_t*>(view);
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (bytes) munmap(const_cast<uint8_t*>(bytes), length);
+}
+#endif
+
+static bool isAbsolute(const std::string& path) {
+    if (!path.empty() && (path[0] == '/' || path[0] == '\\')) return true;
+    return path.size() > 1 && path[1] == ':';
+}
+
+void resolveBinaryIncludes(std::vector<std::unique_ptr<Statement>>& ast, const std::string& directory,
+                           bool bigEndian, std::map<std::string, std::unique_ptr<MappedFile>>& files) {
+    for (auto& stmt : ast) {
+        if (stmt->type != StatementType::DIRECTIVE) continue;
+        auto dir = static_cast<Directive*>(stmt.get());
+        if (dir->name != ".incbin") continue;
+
+        try {
+            std::string path = dir->value;
+            if (!directory.empty() && !isAbsolute(path)) {
+                path = directory + "/" + path;
+            }
+            auto file = files.find(path);
+            if (file == files.end()) {
+                file = files.emplace(path, std::unique_ptr<MappedFile>(new MappedFile(path))).first;
+            }
+
+            const int64_t size = static_cast<int64_t>(file->second->size());
+            const int64_t offset = dir->byteOffset;
+            const int64_t length = dir->byteLength < 0 ? size - offset : dir->byteLength;
+            if (offset < 0 || offset > size || length < 0 || length > size - offset) {
+                throw std::runtime_error("Range " + std::to_string(offset) + "+" + std::to_string(length) +
+                                         " is outside '" + dir->value + "' (" + std::to_string(size) +
+                                         " bytes)");
+            }
+            if (length % 2 != 0) {
+                throw std::runtime_error("'" + dir->value + "' slice has an odd number of bytes (" +
+                                         std::to_string(length) + "), words are 16 bits");
+            }
+            dir->payload = file->second->data() ? file->second->data() + offset : nullptr;
+            dir->count = length / 2;
+            dir->bigEndian = bigEndian;
+        } catch (const std::exception& e) {
+            throw AssemblyError(e.what(), dir->line, dir->column, dir->file);
+        }
+    }
+}
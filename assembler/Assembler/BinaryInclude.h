@@ -0,0 +1,45 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: .incbin support. Included files are memory-mapped read-only
+//              and each .incbin directive is pointed at its slice of the
+//              mapping, so the encoder copies the payload into the image
+//              without any per-word lexing or parsing.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "Parser/Parser.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file. Empty files have data() == nullptr.
+class MappedFile {
+private:
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+#if defined(_WIN32)
+    void* mapping = nullptr;
+#endif
+
+public:
+    // Throws std::runtime_error when path cannot be opened or mapped.
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+// Maps the file of every .incbin in ast (once per path; relative paths are
+// taken from directory when it is not empty) and stores the payload pointer,
+// byte order and word count in the directive. Mappings are added to files
+// and must outlive the encoding. Throws AssemblyError for missing files,
+// ranges outside the file and odd byte counts.
+void resolveBinaryIncludes(std::vector<std::unique_ptr<Statement>>& ast, const std::string& directory,
+                           bool bigEndian, std::map<std::string, std::unique_ptr<MappedFile>>& files);
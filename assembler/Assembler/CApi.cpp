@@ -0,0 +1,123 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "sbasm.h"
+#include "Assembler.h"
+
+struct sbasm_context {
+    AssemblerContext assembler;
+    std::string source;
+    std::vector<uint8_t> dataFlags;
+};
+
+uint32_t sbasm_abi_version(void) {
+    return SBASM_ABI_VERSION;
+}
+
+void sbasm_options_init(sbasm_options* options) {
+    if (!options) return;
+    AssembleOptions defaults;
+    options->default_depth = defaults.defaultDepth;
+    options->jobs = defaults.jobs;
+}
+
+sbasm_context* sbasm_context_create(void) {
+    try {
+        return new sbasm_context();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void sbasm_context_destroy(sbasm_context* context) {
+    delete context;
+}
+
+int sbasm_assemble(sbasm_context* context, const char* source, size_t length,
+                   const sbasm_options* options) {
+    if (!context || (!source && length > 0)) {
+        return -1;
+    }
+
+    try {
+        AssembleOptions assembleOptions;
+        if (options) {
+            assembleOptions.defaultDepth = options->default_depth;
+            assembleOptions.jobs = options->jobs;
+        }
+
+        context->source.assign(source ? source : "", length);
+        const AssembleResult& result = context->assembler.assemble(context->source, assembleOptions);
+        context->dataFlags.assign(result.isData.begin(), result.isData.end());
+        return result.success ? 1 : 0;
+    } catch (...) {
+        // Only allocation failures get here, the facade reports everything
+        // else as diagnostics. Never let an exception cross the C boundary.
+        return -1;
+    }
+}
+
+int32_t sbasm_depth(const sbasm_context* context) {
+    return context ? context->assembler.getResult().depth : 0;
+}
+
+size_t sbasm_word_count(const sbasm_context* context) {
+    return context ? context->assembler.getResult().words.size() : 0;
+}
+
+const uint16_t* sbasm_words(const sbasm_context* context) {
+    return context ? context->assembler.getResult().words.data() : nullptr;
+}
+
+const uint8_t* sbasm_data_flags(const sbasm_context* context) {
+    return context ? context->dataFlags.data() : nullptr;
+}
+
+size_t sbasm_segment_count(const sbasm_context* context) {
+    return context ? context->assembler.getResult().segments.size() : 0;
+}
+
+int sbasm_get_segment(const sbasm_context* context, size_t index, sbasm_segment* segment) {
+    if (!context || !segment || index >= context->assembler.getResult().segments.size()) {
+        return 0;
+    }
+    const Segment& info = context->assembler.getResult().segments[index];
+    segment->base = info.base;
+    segment->length = info.length;
+    segment->offset = info.offset;
+    segment->is_data = info.isData ? 1 : 0;
+    return 1;
+}
+
+size_t sbasm_symbol_count(const sbasm_context* context) {
+    return context ? context->assembler.getResult().symbols.size() : 0;
+}
+
+int sbasm_get_symbol(const sbasm_context* context, size_t index, sbasm_symbol* symbol) {
+    if (!context || !symbol || index >= context->assembler.getResult().symbols.size()) {
+        return 0;
+    }
+    const SymbolInfo& info = context->assembler.getResult().symbols[index];
+    symbol->name = info.name.c_str();
+    symbol->value = info.value;
+    symbol->is_label = info.isLabel ? 1 : 0;
+    return 1;
+}
+
+size_t sbasm_diagnostic_count(const sbasm_context* context) {
+    return context ? context->assembler.getResult().diagnostics.size() : 0;
+}
+
+int sbasm_get_diagnostic(const sbasm_context* context, size_t index,
+                         sbasm_diagnostic* diagnostic) {
+    if (!context || !diagnostic || index >= context->assembler.getResult().diagnostics.size()) {
+        return 0;
+    }
+    const Diagnostic& info = context->assembler.getResult().diagnostics[index];
+    diagnostic->line = info.line;
+    diagnostic->column = info.column;
+    diagnostic->message = info.message.c_str();
+    return 1;
+}
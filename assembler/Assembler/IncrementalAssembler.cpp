@@ -0,0 +1,262 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "IncrementalAssembler.h"
+#include "InstructionEncoder/InstructionEncoder.h"
+#include <algorithm>
+#include <iterator>
+
+void IncrementalAssembler::findLineStarts(const std::string& source, std::vector<size_t>& starts) {
+    starts.clear();
+    starts.push_back(0);
+    for (size_t at = source.find('\n'); at != std::string::npos; at = source.find('\n', at + 1)) {
+        starts.push_back(at + 1);
+    }
+    // Sentinel, so that line i always ends one byte before starts[i + 1].
+    starts.push_back(source.length() + 1);
+}
+
+void IncrementalAssembler::parseLine(SourceLine& line) {
+    Lexer lexer(line.text, line.number);
+    line.tokens = lexer.tokenize();
+    line.statements.clear();
+    Parser parser(line.tokens);
+    parser.parse(line.statements);
+    line.encodings.assign(line.statements.size(), CachedEncoding());
+}
+
+void IncrementalAssembler::renumber(SourceLine& line, int number) {
+    if (line.number == number) {
+        return;
+    }
+    for (auto& token : line.tokens) {
+        token.line = number;
+    }
+    for (auto& stmt : line.statements) {
+        stmt->line = number;
+    }
+    line.number = number;
+}
+
+// Encoding inputs other than the statement itself: the label address or
+// define value its operand names. Branches also depend on their own address.
+bool IncrementalAssembler::dependencyOf(const Statement* stmt, Dependency& dependency) const {
+    if (stmt->type != StatementType::INSTRUCTION) {
+        return false;
+    }
+    auto instr = static_cast<const Instruction*>(stmt);
+    const std::string* name = nullptr;
+    if (instr->opcode[0] == 'b') {
+        name = &instr->operand1;
+    } else if (instr->isImmediate && !instr->hasNumber) {
+        name = &instr->operand2;
+    }
+    if (!name) {
+        return false;
+    }
+
+    // Both namespaces, so that redefining either one is noticed.
+    dependency = Dependency();
+    if (symbolTable.hasLabel(*name)) {
+        dependency.hasLabel = true;
+        dependency.labelAddress = symbolTable.getLabelAddress(*name);
+    }
+    if (symbolTable.hasDefine(*name)) {
+        dependency.hasDefine = true;
+        dependency.defineValue = symbolTable.getDefineValue(*name);
+    }
+    return true;
+}
+
+const AssembleResult& IncrementalAssembler::rebuildFromScratch(const std::string& source,
+                                                               const AssembleOptions& options,
+                                                               bool keepLines) {
+    // A line that does not parse on its own is either a genuine error or
+    // a statement split over lines, which only the whole-file pipeline
+    // handles: let it produce the result and diagnostics. The other lines
+    // stay cached, so typing on a broken line does not re-lex the file.
+    if (!keepLines) {
+        lines.clear();
+        symbolIndex.clear();
+    }
+    encodedPrefix = 0;
+    stats.fullRebuild = true;
+    result = fallback.assemble(source, options);
+    return result;
+}
+
+int IncrementalAssembler::lineNumber(uint32_t lineId) const {
+    for (const SourceLine& line : lines) {
+        if (line.id == lineId) return line.number;
+    }
+    return 0;
+}
+
+const std::string* IncrementalAssembler::lineText(int line) const {
+    if (line < 1 || static_cast<size_t>(line) > lines.size()) return nullptr;
+    return &lines[line - 1].text;
+}
+
+const std::vector<Token>* IncrementalAssembler::lineTokens(int line) const {
+    if (line < 1 || static_cast<size_t>(line) > lines.size()) return nullptr;
+    return &lines[line - 1].tokens;
+}
+
+bool IncrementalAssembler::lineEncoding(int line, int& address, std::vector<uint16_t>& words) const {
+    words.clear();
+    // statementView is in line order.
+    auto first = std::lower_bound(statementView.begin(), statementView.begin() + encodedPrefix, line,
+                                  [](const Statement* stmt, int value) { return stmt->line < value; });
+    for (auto it = first; it != statementView.begin() + encodedPrefix && (*it)->line == line; ++it) {
+        const CachedEncoding& cache = *encodingView[it - statementView.begin()];
+        if (!cache.valid || cache.words.empty()) continue;
+        if (words.empty()) address = addresses[it - statementView.begin()];
+        words.insert(words.end(), cache.words.begin(), cache.words.end());
+    }
+    return !words.empty();
+}
+
+const AssembleResult& IncrementalAssembler::update(const std::string& source,
+                                                   const AssembleOptions& options) {
+    stats = UpdateStats();
+    result.clear();
+
+    // Removing statements shifts addresses program-wide, included files
+    // can change without the source changing, and macro bodies and .if
+    // blocks span lines; no line cache.
+    if (options.eliminateDeadCode || options.optimize || !options.defines.empty() ||
+        source.find(".incbin") != std::string::npos || source.find(".macro") != std::string::npos ||
+        source.find(".rept") != std::string::npos || source.find(".if") != std::string::npos) {
+        return rebuildFromScratch(source, options, false);
+    }
+
+    // Compare against the cached lines in place; only edited lines are copied.
+    findLineStarts(source, lineStarts);
+    auto sameText = [&](const SourceLine& line, size_t index) {
+        const size_t begin = lineStarts[index];
+        const size_t length = lineStarts[index + 1] - 1 - begin;
+        return line.text.length() == length && source.compare(begin, length, line.text) == 0;
+    };
+
+    const size_t oldCount = lines.size();
+    const size_t newCount = lineStarts.size() - 1;
+    size_t prefix = 0;
+    while (prefix < oldCount && prefix < newCount && sameText(lines[prefix], prefix)) {
+        prefix++;
+    }
+    size_t suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix &&
+           sameText(lines[oldCount - 1 - suffix], newCount - 1 - suffix)) {
+        suffix++;
+    }
+    const size_t removed = oldCount - prefix - suffix;
+    const size_t added = newCount - prefix - suffix;
+
+    if (indexSymbols) {
+        for (size_t i = prefix; i < prefix + removed; i++) {
+            symbolIndex.removeLine(lines[i].id, lines[i].text, lines[i].tokens);
+        }
+    }
+
+    std::vector<SourceLine> fresh(added);
+    for (size_t k = 0; k < added; k++) {
+        SourceLine& line = fresh[k];
+        const size_t index = prefix + k;
+        line.text.assign(source, lineStarts[index], lineStarts[index + 1] - 1 - lineStarts[index]);
+        line.number = static_cast<int>(index + 1);
+        line.id = nextLineId++;
+        try {
+            parseLine(line);
+            line.parsed = true;
+        } catch (const std::exception&) {
+            line.tokens.clear();
+            line.statements.clear();
+            line.encodings.clear();
+        }
+        if (indexSymbols) {
+            symbolIndex.addLine(line.id, line.text, line.tokens);
+        }
+        stats.linesRelexed++;
+    }
+    if (removed == added) {
+        std::move(fresh.begin(), fresh.end(), lines.begin() + prefix);
+    } else {
+        lines.erase(lines.begin() + prefix, lines.begin() + prefix + removed);
+        lines.insert(lines.begin() + prefix, std::make_move_iterator(fresh.begin()),
+                     std::make_move_iterator(fresh.end()));
+        for (size_t i = prefix + added; i < newCount; i++) {
+            renumber(lines[i], static_cast<int>(i + 1));
+        }
+    }
+
+    for (const SourceLine& line : lines) {
+        if (!line.parsed) {
+            return rebuildFromScratch(source, options, true);
+        }
+    }
+
+    statementView.clear();
+    encodingView.clear();
+    for (auto& line : lines) {
+        for (size_t i = 0; i < line.statements.size(); i++) {
+            statementView.push_back(line.statements[i].get());
+            encodingView.push_back(&line.encodings[i]);
+        }
+    }
+
+    encodedPrefix = 0;
+    try {
+        result.depth = scanMemoryDepth(source, options.defaultDepth);
+        symbolTable.clear();
+        layoutStatements(statementView, symbolTable, result.isData, result.segments, result.depth, &addresses,
+                         nullptr);
+
+        Encoder encoder(symbolTable);
+        for (size_t i = 0; i < statementView.size(); i++, encodedPrefix = i) {
+            Statement* stmt = statementView[i];
+            CachedEncoding& cache = *encodingView[i];
+            if (stmt->type == StatementType::LABEL) {
+                continue;   // handled entirely by the layout pass
+            }
+
+            Dependency dependency;
+            const bool hasDependency = dependencyOf(stmt, dependency);
+            const bool addressDependent = stmt->type == StatementType::INSTRUCTION &&
+                                          static_cast<Instruction*>(stmt)->opcode[0] == 'b';
+
+            if (!cache.valid || cache.hasDependency != hasDependency ||
+                (hasDependency && cache.dependency != dependency) ||
+                (addressDependent && cache.address != addresses[i])) {
+                cache.valid = false;
+                encoder.encodeAt(stmt, addresses[i], cache.words);
+                cache.valid = true;
+                cache.address = addresses[i];
+                cache.hasDependency = hasDependency;
+                cache.dependency = dependency;
+                stats.statementsEncoded++;
+            }
+            if (options.debugInfo && !cache.words.empty()) {
+                result.lineTable.push_back({addresses[i], stmt->line, stmt->column});
+            }
+            result.words.insert(result.words.end(), cache.words.begin(), cache.words.end());
+        }
+
+        collectSymbolInfo(symbolTable, result.symbols);
+        result.success = true;
+    } catch (const AssemblyError& e) {
+        result.diagnostics.push_back({e.line, e.column, e.what(), ""});
+    } catch (const std::exception& e) {
+        result.diagnostics.push_back({0, 0, e.what(), ""});
+    }
+
+    if (!result.success) {
+        result.words.clear();
+        result.isData.clear();
+        result.segments.clear();
+        result.symbols.clear();
+        result.lineTable.clear();
+    }
+    return result;
+}
@@ -0,0 +1,112 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Keeps tokens, statements and per-statement encodings of one
+//              source in memory so that after an edit only the changed
+//              lines are re-lexed and re-parsed, and only statements whose
+//              encoding can have changed are re-encoded. Used by --watch
+//              and, with a SymbolIndex of the cached lines, by --lsp.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "Assembler.h"
+#include "SymbolIndex.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class IncrementalAssembler {
+public:
+    struct UpdateStats {
+        size_t linesRelexed = 0;
+        size_t statementsEncoded = 0;
+        bool fullRebuild = false;
+    };
+
+private:
+    // What the symbol an operand names resolved to, compared field by field.
+    struct Dependency {
+        bool hasLabel = false;
+        int labelAddress = 0;
+        bool hasDefine = false;
+        int defineValue = 0;
+
+        bool operator==(const Dependency& other) const {
+            return hasLabel == other.hasLabel && labelAddress == other.labelAddress &&
+                   hasDefine == other.hasDefine && defineValue == other.defineValue;
+        }
+        bool operator!=(const Dependency& other) const { return !(*this == other); }
+    };
+
+    struct CachedEncoding {
+        bool valid = false;
+        int address = 0;
+        Dependency dependency;
+        bool hasDependency = false;
+        std::vector<uint16_t> words;
+    };
+
+    struct SourceLine {
+        std::string text;
+        int number = 0;
+        uint32_t id = 0;            // survives renumbering, see lineNumber()
+        bool parsed = false;        // false: lexing or parsing the line alone failed
+        std::vector<Token> tokens;
+        std::vector<std::unique_ptr<Statement>> statements;
+        std::vector<CachedEncoding> encodings;   // parallel to statements
+    };
+
+    std::vector<SourceLine> lines;
+    std::vector<size_t> lineStarts;         // of the source passed to the last update()
+    std::vector<Statement*> statementView;
+    std::vector<CachedEncoding*> encodingView;
+    std::vector<int> addresses;
+    SymbolTable symbolTable;
+    SymbolIndex symbolIndex;
+    bool indexSymbols;
+    uint32_t nextLineId = 1;
+    size_t encodedPrefix = 0;       // statements of statementView encoded by the last update
+    AssembleResult result;
+    UpdateStats stats;
+    AssemblerContext fallback;
+
+    static void findLineStarts(const std::string& source, std::vector<size_t>& starts);
+    static void parseLine(SourceLine& line);
+    static void renumber(SourceLine& line, int number);
+    bool dependencyOf(const Statement* stmt, Dependency& dependency) const;
+    const AssembleResult& rebuildFromScratch(const std::string& source, const AssembleOptions& options,
+                                             bool keepLines);
+
+public:
+    // With indexSymbols, getSymbolIndex() tracks the names on every line.
+    explicit IncrementalAssembler(bool indexSymbols = false) : indexSymbols(indexSymbols) {}
+
+    // Reassembles source, reusing everything that the edit since the last
+    // call did not touch. Results are identical to AssemblerContext.
+    const AssembleResult& update(const std::string& source,
+                                 const AssembleOptions& options = AssembleOptions());
+
+    const AssembleResult& getResult() const { return result; }
+    const UpdateStats& getStats() const { return stats; }
+    // Files read by .incbin in the last update(); only sources that fall
+    // back to a full rebuild can include any.
+    std::vector<std::string> getIncludedFiles() const {
+        return stats.fullRebuild ? fallback.getIncludedFiles() : std::vector<std::string>();
+    }
+
+    // Source-level queries for editors; lines are 1-based. They describe
+    // the last update() and come back empty for sources that update()
+    // cannot cache (.incbin, -O, --strip-unused).
+    const SymbolIndex& getSymbolIndex() const { return symbolIndex; }
+    const SymbolTable& getSymbolTable() const { return symbolTable; }
+    size_t lineCount() const { return lines.size(); }
+    // Current line of a SymbolReference::lineId, 0 if that line is gone.
+    int lineNumber(uint32_t lineId) const;
+    // nullptr when line is out of range.
+    const std::string* lineText(int line) const;
+    // Empty when the line does not lex or parse on its own.
+    const std::vector<Token>* lineTokens(int line) const;
+    // Address of the first word the line assembled to and all of its words.
+    // False when the line emits nothing or the last update stopped earlier.
+    bool lineEncoding(int line, int& address, std::vector<uint16_t>& words) const;
+};
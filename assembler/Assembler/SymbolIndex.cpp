@@ -0,0 +1,69 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "SymbolIndex.h"
+#include <algorithm>
+
+void SymbolIndex::namesOnLine(const std::string& text, const std::vector<Token>& tokens,
+                              std::vector<NameToken>& names) {
+    names.clear();
+    for (size_t i = 0; i < tokens.size(); i++) {
+        const Token& token = tokens[i];
+        const int length = static_cast<int>(token.value.size());
+        switch (token.type) {
+        case TokenType::LABEL:
+            names.push_back({token.value, token.column, length, true});
+            break;
+        case TokenType::LABEL_REF: {
+            const bool define = i > 0 && tokens[i - 1].type == TokenType::DIRECTIVE &&
+                                tokens[i - 1].value == ".define";
+            names.push_back({token.value, token.column, length, define});
+            break;
+        }
+        case TokenType::LABEL_IMMEDIATE:
+        case TokenType::NUMBER_IMMEDIATE: {
+            if (token.hasNumber) break;
+            // The token starts at '#' or '='; the name may follow after spaces.
+            const size_t at = text.find(token.value, static_cast<size_t>(token.column));
+            if (at != std::string::npos) {
+                names.push_back({token.value, static_cast<int>(at) + 1, length, false});
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+void SymbolIndex::addLine(uint32_t lineId, const std::string& text, const std::vector<Token>& tokens) {
+    std::vector<NameToken> names;
+    namesOnLine(text, tokens, names);
+    for (const NameToken& name : names) {
+        references[name.name].push_back({lineId, name.column, name.length, name.definition});
+    }
+}
+
+void SymbolIndex::removeLine(uint32_t lineId, const std::string& text, const std::vector<Token>& tokens) {
+    std::vector<NameToken> names;
+    namesOnLine(text, tokens, names);
+    for (const NameToken& name : names) {
+        auto entry = references.find(name.name);
+        if (entry == references.end()) continue;
+        auto& refs = entry->second;
+        refs.erase(std::remove_if(refs.begin(), refs.end(),
+                                  [lineId](const SymbolReference& ref) { return ref.lineId == lineId; }),
+                   refs.end());
+        if (refs.empty()) {
+            references.erase(entry);
+        }
+    }
+}
+
+const std::vector<SymbolReference>& SymbolIndex::find(const std::string& name) const {
+    static const std::vector<SymbolReference> none;
+    auto entry = references.find(name);
+    return entry == references.end() ? none : entry->second;
+}
@@ -0,0 +1,51 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Cross-reference index of label and .define names: where each
+//              one is defined ("NAME:", ".define NAME") and used (branch
+//              targets, #NAME and =NAME). Complements SymbolTable, which
+//              only holds values. Kept up to date line by line by
+//              IncrementalAssembler, so an edit only touches the names on
+//              the edited lines.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "Lexer/Lexer.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct SymbolReference {
+    uint32_t lineId;    // stable id of the source line, see IncrementalAssembler::lineNumber
+    int column;         // 1-based column of the name
+    int length;
+    bool definition;
+};
+
+// One name on a line, as found by SymbolIndex::namesOnLine().
+struct NameToken {
+    std::string name;
+    int column;
+    int length;
+    bool definition;
+};
+
+class SymbolIndex {
+private:
+    std::unordered_map<std::string, std::vector<SymbolReference>> references;
+
+public:
+    // The label and define names in the tokens of one line. text is the line
+    // itself, needed to find the name inside #NAME and = NAME tokens.
+    static void namesOnLine(const std::string& text, const std::vector<Token>& tokens,
+                            std::vector<NameToken>& names);
+
+    void addLine(uint32_t lineId, const std::string& text, const std::vector<Token>& tokens);
+    void removeLine(uint32_t lineId, const std::string& text, const std::vector<Token>& tokens);
+    void clear() { references.clear(); }
+
+    // Definitions and uses of name in no particular order; empty if unknown.
+    const std::vector<SymbolReference>& find(const std::string& name) const;
+    size_t size() const { return references.size(); }
+};
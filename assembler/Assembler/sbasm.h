@@ -0,0 +1,99 @@
+/* ----------------------------------------------------------------------------
+ * Author: LeonW
+ * Date: October 18, 2026
+ * Description: Stable C ABI for embedding the qCore assembler (for example
+ *              from Python via ctypes/cffi). A context owns every buffer it
+ *              hands out; pointers stay valid until the next
+ *              sbasm_assemble() call on that context or its destruction.
+ *              Contexts are not thread-safe, use one per thread.
+ * ------------------------------------------------------------------------- */
+
+#ifndef SBASM_H
+#define SBASM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(SBASM_SHARED_EXPORTS)
+#    define SBASM_API __declspec(dllexport)
+#  elif defined(SBASM_SHARED)
+#    define SBASM_API __declspec(dllimport)
+#  else
+#    define SBASM_API
+#  endif
+#else
+#  define SBASM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped whenever a signature or struct layout below changes. */
+#define SBASM_ABI_VERSION 2
+
+typedef struct sbasm_context sbasm_context;
+
+typedef struct sbasm_options {
+    int32_t default_depth;  /* memory depth when the source has no DEPTH line */
+    uint32_t jobs;          /* worker threads, 0 or 1 = single-threaded */
+} sbasm_options;
+
+typedef struct sbasm_symbol {
+    const char* name;
+    int32_t value;
+    int32_t is_label;       /* 1 = label address, 0 = .define constant */
+} sbasm_symbol;
+
+typedef struct sbasm_segment {
+    int32_t base;           /* first address */
+    int32_t length;         /* words */
+    size_t offset;          /* index of its first word in sbasm_words() */
+    int32_t is_data;
+} sbasm_segment;
+
+typedef struct sbasm_diagnostic {
+    int32_t line;           /* 0 when unknown */
+    int32_t column;
+    const char* message;
+} sbasm_diagnostic;
+
+SBASM_API uint32_t sbasm_abi_version(void);
+SBASM_API void sbasm_options_init(sbasm_options* options);
+
+SBASM_API sbasm_context* sbasm_context_create(void);
+SBASM_API void sbasm_context_destroy(sbasm_context* context);
+
+/* Assembles `length` bytes of source. Returns 1 on success, 0 when the
+ * source has errors (see the diagnostics) and -1 for invalid arguments.
+ * `options` may be NULL for the defaults. */
+SBASM_API int sbasm_assemble(sbasm_context* context, const char* source, size_t length,
+                             const sbasm_options* options);
+
+SBASM_API int32_t sbasm_depth(const sbasm_context* context);
+SBASM_API size_t sbasm_word_count(const sbasm_context* context);
+SBASM_API const uint16_t* sbasm_words(const sbasm_context* context);
+/* One byte per word: 1 for .word data, 0 for instructions. */
+SBASM_API const uint8_t* sbasm_data_flags(const sbasm_context* context);
+
+/* Words are packed in source order; segments say where they are placed
+ * (.org and .space leave gaps). Sorted by base. Without .org or .space the
+ * words simply start at address 0. */
+SBASM_API size_t sbasm_segment_count(const sbasm_context* context);
+SBASM_API int sbasm_get_segment(const sbasm_context* context, size_t index, sbasm_segment* segment);
+
+/* Symbols are sorted by value, then name. Getters return 0 when `index` is
+ * out of range and 1 otherwise. */
+SBASM_API size_t sbasm_symbol_count(const sbasm_context* context);
+SBASM_API int sbasm_get_symbol(const sbasm_context* context, size_t index, sbasm_symbol* symbol);
+
+SBASM_API size_t sbasm_diagnostic_count(const sbasm_context* context);
+SBASM_API int sbasm_get_diagnostic(const sbasm_context* context, size_t index,
+                                   sbasm_diagnostic* diagnostic);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SBASM_H */
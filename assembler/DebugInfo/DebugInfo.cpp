@@ -0,0 +1,227 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "DebugInfo.h"
+#include "Output/FileUpdate.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+constexpr uint8_t DebugInfo::VERSION;
+
+static const char MAGIC[4] = {'S', 'B', 'D', 'I'};
+
+static void writeUnsigned(std::string& out, uint64_t value) {
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        out.push_back(static_cast<char>(value ? byte | 0x80 : byte));
+    } while (value);
+}
+
+static void writeSigned(std::string& out, int64_t value) {
+    writeUnsigned(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+namespace {
+class Reader {
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+
+public:
+    Reader(const std::string& bytes)
+        : p(reinterpret_cast<const uint8_t*>(bytes.data())), end(p + bytes.size()) {}
+
+    void expect(const void* data, size_t length) {
+        if (static_cast<size_t>(end - p) < length || std::memcmp(p, data, length) != 0) {
+            throw std::runtime_error("Not a debug-info file");
+        }
+        p += length;
+    }
+
+    uint8_t byte() {
+        if (p == end) throw std::runtime_error("Truncated debug-info file");
+        return *p++;
+    }
+
+    uint64_t unsignedValue() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = byte();
+            value |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return value;
+        }
+        throw std::runtime_error("Malformed number in debug-info file");
+    }
+
+    int64_t signedValue() {
+        uint64_t value = unsignedValue();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // Element counts are bounded by the remaining bytes, so a corrupt count
+    // cannot make load() reserve gigabytes.
+    size_t count(size_t minBytesPerElement) {
+        uint64_t value = unsignedValue();
+        if (value > static_cast<uint64_t>(end - p) / minBytesPerElement) {
+            throw std::runtime_error("Corrupt count in debug-info file");
+        }
+        return static_cast<size_t>(value);
+    }
+
+    const char* take(size_t length) {
+        if (static_cast<size_t>(end - p) < length) throw std::runtime_error("Truncated debug-info file");
+        const char* data = reinterpret_cast<const char*>(p);
+        p += length;
+        return data;
+    }
+
+    bool atEnd() const { return p == end; }
+};
+}
+
+std::string DebugInfo::serialize(const AssembleResult& result) {
+    std::string out(MAGIC, sizeof(MAGIC));
+    out.push_back(static_cast<char>(VERSION));
+    writeUnsigned(out, imageEnd(result.segments));
+
+    // result.segments is sorted by base and its segments do not overlap.
+    writeUnsigned(out, result.segments.size());
+    int end = 0;
+    for (const auto& segment : result.segments) {
+        writeUnsigned(out, segment.base - end);
+        writeUnsigned(out, segment.length);
+        end = segment.end();
+    }
+
+    // Rows come in statement order, which .org can make non-monotonic.
+    auto byAddress = [](const LineEntry& a, const LineEntry& b) { return a.address < b.address; };
+    const std::vector<LineEntry>* rows = &result.lineTable;
+    std::vector<LineEntry> sorted;
+    if (!std::is_sorted(rows->begin(), rows->end(), byAddress)) {
+        sorted = *rows;
+        std::stable_sort(sorted.begin(), sorted.end(), byAddress);
+        rows = &sorted;
+    }
+
+    writeUnsigned(out, rows->size());
+    int address = 0;
+    int line = 0;
+    for (const auto& row : *rows) {
+        writeUnsigned(out, row.address - address);
+        writeSigned(out, static_cast<int64_t>(row.line) - line);
+        writeUnsigned(out, row.column);
+        address = row.address;
+        line = row.line;
+    }
+
+    // result.symbols is already sorted by value, then name.
+    size_t labelCount = std::count_if(result.symbols.begin(), result.symbols.end(),
+                                      [](const SymbolInfo& s) { return s.isLabel; });
+    writeUnsigned(out, labelCount);
+    address = 0;
+    for (const auto& symbol : result.symbols) {
+        if (!symbol.isLabel) continue;
+        writeUnsigned(out, symbol.value - address);
+        writeUnsigned(out, symbol.name.size());
+        out += symbol.name;
+        address = symbol.value;
+    }
+    return out;
+}
+
+void DebugInfo::load(const std::string& bytes) {
+    Reader in(bytes);
+    in.expect(MAGIC, sizeof(MAGIC));
+    if (in.byte() != VERSION) {
+        throw std::runtime_error("Unsupported debug-info version");
+    }
+    wordCount = static_cast<uint32_t>(in.unsignedValue());
+
+    size_t segments = in.count(2);
+    segmentBases.resize(segments);
+    segmentEnds.resize(segments);
+    uint32_t end = 0;
+    for (size_t i = 0; i < segments; i++) {
+        segmentBases[i] = end + static_cast<uint32_t>(in.unsignedValue());
+        end = segmentBases[i] + static_cast<uint32_t>(in.unsignedValue());
+        segmentEnds[i] = end;
+    }
+
+    size_t rows = in.count(3);
+    rowAddresses.resize(rows);
+    rowLines.resize(rows);
+    rowColumns.resize(rows);
+    uint32_t address = 0;
+    int64_t line = 0;
+    for (size_t i = 0; i < rows; i++) {
+        address += static_cast<uint32_t>(in.unsignedValue());
+        line += in.signedValue();
+        rowAddresses[i] = address;
+        rowLines[i] = static_cast<uint32_t>(line);
+        rowColumns[i] = static_cast<uint32_t>(in.unsignedValue());
+    }
+
+    size_t labels = in.count(2);
+    labelAddresses.resize(labels);
+    labelNames.resize(labels);
+    names.clear();
+    address = 0;
+    for (size_t i = 0; i < labels; i++) {
+        address += static_cast<uint32_t>(in.unsignedValue());
+        size_t length = in.count(1);
+        labelAddresses[i] = address;
+        labelNames[i] = static_cast<uint32_t>(names.size());
+        names.append(in.take(length), length);
+        names.push_back('\0');
+    }
+
+    if (!in.atEnd()) {
+        throw std::runtime_error("Trailing bytes in debug-info file");
+    }
+}
+
+void DebugInfo::loadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open debug-info file: " + path);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    load(buffer.str());
+}
+
+bool DebugInfo::findLine(uint32_t address, int& line, int& column) const {
+    auto segment = std::upper_bound(segmentBases.begin(), segmentBases.end(), address);
+    if (segment == segmentBases.begin() || address >= segmentEnds[(segment - segmentBases.begin()) - 1]) {
+        return false;
+    }
+    auto it = std::upper_bound(rowAddresses.begin(), rowAddresses.end(), address);
+    if (it == rowAddresses.begin()) {
+        return false;
+    }
+    size_t row = (it - rowAddresses.begin()) - 1;
+    line = static_cast<int>(rowLines[row]);
+    column = static_cast<int>(rowColumns[row]);
+    return true;
+}
+
+const char* DebugInfo::findLabel(uint32_t address, uint32_t& offset) const {
+    auto it = std::upper_bound(labelAddresses.begin(), labelAddresses.end(), address);
+    if (it == labelAddresses.begin()) {
+        return nullptr;
+    }
+    // Of several labels on one address, report the first by name.
+    uint32_t labelAddress = *(it - 1);
+    size_t index = std::lower_bound(labelAddresses.begin(), it, labelAddress) - labelAddresses.begin();
+    offset = address - labelAddress;
+    return names.c_str() + labelNames[index];
+}
+
+bool writeDebugInfo(const AssembleResult& result, const std::string& path) {
+    return writeFileIfChanged(path, DebugInfo::serialize(result));
+}
@@ -0,0 +1,63 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Debug-info sidecar (.sbdi) written next to the MIF with -g.
+//              Maps machine addresses back to source lines and label names.
+//
+//              Layout, every integer an unsigned LEB128 unless noted:
+//                "SBDI" version(byte) wordCount (end of the image)
+//                segmentCount { gap  length }
+//                rowCount    { addressDelta  zigzag(lineDelta)  column }
+//                labelCount  { addressDelta  nameLength  name bytes }
+//              Segments are the address ranges that hold words; gap is the
+//              distance from the end of the previous one, so addresses that
+//              .org skipped map to no line. Rows and labels are sorted by
+//              address and delta-encoded against the previous entry, so a
+//              typical row takes 3 bytes.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "Assembler/Assembler.h"
+#include <string>
+#include <vector>
+
+class DebugInfo {
+private:
+    uint32_t wordCount = 0;     // first address after the image
+    // Loaded tables are kept as parallel arrays so that lookups binary
+    // search over a dense address column.
+    std::vector<uint32_t> segmentBases;
+    std::vector<uint32_t> segmentEnds;
+    std::vector<uint32_t> rowAddresses;
+    std::vector<uint32_t> rowLines;
+    std::vector<uint32_t> rowColumns;
+    std::vector<uint32_t> labelAddresses;
+    std::vector<uint32_t> labelNames;   // offsets into names
+    std::string names;                  // NUL-terminated label names
+
+public:
+    static constexpr uint8_t VERSION = 2;
+
+    // Encodes the line table and labels of a successful assembly.
+    static std::string serialize(const AssembleResult& result);
+
+    // Replaces the current contents. Throws std::runtime_error when bytes
+    // is not a valid sidecar.
+    void load(const std::string& bytes);
+    void loadFile(const std::string& path);
+
+    // Source position of the statement that emitted the word at address;
+    // false for addresses outside every segment.
+    bool findLine(uint32_t address, int& line, int& column) const;
+    // Closest label at or below address, nullptr when there is none.
+    // offset receives the distance from that label.
+    const char* findLabel(uint32_t address, uint32_t& offset) const;
+
+    uint32_t getWordCount() const { return wordCount; }
+    size_t segmentCount() const { return segmentBases.size(); }
+    size_t rowCount() const { return rowAddresses.size(); }
+    size_t labelCount() const { return labelAddresses.size(); }
+};
+
+// Returns false when path already held the same bytes and was left alone.
+bool writeDebugInfo(const AssembleResult& result, const std::string& path);
@@ -4,6 +4,8 @@
 // ----------------------------------------------------------------------------
 
 #include "InstructionEncoder.h"
+#include <algorithm>
+#include <cstring>
 
 uint8_t Encoder::parseRegister(const std::string& reg) {
     static const std::unordered_map<std::string, uint8_t> regMap = {
@@ -60,53 +62,102 @@ uint16_t Encoder::encodeImmediate(int64_t value, int bits, const std::string& co
 }
 
 int64_t Encoder::parseImmediateOrSymbol(const std::string& value, const std::string& context) {
-    try {
-        if (symbolTable.hasDefine(value)) {
-            return symbolTable.getDefineValue(value);
-        }
-        
-        std::string numStr = value;
-        if (numStr[0] == '#') numStr = numStr.substr(1);
-        
-        if (numStr.size() >= 2) {
-            if (numStr.substr(0, 2) == "0x" || numStr.substr(0, 2) == "0X") {
-                return std::stoll(numStr.substr(2), nullptr, 16);
-            }
-            if (numStr.substr(0, 2) == "0b" || numStr.substr(0, 2) == "0B") {
-                return std::stoll(numStr.substr(2), nullptr, 2);
-            }
+    if (symbolTable.hasDefine(value)) {
+        return symbolTable.getDefineValue(value);
+    }
+
+    const char* begin = value.data();
+    const char* end = begin + value.size();
+    if (begin != end && *begin == '#') begin++;
+
+    int64_t result = 0;
+    switch (parseNumericLiteral(begin, end, result)) {
+        case NumberStatus::OK:
+            return result;
+        case NumberStatus::OUT_OF_RANGE:
+            throw std::runtime_error("Immediate value '" + value + "' for " + context + " is out of range");
+        default:
+            throw std::runtime_error("Failed to parse immediate value '" + value + "' for " + context);
+    }
+}
+
+int64_t Encoder::immediateOperand(const Instruction* instr, const std::string& context) {
+    if (instr->hasNumber) {
+        return instr->number;
+    }
+    return parseImmediateOrSymbol(instr->operand2, context);
+}
+
+void Encoder::encodeBinary(const Directive* dir) {
+    if (dir->count > 0 && !dir->payload) {
+        throw std::runtime_error(".incbin \"" + dir->value + "\" was not loaded");
+    }
+    const size_t first = machineCode.size();
+    const size_t count = static_cast<size_t>(dir->count);
+    machineCode.resize(first + count);
+
+    // Straight copy when the file's byte order is the host's.
+    const uint16_t probe = 1;
+    const bool hostLittle = *reinterpret_cast<const uint8_t*>(&probe) == 1;
+    if (count > 0 && hostLittle != dir->bigEndian) {
+        std::memcpy(&machineCode[first], dir->payload, count * 2);
+    } else {
+        const uint8_t* bytes = dir->payload;
+        const int high = dir->bigEndian ? 0 : 1;
+        for (size_t i = 0; i < count; i++) {
+            machineCode[first + i] = static_cast<uint16_t>(bytes[2 * i + high] << 8 | bytes[2 * i + 1 - high]);
         }
-        return std::stoll(numStr, nullptr, 0);
-    } catch (const std::exception& e) {
-        throw std::runtime_error("Failed to parse immediate value '" + value + "' for " + context + ": " + e.what());
     }
+    currentAddress += static_cast<int>(count);
 }
 
 void Encoder::encodeDirective(Directive* dir) {
     try {
-        if (dir->name == ".word") {
-            int64_t value = parseImmediateOrSymbol(dir->value, ".word directive");
+        if (dir->name == ".word" && !dir->values.empty()) {
+            for (int64_t value : dir->values) {
+                if (value > 0xFFFF || value < -0x8000) {
+                    throw std::runtime_error(".word value " + std::to_string(value) +
+                                             " out of range [-32768, 65535]");
+                }
+                machineCode.push_back(static_cast<uint16_t>(value & 0xFFFF));
+            }
+            currentAddress += static_cast<int>(dir->values.size());
+        } else if (dir->name == ".word") {
+            int64_t value = dir->hasNumber ? dir->number : parseImmediateOrSymbol(dir->value, ".word directive");
             if (value > 0xFFFF || value < -0x8000) {
                 throw std::runtime_error(".word value out of range [-32768, 65535]");
             }
             machineCode.push_back(static_cast<uint16_t>(value & 0xFFFF));
             currentAddress++;
+        } else if (dir->name == ".fill") {
+            if (dir->number > 0xFFFF || dir->number < -0x8000) {
+                throw std::runtime_error(".fill value out of range [-32768, 65535]");
+            }
+            machineCode.insert(machineCode.end(), static_cast<size_t>(dir->count),
+                               static_cast<uint16_t>(dir->number & 0xFFFF));
+            currentAddress += static_cast<int>(dir->count);
+        } else if (dir->name == ".incbin") {
+            encodeBinary(dir);
+        } else {
+            currentAddress = nextAddress(dir, currentAddress);
         }
     } catch (const std::exception& e) {
-        throw std::runtime_error("Error encoding directive at line " + 
-                                std::to_string(dir->line) + ": " + e.what());
+        throw AssemblyError("Error encoding directive at line " + 
+                            std::to_string(dir->line) + ": " + e.what(), dir->line, dir->column, dir->file);
     }
 }
 
 void Encoder::encodeMoveInstruction(Instruction* instr, const uint8_t rX) {
     if (instr->isLabelImmediate) {
         int64_t value;
-        if (symbolTable.hasLabel(instr->operand2)) {
+        if (instr->hasNumber) {
+            value = instr->number;
+        } else if (symbolTable.hasLabel(instr->operand2)) {
             value = symbolTable.getLabelAddress(instr->operand2);
         } else if (symbolTable.hasDefine(instr->operand2)) {
             value = symbolTable.getDefineValue(instr->operand2);
         } else {
-            value = parseImmediateOrSymbol(instr->operand2, "move label immediate");
+            value = immediateOperand(instr, "move label immediate");
         }
         
         machineCode.push_back(MVT | (rX << 9) | ((value >> 8) & 0xFF));
@@ -117,8 +168,8 @@ void Encoder::encodeMoveInstruction(Instruction* instr, const uint8_t rX) {
 
     if (instr->isImmediate) {
         int64_t value;
-        if (!symbolTable.hasDefine(instr->operand2)) {
-            value = parseImmediateOrSymbol(instr->operand2, "move immediate");
+        if (instr->hasNumber || !symbolTable.hasDefine(instr->operand2)) {
+            value = immediateOperand(instr, "move immediate");
             if (value > 255 || value < -256) {
                 throw std::runtime_error("Immediate value with # must fit in 9 bits (-256 to 255), got: " + std::to_string(value) + ". Use = for larger values.");
             }
@@ -176,7 +227,7 @@ void Encoder::encodeALUInstruction(Instruction* instr, const uint8_t rX) {
     }
 
     if (instr->isImmediate) {
-        const int64_t imm = parseImmediateOrSymbol(instr->operand2, context);
+        const int64_t imm = immediateOperand(instr, context);
         if (instr->isLabelImmediate) {
             if (imm > 0xFFFF || imm < -0x8000) {
                 throw std::runtime_error("16-bit immediate value out of range (-32768 to 65535)");
@@ -215,7 +266,7 @@ void Encoder::encodeMemoryInstruction(Instruction* instr, const uint8_t rX) {
 
 void Encoder::encodeCompareInstruction(Instruction* instr, const uint8_t rX) {
     if (instr->isImmediate) {
-        const int64_t imm = parseImmediateOrSymbol(instr->operand2, "compare");
+        const int64_t imm = immediateOperand(instr, "compare");
         machineCode.push_back(CMP_IMM | (rX << 9) | encodeImmediate(imm, 9, "compare"));
     } else {
         const uint8_t rY = parseRegister(instr->operand2);
@@ -229,7 +280,7 @@ void Encoder::encodeShiftInstruction(Instruction* instr, const uint8_t rX) {
     uint16_t encoded = CMP_REG | (rX << 9) | (0b10 << 7) | (shiftType << 5);
     
     if (instr->isImmediate) {
-        const int64_t imm = parseImmediateOrSymbol(instr->operand2, "shift amount");
+        const int64_t imm = immediateOperand(instr, "shift amount");
         if (imm > 15 || imm < 0) {
             throw std::runtime_error("Shift amount must be between 0 and 15");
         }
@@ -244,7 +295,7 @@ void Encoder::encodeShiftInstruction(Instruction* instr, const uint8_t rX) {
 }
 
 void Encoder::encodeMovTopInstruction(Instruction* instr, const uint8_t rX) {
-    const int64_t imm = parseImmediateOrSymbol(instr->operand2, "mvt");
+    const int64_t imm = immediateOperand(instr, "mvt");
     if (imm > 255 || imm < -128) {
         throw std::runtime_error("MVT immediate value must fit in 8 bits");
     }
@@ -284,28 +335,170 @@ void Encoder::encodeInstruction(Instruction* instr) {
             throw std::runtime_error("Unknown instruction: " + instr->opcode);
         }
     } catch (const std::exception& e) {
-        throw std::runtime_error("Error encoding instruction at line " + std::to_string(instr->line) + ": " + e.what());
+        throw AssemblyError("Error encoding instruction at line " + std::to_string(instr->line) + ": " + e.what(),
+                            instr->line, instr->column, instr->file);
     }
 }
 
 
+int Encoder::wordCount(const Statement* stmt) {
+    switch (stmt->type) {
+        case StatementType::DIRECTIVE: {
+            auto dir = static_cast<const Directive*>(stmt);
+            if (dir->name == ".word") return dir->values.empty() ? 1 : static_cast<int>(dir->values.size());
+            if (dir->name == ".fill" || dir->name == ".incbin") return static_cast<int>(dir->count);
+            return 0;
+        }
+        case StatementType::INSTRUCTION: {
+            auto instr = static_cast<const Instruction*>(stmt);
+            if (instr->isLabelImmediate &&
+                (instr->opcode == "mv" ||
+                 (instr->isImmediate && (instr->opcode == "add" || instr->opcode == "sub" || instr->opcode == "and")))) {
+                return 2;
+            }
+            return 1;
+        }
+        default:
+            return 0;
+    }
+}
+
+int Encoder::nextAddress(const Statement* stmt, int address) {
+    if (stmt->type == StatementType::DIRECTIVE) {
+        auto dir = static_cast<const Directive*>(stmt);
+        if (dir->name == ".org") return static_cast<int>(dir->number);
+        if (dir->name == ".space") return address + static_cast<int>(dir->number);
+    }
+    return address + wordCount(stmt);
+}
+
+void Encoder::encodeStatement(Statement* stmt) {
+    const size_t wordsBefore = machineCode.size();
+    const int address = currentAddress;
+
+    switch (stmt->type) {
+        case StatementType::LABEL:
+            break;
+        case StatementType::DIRECTIVE:
+            encodeDirective(static_cast<Directive*>(stmt));
+            break;
+        case StatementType::INSTRUCTION:
+            encodeInstruction(static_cast<Instruction*>(stmt));
+            break;
+        default:
+            throw std::runtime_error("Unknown statement type at line " + std::to_string(stmt->line));
+    }
+
+    if (lineTable && machineCode.size() != wordsBefore) {
+        lineTable->push_back({address, stmt->line, stmt->column});
+    }
+}
+
 std::vector<uint16_t> Encoder::encode(const std::vector<std::unique_ptr<Statement>>& ast) {
     machineCode.clear();
     currentAddress = 0;
+    if (lineTable) {
+        lineTable->clear();
+    }
     
     for (const auto& stmt : ast) {
-        switch (stmt->type) {
-            case StatementType::LABEL:
-                break;
-            case StatementType::DIRECTIVE:
-                encodeDirective(static_cast<Directive*>(stmt.get()));
-                break;
-            case StatementType::INSTRUCTION:
-                encodeInstruction(static_cast<Instruction*>(stmt.get()));
-                break;
-            default:
-                throw std::runtime_error("Unknown statement type at line " + std::to_string(stmt->line));
-        }
+        encodeStatement(stmt.get());
     }
     return machineCode;
-}
\ No newline at end of file
+}
+
+void Encoder::encodeAt(Statement* stmt, int address, std::vector<uint16_t>& words) {
+    machineCode.clear();
+    currentAddress = address;
+    encodeStatement(stmt);
+    words.assign(machineCode.begin(), machineCode.end());
+}
+
+std::vector<uint16_t> Encoder::encodeParallel(const std::vector<std::unique_ptr<Statement>>& ast,
+                                              unsigned threadCount) {
+    if (threadCount <= 1 || ast.size() < MIN_PARALLEL_STATEMENTS) {
+        return encode(ast);
+    }
+
+    // offsets index the packed output, addresses follow .org and .space.
+    std::vector<int> offsets(ast.size() + 1, 0);
+    std::vector<int> addresses(ast.size() + 1, 0);
+    for (size_t i = 0; i < ast.size(); i++) {
+        offsets[i + 1] = offsets[i] + wordCount(ast[i].get());
+        addresses[i + 1] = nextAddress(ast[i].get(), addresses[i]);
+    }
+    const int totalWords = offsets.back();
+
+    struct Chunk {
+        size_t begin;
+        size_t end;
+        std::exception_ptr error;
+        std::vector<LineEntry> rows;
+    };
+
+    // Cut at statement boundaries so every chunk gets roughly the same
+    // number of words, then let each worker fill its own output slice.
+    std::vector<Chunk> chunks;
+    const int wordsPerChunk = std::max(1, (totalWords + static_cast<int>(threadCount) - 1) /
+                                          static_cast<int>(threadCount));
+    size_t begin = 0;
+    for (size_t i = 0; i < ast.size(); i++) {
+        if (offsets[i + 1] - offsets[begin] >= wordsPerChunk && chunks.size() + 1 < threadCount) {
+            chunks.push_back({begin, i + 1, nullptr, {}});
+            begin = i + 1;
+        }
+    }
+    if (begin < ast.size()) {
+        chunks.push_back({begin, ast.size(), nullptr, {}});
+    }
+
+    std::vector<uint16_t> output(totalWords);
+    std::vector<std::thread> workers;
+    workers.reserve(chunks.size());
+
+    for (auto& chunk : chunks) {
+        workers.emplace_back([&, this](Chunk* c) {
+            try {
+                Encoder worker(symbolTable);
+                worker.currentAddress = addresses[c->begin];
+                worker.lineTable = lineTable ? &c->rows : nullptr;
+                worker.machineCode.reserve(offsets[c->end] - offsets[c->begin]);
+                for (size_t i = c->begin; i < c->end; i++) {
+                    worker.encodeStatement(ast[i].get());
+                }
+                if (worker.currentAddress != addresses[c->end] ||
+                    worker.machineCode.size() != static_cast<size_t>(offsets[c->end] - offsets[c->begin])) {
+                    throw std::logic_error("Encoded size mismatch in statements starting at line " +
+                                           std::to_string(ast[c->begin]->line));
+                }
+                std::copy(worker.machineCode.begin(), worker.machineCode.end(),
+                          output.begin() + offsets[c->begin]);
+            } catch (...) {
+                c->error = std::current_exception();
+            }
+        }, &chunk);
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // The serial encoder stops at the first failing statement, so report
+    // the error of the earliest chunk to keep diagnostics identical.
+    for (const auto& chunk : chunks) {
+        if (chunk.error) {
+            std::rethrow_exception(chunk.error);
+        }
+    }
+
+    if (lineTable) {
+        lineTable->clear();
+        for (const auto& chunk : chunks) {
+            lineTable->insert(lineTable->end(), chunk.rows.begin(), chunk.rows.end());
+        }
+    }
+
+    machineCode = output;
+    currentAddress = addresses.back();
+    return output;
+}
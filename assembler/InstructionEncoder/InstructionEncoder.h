@@ -7,13 +7,25 @@
 #include <unordered_map>
 #include "SymbolTable.h"
 #include <vector>
+#include <thread>
+#include <exception>
 #include "Parser/Parser.h"
+#include "MemoryImage.h"
+
+// Source position of the statement that starts at address. One row per
+// statement that emits words, in address order.
+struct LineEntry {
+    int address;
+    int line;
+    int column;
+};
 
 class Encoder {
 private:
     SymbolTable& symbolTable;
     std::vector<uint16_t> machineCode;
     int currentAddress;
+    std::vector<LineEntry>* lineTable = nullptr;
 
     static constexpr uint16_t MV_REG   = 0x0000;
     static constexpr uint16_t MV_IMM   = 0x1000;
@@ -42,8 +54,12 @@ private:
     uint16_t encodeImmediate(int64_t value, int bits, const std::string& context);
 
     int64_t parseImmediateOrSymbol(const std::string& value, const std::string& context);
+    // Uses the value the lexer decoded when there is one, so numeric
+    // operands are never re-parsed; falls back to the operand text.
+    int64_t immediateOperand(const Instruction* instr, const std::string& context);
 
     void encodeDirective(Directive* dir);
+    void encodeBinary(const Directive* dir);
     void encodeMoveInstruction(Instruction* instr, const uint8_t rX);
 
     void encodeBranchInstruction(Instruction* instr);
@@ -57,9 +73,37 @@ private:
 
     void encodeMovTopInstruction(Instruction* instr, const uint8_t rX);
     void encodeInstruction(Instruction* instr);
+    void encodeStatement(Statement* stmt);
+
+    // Statements below this count are not worth the thread start-up cost.
+    static constexpr size_t MIN_PARALLEL_STATEMENTS = 4096;
 
 public:
     Encoder(SymbolTable& st) : symbolTable(st), currentAddress(0) {}
 
+    // Number of words a statement occupies in the image. Must agree with
+    // what encodeStatement() emits, the parallel encoder relies on it to
+    // assign output slices before any encoding happens.
+    static int wordCount(const Statement* stmt);
+    // Address of whatever follows stmt when stmt is placed at address:
+    // .org jumps, .space skips without emitting, everything else advances
+    // by its word count. Ranges are checked by layoutStatements().
+    static int nextAddress(const Statement* stmt, int address);
+
+    // While set, encode() and encodeParallel() replace the contents of
+    // table with the address-to-source rows of what they emit.
+    void setLineTable(std::vector<LineEntry>* table) { lineTable = table; }
+
     std::vector<uint16_t> encode(const std::vector<std::unique_ptr<Statement>>& ast);
+
+    // Encodes a single statement placed at address into words (replacing
+    // its contents). Used for incremental re-encoding.
+    void encodeAt(Statement* stmt, int address, std::vector<uint16_t>& words);
+
+    // Splits the statement list into address-contiguous chunks and encodes
+    // them on up to threadCount workers. The symbol table is only read.
+    // Output and the reported error (the first one in source order) are
+    // identical to encode().
+    std::vector<uint16_t> encodeParallel(const std::vector<std::unique_ptr<Statement>>& ast,
+                                         unsigned threadCount);
 };
\ No newline at end of file
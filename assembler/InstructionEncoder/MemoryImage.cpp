@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "MemoryImage.h"
+#include <algorithm>
+
+long wordIndex(const std::vector<Segment>& segments, int address) {
+    auto segment = std::upper_bound(segments.begin(), segments.end(), address,
+                                    [](int a, const Segment& s) { return a < s.base; });
+    if (segment == segments.begin()) {
+        return -1;
+    }
+    --segment;
+    if (address >= segment->end()) {
+        return -1;
+    }
+    return static_cast<long>(segment->offset) + (address - segment->base);
+}
+
+int imageEnd(const std::vector<Segment>& segments) {
+    return segments.empty() ? 0 : segments.back().end();
+}
+
+void expandSegments(const std::vector<uint16_t>& words, const std::vector<bool>& isData,
+                    const std::vector<Segment>& segments,
+                    std::vector<uint16_t>& denseWords, std::vector<bool>& denseIsData) {
+    const size_t size = static_cast<size_t>(imageEnd(segments));
+    denseWords.assign(size, 0);
+    denseIsData.assign(size, true);
+    for (const auto& segment : segments) {
+        std::copy(words.begin() + segment.offset, words.begin() + segment.offset + segment.length,
+                  denseWords.begin() + segment.base);
+        for (int i = 0; i < segment.length; i++) {
+            denseIsData[segment.base + i] = isData[segment.offset + i];
+        }
+    }
+}
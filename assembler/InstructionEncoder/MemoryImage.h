@@ -0,0 +1,43 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Placement of assembled words in the address space. The
+//              encoder emits words back to back in statement order; .org
+//              and .space move the address without emitting anything, so
+//              the image is a list of segments, each mapping a run of the
+//              packed words to consecutive addresses. Memory use follows
+//              the amount of content, not the highest address.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// qCore addresses are 16 bits wide.
+constexpr int ADDRESS_SPACE_WORDS = 0x10000;
+
+// Words [offset, offset + length) of the packed image, placed at
+// base .. base + length - 1. All words of a segment are of one kind.
+struct Segment {
+    int base;
+    int length;
+    size_t offset;
+    bool isData;
+
+    int end() const { return base + length; }
+};
+
+// Index into the packed words of the word at address, or -1 when no
+// segment covers it. segments must be sorted by base.
+long wordIndex(const std::vector<Segment>& segments, int address);
+
+// First address after the last segment (0 for an empty image).
+int imageEnd(const std::vector<Segment>& segments);
+
+// Address-indexed copy of the image from address 0 to imageEnd(), for
+// analyses that look words up by address. Addresses between segments read
+// as 0 and are flagged as data: nothing was assembled there to execute.
+void expandSegments(const std::vector<uint16_t>& words, const std::vector<bool>& isData,
+                    const std::vector<Segment>& segments,
+                    std::vector<uint16_t>& denseWords, std::vector<bool>& denseIsData);
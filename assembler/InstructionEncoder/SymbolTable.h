@@ -49,4 +49,17 @@ public:
     bool hasDefine(const std::string& name) const {
         return defines.find(name) != defines.end();
     }
+
+    const std::unordered_map<std::string, int>& getLabels() const {
+        return labels;
+    }
+
+    const std::unordered_map<std::string, int>& getDefines() const {
+        return defines;
+    }
+
+    void clear() {
+        labels.clear();
+        defines.clear();
+    }
 };
\ No newline at end of file
@@ -0,0 +1,144 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Character classification table and bulk scanners used by the
+//              lexer. The classes mirror the "C" locale behaviour of the
+//              <cctype> functions they replace. The scanners use AVX2 or
+//              SSE2 when the compiler targets them and fall back to scalar
+//              loops otherwise (or when SBASM_LEXER_SCALAR is defined).
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(SBASM_LEXER_SCALAR) && (defined(__GNUC__) || defined(__clang__))
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SBASM_LEXER_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SBASM_LEXER_SSE2 1
+#endif
+#endif
+
+namespace charscan {
+
+enum CharClass : uint8_t {
+    SPACE       = 1 << 0,   // std::isspace
+    DIGIT       = 1 << 1,   // std::isdigit
+    ALPHA       = 1 << 2,   // std::isalpha
+    IDENT       = 1 << 3,   // std::isalnum, '_' or '$'
+    IDENT_START = 1 << 4,   // std::isalpha, '_' or '$'
+    NUMBER      = 1 << 5,   // hex digits plus the 'x'/'b' radix markers
+};
+
+struct ClassTable {
+    uint8_t classes[256];
+
+    constexpr ClassTable() : classes() {
+        for (int c = 0; c < 256; c++) {
+            uint8_t cls = 0;
+            const bool digit = c >= '0' && c <= '9';
+            const bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            const bool xdigit = digit || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+            if (c == ' ' || (c >= '\t' && c <= '\r')) cls |= SPACE;
+            if (digit) cls |= DIGIT;
+            if (alpha) cls |= ALPHA;
+            if (digit || alpha || c == '_' || c == '$') cls |= IDENT;
+            if (alpha || c == '_' || c == '$') cls |= IDENT_START;
+            if (xdigit || c == 'x' || c == 'X' || c == 'b' || c == 'B') cls |= NUMBER;
+            classes[c] = cls;
+        }
+    }
+};
+
+constexpr ClassTable TABLE{};
+
+inline bool is(char c, uint8_t cls) {
+    return (TABLE.classes[static_cast<unsigned char>(c)] & cls) != 0;
+}
+
+// Length of the prefix of [p, p + n) whose characters all have class cls.
+inline size_t spanClass(const char* p, size_t n, uint8_t cls) {
+    size_t i = 0;
+    while (i < n && is(p[i], cls)) {
+        i++;
+    }
+    return i;
+}
+
+inline size_t spanBlanksScalar(const char* p, size_t n) {
+    size_t i = 0;
+    while (i < n && (p[i] == ' ' || p[i] == '\t')) {
+        i++;
+    }
+    return i;
+}
+
+inline size_t findByteScalar(const char* p, size_t n, char byte) {
+    size_t i = 0;
+    while (i < n && p[i] != byte) {
+        i++;
+    }
+    return i;
+}
+
+// Length of the run of ' ' and '\t' at the start of [p, p + n). Line breaks
+// are left to the caller, which has to count them.
+inline size_t spanBlanks(const char* p, size_t n) {
+    size_t i = 0;
+#if defined(SBASM_LEXER_AVX2)
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    for (; i + 32 <= n; i += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i blank = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(blank));
+        if (mask != 0xFFFFFFFFu) {
+            return i + __builtin_ctz(~mask);
+        }
+    }
+#endif
+#if defined(SBASM_LEXER_AVX2) || defined(SBASM_LEXER_SSE2)
+    const __m128i space16 = _mm_set1_epi8(' ');
+    const __m128i tab16 = _mm_set1_epi8('\t');
+    for (; i + 16 <= n; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(chunk, space16), _mm_cmpeq_epi8(chunk, tab16));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(blank));
+        if (mask != 0xFFFFu) {
+            return i + __builtin_ctz(~mask);
+        }
+    }
+#endif
+    return i + spanBlanksScalar(p + i, n - i);
+}
+
+// Offset of the first occurrence of byte in [p, p + n), or n.
+inline size_t findByte(const char* p, size_t n, char byte) {
+    size_t i = 0;
+#if defined(SBASM_LEXER_AVX2)
+    const __m256i needle = _mm256_set1_epi8(byte);
+    for (; i + 32 <= n; i += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+#if defined(SBASM_LEXER_AVX2) || defined(SBASM_LEXER_SSE2)
+    const __m128i needle16 = _mm_set1_epi8(byte);
+    for (; i + 16 <= n; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle16)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+    return i + findByteScalar(p + i, n - i, byte);
+}
+
+} // namespace charscan
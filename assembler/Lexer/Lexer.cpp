@@ -4,16 +4,27 @@
 // ----------------------------------------------------------------------------
 
 #include "Lexer.h"
+#include <cstring>
+
+constexpr size_t Lexer::MIN_PARALLEL_BYTES;
+constexpr size_t Lexer::MIN_CHUNK_BYTES;
 
 void Lexer::skipWhitespace() {
-    while (position < input.length() && std::isspace(input[position])) {
-        if (input[position] == '\n') {
+    while (position < length) {
+        const size_t blanks = charscan::spanBlanks(source + position, length - position);
+        position += blanks;
+        column += static_cast<int>(blanks);
+
+        if (position >= length || !charscan::is(source[position], charscan::SPACE)) {
+            return;
+        }
+        if (source[position] == '\n') {
             line++;
             column = 1;
             position++;
-        } else if (input[position] == '\r' && 
-                   position + 1 < input.length() && 
-                   input[position + 1] == '\n') {
+        } else if (source[position] == '\r' && 
+                   position + 1 < length && 
+                   source[position + 1] == '\n') {
             line++;
             column = 1;
             position += 2;
@@ -24,43 +35,93 @@ void Lexer::skipWhitespace() {
     }
 }
 
-int64_t Lexer::parseNumberValue(const std::string& str) {
-    std::string numStr = str;
+NumberStatus parseNumericLiteral(const char* begin, const char* end, int64_t& value) {
     bool isNegative = false;
-    
-    if (numStr[0] == '#' || numStr[0] == '=') {
-        numStr = numStr.substr(1);
-    }
-    
-    if (numStr[0] == '-') {
+    if (begin != end && *begin == '-') {
         isNegative = true;
-        numStr = numStr.substr(1);
+        begin++;
     }
 
-    int64_t value = 0;
-    if (numStr.substr(0, 2) == "0x" || numStr.substr(0, 2) == "0X") {
-        value = std::stoll(numStr.substr(2), nullptr, 16);
-    } else if (numStr.substr(0, 2) == "0b" || numStr.substr(0, 2) == "0B") {
-        value = std::stoll(numStr.substr(2), nullptr, 2);
-    } else {
-        value = std::stoll(numStr, nullptr, 10);
+    uint64_t base = 10;
+    if (end - begin >= 2 && begin[0] == '0') {
+        if (begin[1] == 'x' || begin[1] == 'X') {
+            base = 16;
+            begin += 2;
+        } else if (begin[1] == 'b' || begin[1] == 'B') {
+            base = 2;
+            begin += 2;
+        }
+    }
+    if (begin == end) {
+        return NumberStatus::MALFORMED;
+    }
+
+    // Accumulate the magnitude unsigned so that INT64_MIN is representable.
+    const uint64_t limit = isNegative ? (uint64_t(1) << 63) : (uint64_t(1) << 63) - 1;
+    uint64_t magnitude = 0;
+    for (const char* p = begin; p != end; p++) {
+        uint64_t digit;
+        if (*p >= '0' && *p <= '9') {
+            digit = *p - '0';
+        } else if (*p >= 'a' && *p <= 'f') {
+            digit = *p - 'a' + 10;
+        } else if (*p >= 'A' && *p <= 'F') {
+            digit = *p - 'A' + 10;
+        } else {
+            return NumberStatus::MALFORMED;
+        }
+        if (digit >= base) {
+            return NumberStatus::MALFORMED;
+        }
+        if (magnitude > (limit - digit) / base) {
+            return NumberStatus::OUT_OF_RANGE;
+        }
+        magnitude = magnitude * base + digit;
     }
 
-    return isNegative ? -value : value;
+    value = isNegative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+    return NumberStatus::OK;
 }
 
-Token Lexer::nextToken() {
-    if (position >= input.length()) {
-        return Token(TokenType::END_OF_FILE, "EOF", line, column);
+Token Lexer::numberToken(TokenType type, size_t start, int start_column) {
+    Token token(type, std::string(source + start, position - start), line, start_column);
+    switch (parseNumericLiteral(source + start, source + position, token.number)) {
+        case NumberStatus::OK:
+            token.hasNumber = true;
+            return token;
+        case NumberStatus::OUT_OF_RANGE:
+            throw AssemblyError("Numeric literal '" + token.value + "' out of range at line " +
+                                std::to_string(line) + ", column " + std::to_string(start_column),
+                                line, start_column);
+        default:
+            throw AssemblyError("Invalid numeric literal '" + token.value + "' at line " +
+                                std::to_string(line) + ", column " + std::to_string(start_column),
+                                line, start_column);
     }
+}
 
-    skipWhitespace();
+Token Lexer::nextToken() {
+    for (;;) {
+        if (position >= length) {
+            return Token(TokenType::END_OF_FILE, "EOF", line, column);
+        }
+
+        skipWhitespace();
 
-    if (position >= input.length()) {
-        return Token(TokenType::END_OF_FILE, "EOF", line, column);
+        if (position >= length) {
+            return Token(TokenType::END_OF_FILE, "EOF", line, column);
+        }
+
+        if (source[position] == '/' && position + 1 < length && source[position + 1] == '/') {
+            const size_t skipped = charscan::findByte(source + position, length - position, '\n');
+            position += skipped;
+            column += static_cast<int>(skipped);
+            continue;
+        }
+        break;
     }
 
-    char current = input[position];
+    char current = source[position];
     int start_column = column;
     
     if (current == '#' || current == '=') {
@@ -70,39 +131,27 @@ Token Lexer::nextToken() {
         
         skipWhitespace();
         
-        std::string value;
+        const size_t start = position;
         
-        if (position < input.length() && input[position] == '-') {
-            value += input[position];
+        if (position < length && source[position] == '-') {
             position++;
-            column++;
         }
 
-        if (position < input.length()) {
-            if (std::isdigit(input[position])) {
-                while (position < input.length() && 
-                       (std::isdigit(input[position]) || 
-                        input[position] == 'x' || input[position] == 'X' ||
-                        input[position] == 'b' || input[position] == 'B' ||
-                        std::isxdigit(input[position]))) {
-                    value += input[position];
-                    position++;
-                    column++;
-                }
-                return Token(isEquals ? TokenType::LABEL_IMMEDIATE : TokenType::NUMBER_IMMEDIATE, 
-                           value, line, start_column);
+        if (position < length) {
+            const TokenType type = isEquals ? TokenType::LABEL_IMMEDIATE : TokenType::NUMBER_IMMEDIATE;
+            if (charscan::is(source[position], charscan::DIGIT)) {
+                position += charscan::spanClass(source + position, length - position, charscan::NUMBER);
+                column += static_cast<int>(position - start);
+                return numberToken(type, start, start_column);
             }
-            else if (std::isalpha(input[position]) || input[position] == '_' || input[position] == '$') {
-                while (position < input.length() && 
-                       (std::isalnum(input[position]) || input[position] == '_' || input[position] == '$')) {
-                    value += input[position];
-                    position++;
-                    column++;
-                }
-                return Token(isEquals ? TokenType::LABEL_IMMEDIATE : TokenType::NUMBER_IMMEDIATE, value, line, start_column);
+            if (charscan::is(source[position], charscan::IDENT_START)) {
+                position += charscan::spanClass(source + position, length - position, charscan::IDENT);
+                column += static_cast<int>(position - start);
+                return Token(type, std::string(source + start, position - start), line, start_column);
             }
         }
-        throw std::runtime_error("Invalid immediate value at line " + std::to_string(line) + ", column " + std::to_string(start_column));
+        throw AssemblyError("Invalid immediate value at line " + std::to_string(line) + ", column " + std::to_string(start_column),
+                            line, start_column);
     }
 
     switch (current) {
@@ -118,41 +167,37 @@ Token Lexer::nextToken() {
             position++;
             column++;
             return Token(TokenType::BRACKET_CLOSE, "]", line, start_column);
-        case '/':
-            if (position + 1 < input.length() && input[position + 1] == '/') {
-                while (position < input.length() && input[position] != '\n') {
-                    position++;
-                    column++;
-                }
-                return nextToken();
+        case '"': {
+            const size_t start = position + 1;
+            size_t end = start;
+            while (end < length && source[end] != '"' && source[end] != '\n') end++;
+            if (end >= length || source[end] != '"') {
+                throw AssemblyError("Unterminated string at line " + std::to_string(line) + ", column " +
+                                    std::to_string(start_column), line, start_column);
             }
-            break;
+            position = end + 1;
+            column += static_cast<int>(position - start + 1);
+            return Token(TokenType::STRING, std::string(source + start, end - start), line, start_column);
+        }
     }
 
-    if (std::isdigit(current) || current == '-') {
-        std::string number;
+    if (charscan::is(current, charscan::DIGIT) || current == '-') {
+        const size_t start = position;
         if (current == '-') {
-            number += current;
             position++;
             column++;
-            if (position >= input.length() || !std::isdigit(input[position])) {
-                return Token(TokenType::INVALID, number, line, start_column);
+            if (position >= length || !charscan::is(source[position], charscan::DIGIT)) {
+                return Token(TokenType::INVALID, "-", line, start_column);
             }
         }
 
-        while (position < input.length() && 
-               (std::isdigit(input[position]) || 
-                input[position] == 'x' || input[position] == 'X' ||
-                input[position] == 'b' || input[position] == 'B' ||
-                std::isxdigit(input[position]))) {
-            number += input[position];
-            position++;
-            column++;
-        }
-        return Token(TokenType::NUMBER, number, line, start_column);
+        const size_t digits = charscan::spanClass(source + position, length - position, charscan::NUMBER);
+        position += digits;
+        column += static_cast<int>(digits);
+        return numberToken(TokenType::NUMBER, start, start_column);
     }
     
-    if (std::isalpha(current) || current == '.' || current == '_' || current == '$') {
+    if (charscan::is(current, charscan::IDENT_START) || current == '.') {
         return parseIdentifier();
     }
 
@@ -162,33 +207,34 @@ Token Lexer::nextToken() {
 }
 
 Token Lexer::parseIdentifier() {
-    std::string identifier;
+    const size_t start = position;
     int start_column = column;
 
-    if (input[position] == '.') {
-        identifier += input[position];
+    if (source[position] == '.') {
         position++;
-        column++;
     }
 
-    while (position < input.length() && isIdentifierChar(input[position])) {
-        identifier += input[position];
-        position++;
-        column++;
-    }
+    position += charscan::spanClass(source + position, length - position, charscan::IDENT);
+    column += static_cast<int>(position - start);
+    std::string identifier(source + start, position - start);
     
-    if (position < input.length() && input[position] == ':') {
+    if (position < length && source[position] == ':') {
         position++;
         column++;
         return Token(TokenType::LABEL, identifier, line, start_column);
     }
     
-    if (identifier[0] == '.' && (identifier == ".word" || identifier == ".define")) {
+    if (identifier[0] == '.' && (identifier == ".word" || identifier == ".define" ||
+                                 identifier == ".org" || identifier == ".space" || identifier == ".fill" ||
+                                 identifier == ".incbin" || identifier == ".macro" || identifier == ".endm" ||
+                                 identifier == ".rept" || identifier == ".endr" || identifier == ".if" ||
+                                 identifier == ".ifdef" || identifier == ".ifndef" || identifier == ".else" ||
+                                 identifier == ".endif")) {
         return Token(TokenType::DIRECTIVE, identifier, line, start_column);
     }
     
     if (identifier[0] == 'r' && identifier.length() == 2 && 
-        std::isdigit(identifier[1]) && (identifier[1] - '0') <= 7) {
+        charscan::is(identifier[1], charscan::DIGIT) && (identifier[1] - '0') <= 7) {
         return Token(TokenType::REGISTER, identifier, line, start_column);
     }
     
@@ -205,15 +251,317 @@ Token Lexer::parseIdentifier() {
 
 std::vector<Token> Lexer::tokenize() {
     std::vector<Token> tokens;
+    tokenizeInto(tokens);
+    return tokens;
+}
+
+void Lexer::tokenizeInto(std::vector<Token>& tokens) {
+    tokens.clear();
     Token token = nextToken();
 
     while (token.type != TokenType::END_OF_FILE) {
-        if (token.type != TokenType::INVALID) {
-            tokens.push_back(token);
+        if (token.type == TokenType::DIRECTIVE &&
+            (token.value.compare(0, 3, ".if") == 0 || token.value == ".else" || token.value == ".endif")) {
+            conditional(token);
+        } else if (token.type != TokenType::INVALID) {
+            tokens.push_back(std::move(token));
+            // .define NAME number: visible to the conditions that follow.
+            const size_t count = tokens.size();
+            if (count >= 3 && tokens[count - 1].type == TokenType::NUMBER &&
+                tokens[count - 2].type == TokenType::LABEL_REF &&
+                tokens[count - 3].type == TokenType::DIRECTIVE && tokens[count - 3].value == ".define" &&
+                !defines.hasDefine(tokens[count - 2].value)) {
+                defines.addDefine(tokens[count - 2].value, static_cast<int>(tokens[count - 1].number));
+            }
         }
         token = nextToken();
     }
 
-    tokens.push_back(token);
+    if (!openConditions.empty()) {
+        const OpenCondition& open = openConditions.back();
+        throw AssemblyError("Missing .endif for " + open.directive + " at line " + std::to_string(open.line),
+                            open.line, open.column);
+    }
+    tokens.push_back(std::move(token));
+}
+
+// Conditional directives are consumed here and never reach the parser.
+// A disabled branch is passed over by skipDisabled() without lexing it.
+void Lexer::conditional(const Token& directive) {
+    if (directive.value == ".endif" || directive.value == ".else") {
+        if (openConditions.empty() || (directive.value == ".else" && openConditions.back().inElse)) {
+            throw AssemblyError(directive.value + " without .if at line " + std::to_string(directive.line),
+                                directive.line, directive.column);
+        }
+        const OpenCondition block = openConditions.back();
+        openConditions.pop_back();
+        if (directive.value == ".else") {
+            // The .if branch was taken, so the .else branch is disabled.
+            skipDisabled(block, false);
+        }
+        return;
+    }
+
+    OpenCondition block{directive.value, directive.line, directive.column, false};
+    if (evaluateCondition(directive)) {
+        openConditions.push_back(block);
+    } else if (skipDisabled(block, true)) {
+        block.inElse = true;
+        openConditions.push_back(block);
+    }
+}
+
+// Reads the rest of the directive's line:
+//   .ifdef NAME | .ifndef NAME | .if VALUE [op VALUE]
+// where VALUE is a number or a define and op one of == != < <= > >=.
+bool Lexer::evaluateCondition(const Token& directive) {
+    const size_t rest = charscan::findByte(source + position, length - position, '\n');
+    std::string text(source + position, rest);
+    position += rest;
+    column += static_cast<int>(rest);
+    const size_t comment = text.find("//");
+    if (comment != std::string::npos) {
+        text.erase(comment);
+    }
+
+    auto invalid = [&](const std::string& why) {
+        return AssemblyError(why + " in " + directive.value + " at line " + std::to_string(directive.line),
+                             directive.line, directive.column);
+    };
+    size_t p = 0;
+    auto skipBlanks = [&]() {
+        while (p < text.length() && charscan::is(text[p], charscan::SPACE)) p++;
+    };
+    auto word = [&]() {
+        skipBlanks();
+        const size_t start = p;
+        if (p < text.length() && text[p] == '-') p++;
+        p += charscan::spanClass(text.data() + p, text.length() - p, charscan::IDENT);
+        return text.substr(start, p - start);
+    };
+    auto value = [&]() -> int64_t {
+        const std::string operand = word();
+        if (operand.empty()) {
+            throw invalid("Expected a number or name");
+        }
+        if (charscan::is(operand[0], charscan::IDENT_START)) {
+            if (!defines.hasDefine(operand)) {
+                throw invalid("Undefined symbol '" + operand + "'");
+            }
+            return defines.getDefineValue(operand);
+        }
+        int64_t number = 0;
+        if (parseNumericLiteral(operand.data(), operand.data() + operand.length(), number) != NumberStatus::OK) {
+            throw invalid("Invalid number '" + operand + "'");
+        }
+        return number;
+    };
+    auto expectEnd = [&]() {
+        skipBlanks();
+        if (p != text.length()) {
+            throw invalid("Unexpected '" + text.substr(p) + "'");
+        }
+    };
+
+    if (directive.value != ".if") {
+        const std::string name = word();
+        if (name.empty() || !charscan::is(name[0], charscan::IDENT_START)) {
+            throw invalid("Expected a name");
+        }
+        expectEnd();
+        return defines.hasDefine(name) == (directive.value == ".ifdef");
+    }
+
+    const int64_t left = value();
+    skipBlanks();
+    if (p == text.length()) {
+        return left != 0;
+    }
+    const size_t start = p;
+    while (p < text.length() && std::strchr("=!<>", text[p])) p++;
+    const std::string op = text.substr(start, p - start);
+    const int64_t right = value();
+    expectEnd();
+    if (op == "==") return left == right;
+    if (op == "!=") return left != right;
+    if (op == "<") return left < right;
+    if (op == "<=") return left <= right;
+    if (op == ">") return left > right;
+    if (op == ">=") return left >= right;
+    throw invalid("Unknown operator '" + op + "'");
+}
+
+// Moves past a disabled branch, looking only at the first word of each
+// line for nested .if/.ifdef/.ifndef and the matching .else or .endif.
+// Returns true when it stopped after an .else (whose branch is enabled).
+bool Lexer::skipDisabled(const OpenCondition& block, bool stopAtElse) {
+    int depth = 0;
+    for (;;) {
+        const size_t rest = charscan::findByte(source + position, length - position, '\n');
+        if (position + rest >= length) {
+            throw AssemblyError("Missing .endif for " + block.directive + " at line " +
+                                std::to_string(block.line), block.line, block.column);
+        }
+        position += rest + 1;
+        line++;
+        column = 1;
+
+        const size_t blanks = charscan::spanBlanks(source + position, length - position);
+        if (position + blanks >= length || source[position + blanks] != '.') {
+            continue;
+        }
+        const char* word = source + position + blanks;
+        const size_t wordLength = 1 + charscan::spanClass(word + 1, length - position - blanks - 1, charscan::IDENT);
+        auto is = [&](const char* name) {
+            return std::strlen(name) == wordLength && std::memcmp(word, name, wordLength) == 0;
+        };
+
+        if (is(".if") || is(".ifdef") || is(".ifndef")) {
+            depth++;
+        } else if (is(".endif") || is(".else")) {
+            if (depth > 0) {
+                depth -= is(".endif") ? 1 : 0;
+                continue;
+            }
+            position += blanks + wordLength;
+            column += static_cast<int>(blanks + wordLength);
+            if (is(".endif")) {
+                return false;
+            }
+            if (!stopAtElse) {
+                throw AssemblyError(".else without .if at line " + std::to_string(line), line,
+                                    static_cast<int>(blanks) + 1);
+            }
+            return true;
+        }
+    }
+}
+
+// First split point at or after `from`: just past a newline, but never
+// after a dangling '#' or '=' because those skip whitespace, including
+// line breaks, to reach their operand.
+static size_t nextChunkBoundary(const std::string& input, size_t from) {
+    const char* data = input.data();
+    const size_t size = input.length();
+    while (from < size) {
+        const void* found = std::memchr(data + from, '\n', size - from);
+        if (!found) {
+            return size;
+        }
+        size_t newline = static_cast<const char*>(found) - data;
+        size_t last = newline;
+        while (last > 0 && charscan::is(data[last - 1], charscan::SPACE)) {
+            last--;
+        }
+        if (last == 0 || (data[last - 1] != '#' && data[last - 1] != '=')) {
+            return newline + 1;
+        }
+        from = newline + 1;
+    }
+    return size;
+}
+
+std::vector<Token> Lexer::tokenizeParallel(const std::string& input, unsigned threadCount) {
+    std::vector<Token> tokens;
+    tokenizeParallel(input, threadCount, tokens);
     return tokens;
-}
\ No newline at end of file
+}
+
+void Lexer::tokenizeParallel(const std::string& input, unsigned threadCount,
+                             std::vector<Token>& tokens, const SymbolTable* predefined) {
+    const size_t size = input.length();
+    // Conditions depend on every define and .if above them, which a chunk
+    // lexer cannot see, so sources that use them are lexed serially.
+    if (threadCount <= 1 || size < MIN_PARALLEL_BYTES || input.find(".if") != std::string::npos) {
+        Lexer lexer(input.data(), size, 1);
+        if (predefined) {
+            lexer.defines = *predefined;
+        }
+        lexer.tokenizeInto(tokens);
+        return;
+    }
+
+    struct Chunk {
+        size_t begin;
+        size_t end;
+        int firstLine;
+        std::vector<Token> tokens;
+        size_t outputOffset;
+        std::exception_ptr error;
+    };
+
+    // qCore has no construct that spans a newline, so every chunk can start
+    // right after one with a fresh column count.
+    std::vector<Chunk> chunks;
+    const size_t target = std::max(MIN_CHUNK_BYTES, (size + threadCount - 1) / threadCount);
+    size_t begin = 0;
+    while (begin < size) {
+        size_t end = begin + target;
+        if (end >= size) {
+            end = size;
+        } else {
+            end = nextChunkBoundary(input, end);
+        }
+        chunks.push_back({begin, end, 1, {}, 0, nullptr});
+        begin = end;
+    }
+
+    auto runAll = [&chunks](void (*work)(const std::string&, Chunk&), const std::string& text) {
+        std::vector<std::thread> workers;
+        workers.reserve(chunks.size());
+        for (auto& chunk : chunks) {
+            workers.emplace_back([work, &text](Chunk* c) {
+                try {
+                    work(text, *c);
+                } catch (...) {
+                    c->error = std::current_exception();
+                }
+            }, &chunk);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    };
+
+    // Pass 1: newline counts give every chunk its starting line, so the
+    // tokens and any error message carry final line numbers right away.
+    runAll([](const std::string& text, Chunk& c) {
+        c.firstLine = static_cast<int>(std::count(text.data() + c.begin, text.data() + c.end, '\n'));
+    }, input);
+    int line = 1;
+    for (auto& chunk : chunks) {
+        const int newlines = chunk.firstLine;
+        chunk.firstLine = line;
+        line += newlines;
+    }
+
+    // Pass 2: lex. Each chunk's trailing END_OF_FILE is dropped below.
+    runAll([](const std::string& text, Chunk& c) {
+        Lexer lexer(text.data() + c.begin, c.end - c.begin, c.firstLine);
+        c.tokens = lexer.tokenize();
+    }, input);
+
+    size_t total = 1;
+    for (auto& chunk : chunks) {
+        if (chunk.error) {
+            std::rethrow_exception(chunk.error);
+        }
+        chunk.outputOffset = total - 1;
+        total += chunk.tokens.size() - 1;
+    }
+
+    // Pass 3: move every stream into its slot of the merged vector.
+    tokens.assign(total, chunks.back().tokens.back());
+    Token* output = tokens.data();
+    std::vector<std::thread> movers;
+    movers.reserve(chunks.size());
+    for (auto& chunk : chunks) {
+        movers.emplace_back([output](Chunk* c) {
+            std::move(c->tokens.begin(), c->tokens.end() - 1, output + c->outputOffset);
+            c->tokens.clear();
+        }, &chunk);
+    }
+    for (auto& mover : movers) {
+        mover.join();
+    }
+}
@@ -5,11 +5,16 @@
 
 #pragma once
 #include "common.h"
+#include "CharScan.h"
+#include "InstructionEncoder/SymbolTable.h"
 #include <string>
 #include <vector>
 #include <regex>
 #include <cctype>
 #include <stdexcept>
+#include <thread>
+#include <exception>
+#include <algorithm>
 
 enum class TokenType {
     INSTRUCTION,      
@@ -25,7 +30,8 @@ enum class TokenType {
     DIRECTIVE,       
     COMMENT,         
     END_OF_FILE,     
-    INVALID
+    INVALID,
+    STRING           // "..." without the quotes, for .incbin
 };
 
 struct Token {
@@ -33,17 +39,53 @@ struct Token {
     std::string value;
     int line;
     int column;
+    // Decoded value of numeric literals (NUMBER tokens and the numeric
+    // forms of NUMBER_IMMEDIATE/LABEL_IMMEDIATE), filled in by the lexer.
+    int64_t number = 0;
+    bool hasNumber = false;
 
     Token(TokenType t, std::string v, int l, int c) : type(t), value(std::move(v)), line(l), column(c) {}
 };
 
+enum class NumberStatus {
+    OK,
+    MALFORMED,
+    OUT_OF_RANGE
+};
+
+// Parses an optionally negative decimal, 0x hexadecimal or 0b binary
+// literal spanning exactly [begin, end). Does not allocate or throw.
+NumberStatus parseNumericLiteral(const char* begin, const char* end, int64_t& value);
+
 class Lexer {
 private:
     std::string input;
+    // Scanned range. Points into input, or into a caller-owned buffer for
+    // the chunk lexers created by tokenizeParallel().
+    const char* source;
+    size_t length;
     size_t position;
     int line;
     int column;
 
+    // Conditional assembly: defines seen so far (plus predefined ones) and
+    // the .if blocks enclosing the current position.
+    struct OpenCondition {
+        std::string directive;
+        int line;
+        int column;
+        bool inElse;
+    };
+    SymbolTable defines;
+    std::vector<OpenCondition> openConditions;
+
+    // Inputs below this size are lexed on the calling thread.
+    static constexpr size_t MIN_PARALLEL_BYTES = 1 << 20;
+    static constexpr size_t MIN_CHUNK_BYTES = 1 << 18;
+
+    Lexer(const char* data, size_t size, int firstLine)
+        : source(data), length(size), position(0), line(firstLine), column(1) {}
+
     const std::vector<std::string> instructions = {
         "mv", "b", "beq", "bne", "bcc", "bcs", "bpl", "bmi", "bl",
         "mvt", "add", "sub", "ld", "pop", "st", "push", "and", "xor",
@@ -54,17 +96,34 @@ private:
         return std::find(instructions.begin(), instructions.end(), str) != instructions.end();
     }
 
-    bool isIdentifierChar(char c) {
-        return std::isalnum(c) || c == '_' || c == '$';
-    }
-
     void skipWhitespace();
     Token parseIdentifier();
-    int64_t parseNumberValue(const std::string& str);
+    Token numberToken(TokenType type, size_t start, int start_column);
+    void tokenizeInto(std::vector<Token>& tokens);
+    void conditional(const Token& directive);
+    bool evaluateCondition(const Token& directive);
+    bool skipDisabled(const OpenCondition& block, bool stopAtElse);
 
 public:
-    Lexer(std::string input) : input(std::move(input)), position(0), line(1), column(1) {}
+    Lexer(std::string input)
+        : input(std::move(input)), source(this->input.data()), length(this->input.length()),
+          position(0), line(1), column(1) {}
+    // Lexes a fragment whose first line is firstLine of the whole source.
+    Lexer(std::string input, int firstLine)
+        : input(std::move(input)), source(this->input.data()), length(this->input.length()),
+          position(0), line(firstLine), column(1) {}
+    Lexer(const Lexer&) = delete;
+    Lexer& operator=(const Lexer&) = delete;
     
     Token nextToken();
     std::vector<Token> tokenize();
+
+    // Splits the input at newline boundaries, lexes the chunks on up to
+    // threadCount workers and concatenates the token streams. Tokens, line
+    // numbers and the first reported error match tokenize().
+    static std::vector<Token> tokenizeParallel(const std::string& input, unsigned threadCount);
+    // Same, but fills `tokens`, reusing its capacity when lexing serially.
+    // predefined seeds the defines seen by .if/.ifdef/.ifndef (-D).
+    static void tokenizeParallel(const std::string& input, unsigned threadCount,
+                                 std::vector<Token>& tokens, const SymbolTable* predefined = nullptr);
 };
\ No newline at end of file
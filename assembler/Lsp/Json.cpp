@@ -0,0 +1,304 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "Json.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+
+class JsonParser {
+private:
+    const std::string& input;
+    size_t position = 0;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error("JSON: " + message + " at offset " + std::to_string(position));
+    }
+
+    void skipWhitespace() {
+        while (position < input.size() &&
+               (input[position] == ' ' || input[position] == '\t' ||
+                input[position] == '\n' || input[position] == '\r')) {
+            position++;
+        }
+    }
+
+    bool consume(const char* literal) {
+        size_t length = 0;
+        while (literal[length]) length++;
+        if (input.compare(position, length, literal) != 0) return false;
+        position += length;
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    uint32_t parseHex4() {
+        if (position + 4 > input.size()) fail("truncated \\u escape");
+        uint32_t code = 0;
+        for (int i = 0; i < 4; i++) {
+            const char c = input[position++];
+            code <<= 4;
+            if (c >= '0' && c <= '9') code |= c - '0';
+            else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+            else fail("bad \\u escape");
+        }
+        return code;
+    }
+
+    std::string parseString() {
+        position++;   // opening quote
+        std::string out;
+        for (;;) {
+            if (position >= input.size()) fail("unterminated string");
+            const char c = input[position++];
+            if (c == '"') return out;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (position >= input.size()) fail("unterminated string");
+            const char escape = input[position++];
+            switch (escape) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t code = parseHex4();
+                if (code >= 0xD800 && code < 0xDC00 && consume("\\u")) {
+                    const uint32_t low = parseHex4();
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                fail("bad escape");
+            }
+        }
+    }
+
+public:
+    explicit JsonParser(const std::string& text) : input(text) {}
+
+    JsonValue parseValue(int depth) {
+        if (depth > 256) fail("nesting too deep");
+        skipWhitespace();
+        if (position >= input.size()) fail("unexpected end");
+        const char c = input[position];
+        if (c == '{') {
+            position++;
+            JsonValue object = JsonValue::object();
+            skipWhitespace();
+            if (position < input.size() && input[position] == '}') {
+                position++;
+                return object;
+            }
+            for (;;) {
+                skipWhitespace();
+                if (position >= input.size() || input[position] != '"') fail("expected member name");
+                std::string key = parseString();
+                skipWhitespace();
+                if (position >= input.size() || input[position] != ':') fail("expected ':'");
+                position++;
+                object.set(key, parseValue(depth + 1));
+                skipWhitespace();
+                if (position < input.size() && input[position] == ',') {
+                    position++;
+                } else if (position < input.size() && input[position] == '}') {
+                    position++;
+                    return object;
+                } else {
+                    fail("expected ',' or '}'");
+                }
+            }
+        }
+        if (c == '[') {
+            position++;
+            JsonValue array = JsonValue::array();
+            skipWhitespace();
+            if (position < input.size() && input[position] == ']') {
+                position++;
+                return array;
+            }
+            for (;;) {
+                array.push(parseValue(depth + 1));
+                skipWhitespace();
+                if (position < input.size() && input[position] == ',') {
+                    position++;
+                } else if (position < input.size() && input[position] == ']') {
+                    position++;
+                    return array;
+                } else {
+                    fail("expected ',' or ']'");
+                }
+            }
+        }
+        if (c == '"') return JsonValue(parseString());
+        if (consume("true")) return JsonValue(true);
+        if (consume("false")) return JsonValue(false);
+        if (consume("null")) return JsonValue();
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            const char* begin = input.c_str() + position;
+            char* end = nullptr;
+            const double value = std::strtod(begin, &end);
+            position += static_cast<size_t>(end - begin);
+            return JsonValue(value);
+        }
+        fail("unexpected character");
+    }
+
+    void finish() {
+        skipWhitespace();
+        if (position != input.size()) fail("trailing characters");
+    }
+};
+
+void serializeString(const std::string& text, std::string& out) {
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escape[8];
+                std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+                out += escape;
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+void serializeValue(const JsonValue& value, std::string& out);
+
+}
+
+JsonValue JsonValue::parse(const std::string& input) {
+    JsonParser parser(input);
+    JsonValue value = parser.parseValue(0);
+    parser.finish();
+    return value;
+}
+
+const std::string& JsonValue::asString() const {
+    static const std::string empty;
+    return type == Type::STRING ? text : empty;
+}
+
+JsonValue& JsonValue::push(JsonValue value) {
+    items.push_back(std::move(value));
+    return items.back();
+}
+
+const JsonValue& JsonValue::get(const std::string& key) const {
+    static const JsonValue null;
+    for (const auto& member : members) {
+        if (member.first == key) return member.second;
+    }
+    return null;
+}
+
+bool JsonValue::has(const std::string& key) const {
+    for (const auto& member : members) {
+        if (member.first == key) return true;
+    }
+    return false;
+}
+
+JsonValue& JsonValue::set(const std::string& key, JsonValue value) {
+    for (auto& member : members) {
+        if (member.first == key) {
+            member.second = std::move(value);
+            return member.second;
+        }
+    }
+    members.emplace_back(key, std::move(value));
+    return members.back().second;
+}
+
+namespace {
+
+void serializeValue(const JsonValue& value, std::string& out) {
+    switch (value.getType()) {
+    case JsonValue::Type::NUL:
+        out += "null";
+        break;
+    case JsonValue::Type::BOOLEAN:
+        out += value.asBool() ? "true" : "false";
+        break;
+    case JsonValue::Type::NUMBER: {
+        const double number = value.asNumber();
+        char buffer[32];
+        if (std::floor(number) == number && std::fabs(number) < 1e15) {
+            std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(number));
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "%.17g", number);
+        }
+        out += buffer;
+        break;
+    }
+    case JsonValue::Type::STRING:
+        serializeString(value.asString(), out);
+        break;
+    case JsonValue::Type::ARRAY:
+        out += '[';
+        for (size_t i = 0; i < value.size(); i++) {
+            if (i) out += ',';
+            serializeValue(value[i], out);
+        }
+        out += ']';
+        break;
+    case JsonValue::Type::OBJECT:
+        out += '{';
+        for (const auto& member : value.getMembers()) {
+            if (out.back() != '{') out += ',';
+            serializeString(member.first, out);
+            out += ':';
+            serializeValue(member.second, out);
+        }
+        out += '}';
+        break;
+    }
+}
+
+}
+
+std::string JsonValue::serialize() const {
+    std::string out;
+    serializeValue(*this, out);
+    return out;
+}
@@ -0,0 +1,65 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Minimal JSON value, parser and serializer for the language
+//              server. Objects keep their members in insertion order.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class JsonValue {
+public:
+    enum class Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+private:
+    Type type = Type::NUL;
+    bool boolean = false;
+    double number = 0;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+public:
+    JsonValue() = default;
+    JsonValue(bool value) : type(Type::BOOLEAN), boolean(value) {}
+    JsonValue(int value) : type(Type::NUMBER), number(value) {}
+    JsonValue(int64_t value) : type(Type::NUMBER), number(static_cast<double>(value)) {}
+    JsonValue(double value) : type(Type::NUMBER), number(value) {}
+    JsonValue(const char* value) : type(Type::STRING), text(value) {}
+    JsonValue(std::string value) : type(Type::STRING), text(std::move(value)) {}
+
+    static JsonValue array() { JsonValue v; v.type = Type::ARRAY; return v; }
+    static JsonValue object() { JsonValue v; v.type = Type::OBJECT; return v; }
+
+    // Throws std::runtime_error on malformed input.
+    static JsonValue parse(const std::string& input);
+    std::string serialize() const;
+
+    Type getType() const { return type; }
+    bool isNull() const { return type == Type::NUL; }
+    bool isNumber() const { return type == Type::NUMBER; }
+    bool isString() const { return type == Type::STRING; }
+    bool isArray() const { return type == Type::ARRAY; }
+    bool isObject() const { return type == Type::OBJECT; }
+
+    // Conversions return the fallback when the value has another type.
+    bool asBool(bool fallback = false) const { return type == Type::BOOLEAN ? boolean : fallback; }
+    int asInt(int fallback = 0) const { return type == Type::NUMBER ? static_cast<int>(number) : fallback; }
+    double asNumber(double fallback = 0) const { return type == Type::NUMBER ? number : fallback; }
+    const std::string& asString() const;
+
+    // Array access; size() is 0 for non-arrays.
+    size_t size() const { return items.size(); }
+    const JsonValue& operator[](size_t index) const { return items[index]; }
+    JsonValue& push(JsonValue value);
+
+    // Object access. get() returns a null value for missing members.
+    const JsonValue& get(const std::string& key) const;
+    bool has(const std::string& key) const;
+    JsonValue& set(const std::string& key, JsonValue value);
+    const std::vector<std::pair<std::string, JsonValue>>& getMembers() const { return members; }
+};
@@ -0,0 +1,399 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "LanguageServer.h"
+#include "Output/MifWriter.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// JSON-RPC error codes used below.
+const int PARSE_ERROR = -32700;
+const int INVALID_REQUEST = -32600;
+const int METHOD_NOT_FOUND = -32601;
+const int INTERNAL_ERROR = -32603;
+
+JsonValue position(int line, int character) {
+    JsonValue pos = JsonValue::object();
+    pos.set("line", line);
+    pos.set("character", character);
+    return pos;
+}
+
+JsonValue range(int line, int startCharacter, int endCharacter) {
+    JsonValue r = JsonValue::object();
+    r.set("start", position(line, startCharacter));
+    r.set("end", position(line, endCharacter));
+    return r;
+}
+
+// Byte offset of (line, character) in text, both 0-based; clamped to the
+// end of the line and of the text.
+size_t offsetOf(const std::string& text, int line, int character) {
+    size_t begin = 0;
+    for (int i = 0; i < line; i++) {
+        const size_t newline = text.find('\n', begin);
+        if (newline == std::string::npos) return text.size();
+        begin = newline + 1;
+    }
+    size_t end = text.find('\n', begin);
+    if (end == std::string::npos) end = text.size();
+    return std::min(begin + static_cast<size_t>(std::max(character, 0)), end);
+}
+
+std::string hex(int value, int digits) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "0x%0*x", digits, value);
+    return buffer;
+}
+
+}
+
+std::string pathFromUri(const std::string& uri) {
+    const std::string scheme = "file://";
+    if (uri.compare(0, scheme.size(), scheme) != 0) {
+        return uri;
+    }
+    std::string path;
+    for (size_t i = scheme.size(); i < uri.size(); i++) {
+        if (uri[i] == '%' && i + 2 < uri.size()) {
+            path += static_cast<char>(std::strtol(uri.substr(i + 1, 2).c_str(), nullptr, 16));
+            i += 2;
+        } else {
+            path += uri[i];
+        }
+    }
+    // Windows drive paths arrive as /C:/...
+    if (path.size() > 2 && path[0] == '/' && path[2] == ':') {
+        path.erase(0, 1);
+    }
+    return path;
+}
+
+bool LanguageServer::readMessage(std::string& body) {
+    size_t length = 0;
+    bool haveLength = false;
+    std::string header;
+    while (std::getline(in, header)) {
+        if (!header.empty() && header.back() == '\r') header.pop_back();
+        if (header.empty()) {
+            if (haveLength) break;
+            continue;
+        }
+        const std::string field = "Content-Length:";
+        if (header.compare(0, field.size(), field) == 0) {
+            length = static_cast<size_t>(std::strtoul(header.c_str() + field.size(), nullptr, 10));
+            haveLength = true;
+        }
+    }
+    if (!haveLength || !in) {
+        return false;
+    }
+    body.resize(length);
+    in.read(&body[0], static_cast<std::streamsize>(length));
+    return static_cast<size_t>(in.gcount()) == length;
+}
+
+void LanguageServer::send(const JsonValue& message) {
+    const std::string body = message.serialize();
+    out << "Content-Length: " << body.size() << "\r\n\r\n" << body;
+    out.flush();
+}
+
+void LanguageServer::respond(const JsonValue& id, JsonValue result) {
+    JsonValue response = JsonValue::object();
+    response.set("jsonrpc", "2.0");
+    response.set("id", id);
+    response.set("result", std::move(result));
+    send(response);
+}
+
+void LanguageServer::respondError(const JsonValue& id, int code, const std::string& message) {
+    JsonValue error = JsonValue::object();
+    error.set("code", code);
+    error.set("message", message);
+    JsonValue response = JsonValue::object();
+    response.set("jsonrpc", "2.0");
+    response.set("id", id);
+    response.set("error", std::move(error));
+    send(response);
+}
+
+void LanguageServer::assembleAndPublish(const std::string& uri, Document& document) {
+    const AssembleResult& result = document.assembler->update(document.text, document.options);
+
+    JsonValue diagnostics = JsonValue::array();
+    for (const Diagnostic& d : result.diagnostics) {
+        const int line = d.line > 0 ? d.line - 1 : 0;
+        const int start = d.column > 0 ? d.column - 1 : 0;
+        // Underline the word the error points at, or the rest of the line.
+        const size_t lineBegin = offsetOf(document.text, line, 0);
+        const size_t lineEnd = offsetOf(document.text, line, 1 << 30);
+        size_t end = std::min(lineBegin + start, lineEnd);
+        while (end < lineEnd && std::string(" \t,[]").find(document.text[end]) == std::string::npos) {
+            end++;
+        }
+        if (end == lineBegin + start) end = lineEnd;
+
+        JsonValue diagnostic = JsonValue::object();
+        diagnostic.set("range", range(line, start, static_cast<int>(end - lineBegin)));
+        diagnostic.set("severity", 1);
+        diagnostic.set("source", "sbasmCpp");
+        diagnostic.set("message", d.message);
+        diagnostics.push(std::move(diagnostic));
+    }
+
+    JsonValue params = JsonValue::object();
+    params.set("uri", uri);
+    params.set("diagnostics", std::move(diagnostics));
+    JsonValue notification = JsonValue::object();
+    notification.set("jsonrpc", "2.0");
+    notification.set("method", "textDocument/publishDiagnostics");
+    notification.set("params", std::move(params));
+    send(notification);
+}
+
+void LanguageServer::applyChange(std::string& text, const JsonValue& change) {
+    if (!change.has("range")) {
+        text = change.get("text").asString();
+        return;
+    }
+    const JsonValue& r = change.get("range");
+    const size_t begin = offsetOf(text, r.get("start").get("line").asInt(),
+                                  r.get("start").get("character").asInt());
+    const size_t end = offsetOf(text, r.get("end").get("line").asInt(),
+                                r.get("end").get("character").asInt());
+    text.replace(begin, end > begin ? end - begin : 0, change.get("text").asString());
+}
+
+JsonValue LanguageServer::location(const std::string& uri, int line, int column, int length) const {
+    JsonValue loc = JsonValue::object();
+    loc.set("uri", uri);
+    loc.set("range", range(line - 1, column - 1, column - 1 + length));
+    return loc;
+}
+
+const LanguageServer::Document* LanguageServer::symbolAt(const JsonValue& params, std::string& name,
+                                                         int& line, NameToken& token) {
+    auto doc = documents.find(params.get("textDocument").get("uri").asString());
+    if (doc == documents.end()) {
+        return nullptr;
+    }
+    const IncrementalAssembler& assembler = *doc->second.assembler;
+    line = params.get("position").get("line").asInt() + 1;
+    const int character = params.get("position").get("character").asInt();
+    const std::string* text = assembler.lineText(line);
+    const std::vector<Token>* tokens = assembler.lineTokens(line);
+    if (!text || !tokens) {
+        return nullptr;
+    }
+    std::vector<NameToken> names;
+    SymbolIndex::namesOnLine(*text, *tokens, names);
+    for (const NameToken& candidate : names) {
+        if (character >= candidate.column - 1 && character <= candidate.column - 1 + candidate.length) {
+            name = candidate.name;
+            token = candidate;
+            return &doc->second;
+        }
+    }
+    return nullptr;
+}
+
+JsonValue LanguageServer::definition(const JsonValue& params) {
+    std::string name;
+    int line = 0;
+    NameToken token;
+    const Document* document = symbolAt(params, name, line, token);
+    if (!document) {
+        return JsonValue();
+    }
+    const std::string& uri = params.get("textDocument").get("uri").asString();
+    JsonValue locations = JsonValue::array();
+    for (const SymbolReference& ref : document->assembler->getSymbolIndex().find(name)) {
+        const int refLine = document->assembler->lineNumber(ref.lineId);
+        if (ref.definition && refLine > 0) {
+            locations.push(location(uri, refLine, ref.column, ref.length));
+        }
+    }
+    return locations.size() ? locations : JsonValue();
+}
+
+JsonValue LanguageServer::references(const JsonValue& params) {
+    std::string name;
+    int line = 0;
+    NameToken token;
+    const Document* document = symbolAt(params, name, line, token);
+    JsonValue locations = JsonValue::array();
+    if (!document) {
+        return locations;
+    }
+    const std::string& uri = params.get("textDocument").get("uri").asString();
+    const bool includeDeclaration = params.get("context").get("includeDeclaration").asBool(true);
+    for (const SymbolReference& ref : document->assembler->getSymbolIndex().find(name)) {
+        const int refLine = document->assembler->lineNumber(ref.lineId);
+        if (refLine > 0 && (includeDeclaration || !ref.definition)) {
+            locations.push(location(uri, refLine, ref.column, ref.length));
+        }
+    }
+    return locations;
+}
+
+JsonValue LanguageServer::hover(const JsonValue& params) {
+    auto doc = documents.find(params.get("textDocument").get("uri").asString());
+    if (doc == documents.end()) {
+        return JsonValue();
+    }
+    const IncrementalAssembler& assembler = *doc->second.assembler;
+    std::ostringstream text;
+
+    std::string name;
+    int line = params.get("position").get("line").asInt() + 1;
+    NameToken token = {"", 0, 0, false};
+    const bool onSymbol = symbolAt(params, name, line, token) != nullptr;
+    if (onSymbol) {
+        const SymbolTable& symbols = assembler.getSymbolTable();
+        if (symbols.hasLabel(name)) {
+            text << "label `" << name << "` at address `" << hex(symbols.getLabelAddress(name), 4) << "`";
+        } else if (symbols.hasDefine(name)) {
+            const int value = symbols.getDefineValue(name);
+            text << "`.define " << name << "` = " << value << " (`" << hex(value & 0xFFFF, 4) << "`)";
+        } else {
+            text << "`" << name << "` is not defined";
+        }
+        for (const SymbolReference& ref : assembler.getSymbolIndex().find(name)) {
+            if (ref.definition && assembler.lineNumber(ref.lineId) > 0) {
+                text << ", line " << assembler.lineNumber(ref.lineId);
+            }
+        }
+        text << "\n";
+    }
+
+    int address = 0;
+    std::vector<uint16_t> words;
+    if (assembler.lineEncoding(line, address, words)) {
+        bool data = false;
+        for (const Token& t : *assembler.lineTokens(line)) {
+            data |= t.type == TokenType::DIRECTIVE;
+        }
+        text << (onSymbol ? "\n" : "") << "```\n";
+        for (size_t i = 0; i < words.size(); i++) {
+            text << hex(address + static_cast<int>(i), 4) << "  " << hex(words[i], 4).substr(2);
+            if (!data) text << "  " << disassembleWord(words[i], address + i);
+            text << "\n";
+        }
+        text << "```\n";
+    }
+
+    if (text.tellp() == 0) {
+        return JsonValue();
+    }
+    JsonValue contents = JsonValue::object();
+    contents.set("kind", "markdown");
+    contents.set("value", text.str());
+    JsonValue result = JsonValue::object();
+    result.set("contents", std::move(contents));
+    if (onSymbol) {
+        result.set("range", range(line - 1, token.column - 1, token.column - 1 + token.length));
+    }
+    return result;
+}
+
+void LanguageServer::handleMessage(const JsonValue& message) {
+    const std::string& method = message.get("method").asString();
+    const JsonValue& id = message.get("id");
+    const bool isRequest = message.has("id");
+    const JsonValue& params = message.get("params");
+    if (method.empty()) {
+        return;   // a response; the server sends no requests
+    }
+
+    try {
+        if (method == "exit") {
+            exitRequested = true;
+        } else if (shutdownRequested) {
+            if (isRequest) respondError(id, INVALID_REQUEST, "Server is shutting down");
+        } else if (method == "initialize") {
+            JsonValue sync = JsonValue::object();
+            sync.set("openClose", true);
+            sync.set("change", 2);   // incremental
+            JsonValue capabilities = JsonValue::object();
+            capabilities.set("textDocumentSync", std::move(sync));
+            capabilities.set("definitionProvider", true);
+            capabilities.set("referencesProvider", true);
+            capabilities.set("hoverProvider", true);
+            JsonValue info = JsonValue::object();
+            info.set("name", "sbasmCpp");
+            JsonValue result = JsonValue::object();
+            result.set("capabilities", std::move(capabilities));
+            result.set("serverInfo", std::move(info));
+            respond(id, std::move(result));
+        } else if (method == "shutdown") {
+            shutdownRequested = true;
+            respond(id, JsonValue());
+        } else if (method == "textDocument/didOpen") {
+            const JsonValue& item = params.get("textDocument");
+            const std::string& uri = item.get("uri").asString();
+            Document& document = documents[uri];
+            document.text = item.get("text").asString();
+            const std::string path = pathFromUri(uri);
+            const size_t slash = path.find_last_of("/\\");
+            if (slash != std::string::npos) {
+                document.options.includeDirectory = path.substr(0, std::max<size_t>(slash, 1));
+            }
+            document.assembler.reset(new IncrementalAssembler(true));
+            assembleAndPublish(uri, document);
+        } else if (method == "textDocument/didChange") {
+            const std::string& uri = params.get("textDocument").get("uri").asString();
+            auto doc = documents.find(uri);
+            if (doc != documents.end()) {
+                const JsonValue& changes = params.get("contentChanges");
+                for (size_t i = 0; i < changes.size(); i++) {
+                    applyChange(doc->second.text, changes[i]);
+                }
+                assembleAndPublish(uri, doc->second);
+            }
+        } else if (method == "textDocument/didClose") {
+            const std::string& uri = params.get("textDocument").get("uri").asString();
+            documents.erase(uri);
+            JsonValue clear = JsonValue::object();
+            clear.set("uri", uri);
+            clear.set("diagnostics", JsonValue::array());
+            JsonValue notification = JsonValue::object();
+            notification.set("jsonrpc", "2.0");
+            notification.set("method", "textDocument/publishDiagnostics");
+            notification.set("params", std::move(clear));
+            send(notification);
+        } else if (method == "textDocument/definition") {
+            respond(id, definition(params));
+        } else if (method == "textDocument/references") {
+            respond(id, references(params));
+        } else if (method == "textDocument/hover") {
+            respond(id, hover(params));
+        } else if (isRequest) {
+            respondError(id, METHOD_NOT_FOUND, "Unhandled method " + method);
+        }
+    } catch (const std::exception& e) {
+        if (isRequest) respondError(id, INTERNAL_ERROR, e.what());
+    }
+}
+
+int LanguageServer::run() {
+    std::string body;
+    while (!exitRequested && readMessage(body)) {
+        JsonValue message;
+        try {
+            message = JsonValue::parse(body);
+        } catch (const std::exception& e) {
+            respondError(JsonValue(), PARSE_ERROR, e.what());
+            continue;
+        }
+        handleMessage(message);
+    }
+    return shutdownRequested ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Language Server Protocol over stdio (sbasmCpp --lsp). Each
+//              open document is kept in an IncrementalAssembler with a
+//              symbol index, so an edit re-lexes only the changed lines.
+//              Supports incremental document sync, diagnostics, go to
+//              definition, find references and hover (symbol value, address
+//              and encoded words). Positions are counted in bytes, which
+//              matches the protocol's UTF-16 columns for ASCII sources.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "Json.h"
+#include "Assembler/IncrementalAssembler.h"
+#include <istream>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+
+class LanguageServer {
+private:
+    struct Document {
+        std::string text;
+        AssembleOptions options;
+        std::unique_ptr<IncrementalAssembler> assembler;
+    };
+
+    std::istream& in;
+    std::ostream& out;
+    std::map<std::string, Document> documents;
+    bool shutdownRequested = false;
+    bool exitRequested = false;
+
+    bool readMessage(std::string& body);
+    void send(const JsonValue& message);
+    void respond(const JsonValue& id, JsonValue result);
+    void respondError(const JsonValue& id, int code, const std::string& message);
+
+    void assembleAndPublish(const std::string& uri, Document& document);
+    void applyChange(std::string& text, const JsonValue& change);
+    JsonValue definition(const JsonValue& params);
+    JsonValue references(const JsonValue& params);
+    JsonValue hover(const JsonValue& params);
+    // Name under the cursor of params.position, or nullptr when there is none.
+    const Document* symbolAt(const JsonValue& params, std::string& name, int& line, NameToken& token);
+    JsonValue location(const std::string& uri, int line, int column, int length) const;
+
+public:
+    LanguageServer(std::istream& in, std::ostream& out) : in(in), out(out) {}
+
+    // Serves requests until "exit" or the end of the input; returns the
+    // process exit code (0 only when "shutdown" came before "exit").
+    int run();
+    // Handles one decoded request or notification.
+    void handleMessage(const JsonValue& message);
+};
+
+// file:///home/a%20b/x.s -> /home/a b/x.s (file:///C:/x.s -> C:/x.s)
+std::string pathFromUri(const std::string& uri);
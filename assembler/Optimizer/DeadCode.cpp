@@ -0,0 +1,140 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "DeadCode.h"
+#include "Analysis/ControlFlow.h"
+#include "InstructionEncoder/InstructionEncoder.h"
+#include <set>
+#include <sstream>
+
+static bool isDirective(const Statement* stmt, const char* name) {
+    return stmt->type == StatementType::DIRECTIVE && static_cast<const Directive*>(stmt)->name == name;
+}
+
+// Statements that make up data objects: words and reserved space.
+static bool isWord(const Statement* stmt) {
+    return isDirective(stmt, ".word") || isDirective(stmt, ".fill") || isDirective(stmt, ".space") ||
+           isDirective(stmt, ".incbin");
+}
+
+EliminationReport eliminateDeadCode(std::vector<std::unique_ptr<Statement>>& ast,
+                                    const std::vector<int>& addresses,
+                                    const std::vector<uint16_t>& words,
+                                    const std::vector<bool>& isData) {
+    EliminationReport report;
+    ControlFlowGraph cfg;
+    cfg.build(words, isData);
+
+    const size_t count = ast.size();
+    std::vector<char> keep(count, 1);
+
+    for (size_t i = 0; i < count; i++) {
+        if (ast[i]->type == StatementType::INSTRUCTION && cfg.blockAt(addresses[i]) < 0) {
+            keep[i] = 0;
+        }
+    }
+
+    // Names the surviving code uses: branch targets and =/# symbols.
+    std::set<std::string> referenced;
+    for (size_t i = 0; i < count; i++) {
+        if (!keep[i] || ast[i]->type != StatementType::INSTRUCTION) continue;
+        auto instr = static_cast<const Instruction*>(ast[i].get());
+        if (instr->opcode[0] == 'b') {
+            referenced.insert(instr->operand1);
+        } else if (instr->isImmediate && !instr->hasNumber) {
+            referenced.insert(instr->operand2);
+        }
+    }
+
+    // Labels go with the statement they name: the next instruction or
+    // .word after them (.define emits nothing and is always kept).
+    for (size_t i = 0; i < count; ) {
+        if (ast[i]->type == StatementType::INSTRUCTION) {
+            i++;
+            continue;
+        }
+
+        // Each data label starts an object that owns the .words up to the
+        // next label; .words before the first label stay (nothing names them).
+        size_t end = i;
+        std::vector<size_t> object;
+        bool used = true;
+        auto finishObject = [&]() {
+            if (!used) {
+                for (size_t j : object) keep[j] = 0;
+            }
+            object.clear();
+        };
+        while (end < count && ast[end]->type != StatementType::INSTRUCTION) {
+            if (ast[end]->type == StatementType::LABEL) {
+                // Labels after the last .word belong to the next instruction.
+                size_t next = end;
+                while (next < count && ast[next]->type == StatementType::LABEL) next++;
+                while (next < count && isDirective(ast[next].get(), ".define")) next++;
+                if (next == count || !isWord(ast[next].get())) break;
+
+                if (end == 0 || ast[end - 1]->type != StatementType::LABEL) {
+                    finishObject();
+                    used = false;
+                }
+                used |= referenced.count(static_cast<const Label*>(ast[end].get())->name) > 0;
+                object.push_back(end);
+            } else if (isWord(ast[end].get())) {
+                object.push_back(end);
+            } else if (isDirective(ast[end].get(), ".org")) {
+                // Nothing owns the words placed after an .org until a label.
+                finishObject();
+                used = true;
+            }
+            end++;
+        }
+        finishObject();
+
+        // Code labels in front of the next instruction share its fate.
+        size_t next = end;
+        while (next < count && ast[next]->type != StatementType::INSTRUCTION) next++;
+        if (next < count && !keep[next]) {
+            for (size_t j = end; j < next; j++) {
+                if (ast[j]->type != StatementType::LABEL) continue;
+                const std::string& name = static_cast<const Label*>(ast[j].get())->name;
+                if (referenced.count(name)) {
+                    throw AssemblyError("The address of unreachable code at label '" + name +
+                                        "' is used, so it cannot be removed", ast[j]->line, ast[j]->column);
+                }
+                keep[j] = 0;
+            }
+        }
+        i = next;
+    }
+
+    // Report contiguous removed ranges, then drop them.
+    RemovedRange* open = nullptr;
+    for (size_t i = 0; i < count; i++) {
+        const int size = Encoder::nextAddress(ast[i].get(), addresses[i]) - addresses[i];
+        if (keep[i]) {
+            if (!isDirective(ast[i].get(), ".define")) open = nullptr;
+            continue;
+        }
+        if (!open) {
+            std::ostringstream address;
+            address << "0x" << std::hex << addresses[i];
+            report.removed.push_back({address.str(), ast[i]->line, 0, false});
+            open = &report.removed.back();
+            if (ast[i]->type == StatementType::LABEL) {
+                open->name = static_cast<const Label*>(ast[i].get())->name;
+            }
+        }
+        open->isData |= isWord(ast[i].get());
+        open->words += size;
+        report.wordsSaved += size;
+    }
+
+    size_t out = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (keep[i]) ast[out++] = std::move(ast[i]);
+    }
+    ast.resize(out);
+    return report;
+}
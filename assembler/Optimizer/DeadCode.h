@@ -0,0 +1,40 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Removes instructions the CFG cannot reach from address 0 and
+//              .word tables whose labels no remaining instruction uses. The
+//              caller lays out and encodes the surviving statements again.
+//
+//              Each data label (or group of adjacent labels) owns the .word,
+//              .fill, .incbin and .space statements up to the next label or
+//              .org and is dropped with them when no remaining instruction
+//              names it. Data in front of the first label of a block has no
+//              name and is kept.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "Parser/Parser.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+struct RemovedRange {
+    std::string name;   // first label in the range, or its address
+    int line;
+    int words;
+    bool isData;
+};
+
+struct EliminationReport {
+    std::vector<RemovedRange> removed;
+    int wordsSaved = 0;
+};
+
+// addresses holds the start address of every statement of ast (see
+// layoutStatements), words and isData the image encoded from it, indexed
+// by address (see expandSegments). Throws
+// std::runtime_error when reachability cannot be decided.
+EliminationReport eliminateDeadCode(std::vector<std::unique_ptr<Statement>>& ast,
+                                    const std::vector<int>& addresses,
+                                    const std::vector<uint16_t>& words,
+                                    const std::vector<bool>& isData);
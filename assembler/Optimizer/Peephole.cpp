@@ -0,0 +1,212 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "Peephole.h"
+#include "InstructionEncoder/InstructionEncoder.h"
+#include <set>
+#include <unordered_map>
+
+namespace {
+struct Pass {
+    std::vector<std::unique_ptr<Statement>>& ast;
+    std::vector<int> addresses;
+    std::unordered_map<std::string, int> labels;     // name -> address
+    std::unordered_map<std::string, size_t> targets; // name -> statement after the label
+    std::vector<char> removed;
+
+    explicit Pass(std::vector<std::unique_ptr<Statement>>& ast) : ast(ast) {}
+
+    void layout() {
+        addresses.assign(ast.size(), 0);
+        labels.clear();
+        targets.clear();
+        removed.assign(ast.size(), 0);
+        int address = 0;
+        std::vector<std::string> pending;
+        for (size_t i = 0; i < ast.size(); i++) {
+            addresses[i] = address;
+            if (ast[i]->type == StatementType::LABEL) {
+                const std::string& name = static_cast<Label*>(ast[i].get())->name;
+                labels.emplace(name, address);
+                pending.push_back(name);
+                continue;
+            }
+            const int next = Encoder::nextAddress(ast[i].get(), address);
+            if (Encoder::wordCount(ast[i].get()) > 0) {
+                for (const auto& name : pending) targets.emplace(name, i);
+                pending.clear();
+            } else if (next != address) {
+                pending.clear();    // .org/.space: the label is not on what follows
+            }
+            address = next;
+        }
+    }
+
+    Instruction* instruction(size_t i) const {
+        if (i >= ast.size() || removed[i] || ast[i]->type != StatementType::INSTRUCTION) return nullptr;
+        return static_cast<Instruction*>(ast[i].get());
+    }
+};
+
+int registerNumber(const std::string& name) {
+    if (name == "sp") return 5;
+    if (name == "lr") return 6;
+    if (name == "pc") return 7;
+    if (name.size() == 2 && name[0] == 'r' && name[1] >= '0' && name[1] <= '7') return name[1] - '0';
+    return -1;
+}
+
+// Directives that neither emit words nor move the address.
+bool isDefine(const Statement* stmt) {
+    return stmt->type == StatementType::DIRECTIVE && static_cast<const Directive*>(stmt)->name == ".define";
+}
+
+bool isBranch(const Instruction* instr) {
+    return instr->opcode[0] == 'b';
+}
+
+bool writesFlags(const Instruction* instr) {
+    static const std::set<std::string> writers = {
+        "add", "sub", "and", "xor", "lsl", "lsr", "asr", "ror", "cmp"
+    };
+    return writers.count(instr->opcode) > 0;
+}
+
+// Whether the flags set by statement i may be read before they are set
+// again. Anything that leaves straight-line code counts as a read.
+bool flagsLiveAfter(const Pass& pass, size_t i) {
+    for (size_t j = i + 1; j < pass.ast.size(); j++) {
+        if (pass.removed[j]) continue;
+        const Statement* stmt = pass.ast[j].get();
+        if (stmt->type == StatementType::LABEL) continue;
+        if (stmt->type == StatementType::DIRECTIVE) {
+            if (!isDefine(stmt)) return true;
+            continue;
+        }
+        auto instr = static_cast<const Instruction*>(stmt);
+        if (isBranch(instr)) return true;
+        if (instr->opcode != "cmp" && registerNumber(instr->operand1) == 7) return true;
+        if (writesFlags(instr)) return false;
+    }
+    return true;
+}
+
+bool removeAddZero(Pass& pass, size_t i) {
+    Instruction* instr = pass.instruction(i);
+    if (!instr || (instr->opcode != "add" && instr->opcode != "sub")) return false;
+    if (!instr->isImmediate || instr->isLabelImmediate || !instr->hasNumber || instr->number != 0) return false;
+    if (registerNumber(instr->operand1) == 7 || flagsLiveAfter(pass, i)) return false;
+    pass.removed[i] = 1;
+    return true;
+}
+
+bool removeSelfMove(Pass& pass, size_t i) {
+    Instruction* instr = pass.instruction(i);
+    if (!instr || instr->opcode != "mv" || instr->isImmediate) return false;
+    int rX = registerNumber(instr->operand1);
+    if (rX < 0 || rX != registerNumber(instr->operand2)) return false;
+    pass.removed[i] = 1;
+    return true;
+}
+
+bool removeBranchToNext(Pass& pass, size_t i) {
+    Instruction* instr = pass.instruction(i);
+    if (!instr || !isBranch(instr) || instr->opcode == "bl") return false;
+    auto target = pass.labels.find(instr->operand1);
+    if (target == pass.labels.end() || target->second != pass.addresses[i] + 1) return false;
+    pass.removed[i] = 1;
+    return true;
+}
+
+bool threadBranch(Pass& pass, size_t i) {
+    Instruction* instr = pass.instruction(i);
+    if (!instr || !isBranch(instr)) return false;
+
+    // Follow L: b M chains, remembering every label on the way.
+    std::vector<std::string> chain = {instr->operand1};
+    std::set<std::string> seen = {instr->operand1};
+    for (;;) {
+        auto next = pass.targets.find(chain.back());
+        if (next == pass.targets.end()) break;
+        Instruction* hop = pass.instruction(next->second);
+        if (!hop || hop->opcode != "b" || seen.count(hop->operand1)) break;
+        chain.push_back(hop->operand1);
+        seen.insert(hop->operand1);
+    }
+
+    // Take the furthest label that is still in range of this branch.
+    for (size_t k = chain.size() - 1; k > 0; k--) {
+        auto address = pass.labels.find(chain[k]);
+        if (address == pass.labels.end()) continue;
+        const int offset = address->second - (pass.addresses[i] + 1);
+        if (offset >= -256 && offset <= 255) {
+            instr->operand1 = chain[k];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool removePushPop(Pass& pass, size_t i) {
+    Instruction* push = pass.instruction(i);
+    if (!push || push->opcode != "push") return false;
+    size_t j = i + 1;
+    while (j < pass.ast.size() && (pass.removed[j] || isDefine(pass.ast[j].get()))) {
+        j++;
+    }
+    Instruction* pop = pass.instruction(j);
+    if (!pop || pop->opcode != "pop" || registerNumber(pop->operand1) != registerNumber(push->operand1)) {
+        return false;
+    }
+    pass.removed[i] = 1;
+    pass.removed[j] = 1;
+    return true;
+}
+
+struct Rule {
+    const char* name;
+    bool (*apply)(Pass&, size_t);
+};
+
+const Rule RULES[] = {
+    {"add/sub #0 with dead flags", removeAddZero},
+    {"mv rX, rX", removeSelfMove},
+    {"branch to next word", removeBranchToNext},
+    {"branch threading", threadBranch},
+    {"push/pop pair", removePushPop},
+};
+}
+
+PeepholeReport optimizeStatements(std::vector<std::unique_ptr<Statement>>& ast) {
+    PeepholeReport report;
+    for (const auto& rule : RULES) {
+        report.rules.push_back({rule.name, 0});
+    }
+
+    Pass pass(ast);
+    for (bool changed = true; changed; ) {
+        changed = false;
+        pass.layout();
+        for (size_t i = 0; i < ast.size(); i++) {
+            for (size_t r = 0; r < sizeof(RULES) / sizeof(RULES[0]); r++) {
+                if (!pass.removed[i] && RULES[r].apply(pass, i)) {
+                    report.rules[r].applied++;
+                    changed = true;
+                }
+            }
+        }
+
+        size_t out = 0;
+        for (size_t i = 0; i < ast.size(); i++) {
+            if (pass.removed[i]) {
+                report.wordsSaved += Encoder::wordCount(ast[i].get());
+            } else {
+                ast[out++] = std::move(ast[i]);
+            }
+        }
+        ast.resize(out);
+    }
+    return report;
+}
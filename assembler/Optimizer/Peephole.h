@@ -0,0 +1,33 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Peephole pass over the statement list (-O). Applies a table
+//              of rewrites until none fires:
+//                add/sub rX, #0        removed when no flag reader follows
+//                                      before the flags are set again
+//                mv rX, rX             removed (mv does not touch flags)
+//                b<cond> NEXT          removed when NEXT is the next word
+//                b<cond> L, L: b M     retargeted to M (chains followed),
+//                                      kept when M is out of branch range
+//                push rX / pop rX      adjacent pair with no label between
+//              Flag liveness is decided by scanning forward in source order
+//              and is conservative: any branch, call, return, write to pc
+//              or data ends the scan with the flags considered live.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "Parser/Parser.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+struct PeepholeReport {
+    struct RuleCount {
+        std::string rule;
+        int applied;
+    };
+    std::vector<RuleCount> rules;   // one entry per rule, table order
+    int wordsSaved = 0;
+};
+
+PeepholeReport optimizeStatements(std::vector<std::unique_ptr<Statement>>& ast);
@@ -0,0 +1,81 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "FileUpdate.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+bool hasContents(const std::string& path, const std::string& contents) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return false;
+    }
+    // A size mismatch settles it without reading the file.
+    if (static_cast<std::streamoff>(in.tellg()) != static_cast<std::streamoff>(contents.size())) {
+        return false;
+    }
+    in.seekg(0);
+
+    char buffer[1 << 14];
+    size_t offset = 0;
+    while (offset < contents.size()) {
+        in.read(buffer, sizeof(buffer));
+        const size_t count = static_cast<size_t>(in.gcount());
+        if (count == 0 || contents.compare(offset, count, buffer, count) != 0) {
+            return false;
+        }
+        offset += count;
+    }
+    return true;
+}
+
+void replaceFile(const std::string& from, const std::string& to) {
+#if defined(_WIN32)
+    const bool moved = MoveFileExA(from.c_str(), to.c_str(),
+                                   MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    const bool moved = std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+    if (!moved) {
+        std::remove(from.c_str());
+        throw std::runtime_error("Could not replace output file: " + to);
+    }
+}
+
+}
+
+bool writeFileIfChanged(const std::string& path, const std::string& contents) {
+    if (hasContents(path, contents)) {
+        return false;
+    }
+
+    // Same directory as the target, so the rename never crosses filesystems.
+    const std::string temporary = path + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Could not open output file: " + path);
+        }
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        out.close();
+        if (out.fail()) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Could not write output file: " + path);
+        }
+    }
+    replaceFile(temporary, path);
+    return true;
+}
@@ -0,0 +1,16 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Replaces output files only when their contents change, and
+//              then atomically: the new contents go to a temporary file in
+//              the same directory which is renamed over the old one, so
+//              readers see either the complete old or the complete new file
+//              and an unchanged output keeps its modification time.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include <string>
+
+// Returns false (and leaves the file alone) when path already holds exactly
+// contents. Throws std::runtime_error when the file cannot be written.
+bool writeFileIfChanged(const std::string& path, const std::string& contents);
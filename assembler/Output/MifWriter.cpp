@@ -0,0 +1,215 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "MifWriter.h"
+#include "FileUpdate.h"
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+std::string disassembleWord(uint16_t instr, size_t i) {
+    const char* regNames[] = {"r0", "r1", "r2", "r3", "r4", "sp", "lr", "pc"};
+    const char* conditions[] = {"b   ", "beq ", "bne ", "bcc ", "bcs ", "bpl ", "bmi ", "bl  "};
+
+    uint16_t opcode = (instr >> 13) & 0x7;
+    uint16_t imm = (instr >> 12) & 0x1;
+    uint16_t rX = (instr >> 9) & 0x7;
+    uint16_t rY = instr & 0x7;
+    uint16_t immediate = instr & 0x1FF;
+
+    std::ostringstream oss;
+    switch (opcode) {
+        case 0:
+            if (imm) {
+                oss << "mv   " << regNames[rX] << ", #0x" << std::hex << immediate;
+            } else {
+                oss << "mv   " << regNames[rX] << ", " << regNames[rY];
+            }
+            break;
+
+        case 1:
+            if (imm) {
+                oss << "mvt  " << regNames[rX] << ", #0x" << std::hex << (immediate & 0xFF);
+            } else {
+                uint16_t cond = (instr >> 9) & 0x7;
+                int16_t offset = immediate;
+                if (offset & 0x100) {
+                    offset |= 0xFF00;
+                }
+                int target = i + 1 + offset;
+                oss << conditions[cond] << "0x" << std::hex << target;
+            }
+            break;
+
+        case 2:
+            if (imm) {
+                oss << "add  " << regNames[rX] << ", #0x" << std::hex << immediate;
+            } else {
+                oss << "add  " << regNames[rX] << ", " << regNames[rY];
+            }
+            break;
+
+        case 3:
+            if (imm) {
+                oss << "sub  " << regNames[rX] << ", #0x" << std::hex << immediate;
+            } else {
+                oss << "sub  " << regNames[rX] << ", " << regNames[rY];
+            }
+            break;
+
+        case 4:
+            if (imm) {
+                oss << "pop  " << regNames[rX];
+            } else {
+                oss << "ld   " << regNames[rX] << ", [" << regNames[rY] << "]";
+            }
+            break;
+
+        case 5:
+            if (imm) {
+                oss << "push " << regNames[rX];
+            } else {
+                oss << "st   " << regNames[rX] << ", [" << regNames[rY] << "]";
+            }
+            break;
+
+        case 6:
+            if (imm) {
+                oss << "and  " << regNames[rX] << ", #0x" << std::hex << immediate;
+            } else {
+                oss << "and  " << regNames[rX] << ", " << regNames[rY];
+            }
+            break;
+
+        case 7: {
+            uint16_t op_subtype = (instr >> 4) & 0x7;
+            if (op_subtype == 1) {
+                oss << "xor  " << regNames[rX] << ", " << regNames[rY];
+            }
+            else {
+                uint16_t shift_flag = (instr >> 8) & 0x1;
+
+                if (shift_flag) {
+                    uint16_t imm_shift = (instr >> 7) & 0x1;
+                    uint16_t shift_type = (instr >> 5) & 0x3;
+                    uint16_t shift_amount = instr & 0xF;
+                    const char* shift_types[] = {"lsl", "lsr", "asr", "ror"};
+
+                    oss << shift_types[shift_type] << "  " << regNames[rX];
+                    if (imm_shift) {
+                        oss << ", #0x" << std::hex << shift_amount;
+                    } else {
+                        oss << ", " << regNames[rY];
+                    }
+                } else if (imm) {
+                    if (immediate & 0x100) {
+                        immediate |= 0xFF00;
+                        oss << "cmp  " << regNames[rX] << ", #-0x" << std::hex << (-immediate);
+                    } else {
+                        oss << "cmp  " << regNames[rX] << ", #0x" << std::hex << immediate;
+                    }
+                } else {
+                    oss << "cmp  " << regNames[rX] << ", " << regNames[rY];
+                }
+            }
+            break;
+        }
+    }
+    return oss.str();
+}
+
+// Fill line for addresses no segment covers.
+static void writeGap(std::ostream& out, int begin, int end) {
+    out << "[" << std::hex << begin << ".." << (end - 1) << "]" << " : 0000;\n";
+}
+
+void writeMIF(std::ostream& out, const std::vector<uint16_t>& machineCode,
+              const std::vector<bool>& isData, const std::vector<Segment>& segments,
+              int depth, const MifOptions& options) {
+    out << "WIDTH = 16;\n";
+    out << "DEPTH = " << depth << ";\n";
+    out << "ADDRESS_RADIX = HEX;\n";
+    out << "DATA_RADIX = HEX;\n\n";
+    out << "CONTENT\n";
+    out << "BEGIN\n";
+
+    auto dataAt = [&](size_t i) { return i < isData.size() && isData[i]; };
+
+    int next = 0;
+    for (const auto& segment : segments) {
+        if (segment.base > next) {
+            writeGap(out, next, segment.base);
+        }
+
+        const size_t first = segment.offset;
+        const size_t last = segment.offset + segment.length;
+        for (size_t i = first; i < last; ) {
+            const bool data = dataAt(i);
+            const bool commented = options.comments == MifComments::ALL ||
+                                   (options.comments == MifComments::INSTRUCTIONS && !data);
+
+            // Instruction words keep a line each when only they are commented,
+            // otherwise equal neighbours of the same kind share one range.
+            size_t end = i + 1;
+            if (options.compressRuns && !(options.comments == MifComments::INSTRUCTIONS && !data)) {
+                while (end < last && machineCode[end] == machineCode[i] && dataAt(end) == data) {
+                    end++;
+                }
+            }
+
+            const size_t address = segment.base + (i - first);
+            std::ostringstream field;
+            field << std::hex;
+            if (end - i == 1) {
+                field << address;
+            } else {
+                field << "[" << address << ".." << (address + (end - i) - 1) << "]";
+            }
+            // Single addresses keep the historical column layout, ranges are
+            // written like the fill lines.
+            const std::string text = field.str();
+            out << text << std::string(end - i > 1 ? 1 : text.size() > 1 ? 6 : 7, ' ');
+
+            out << ": " << std::hex << std::setw(4) << std::setfill('0') << machineCode[i] << ";";
+            if (commented) {
+                out << std::string(8, ' ') << "% "
+                    << (data ? "data" : disassembleWord(machineCode[i], address)) << " %";
+            }
+            out << "\n";
+            i = end;
+        }
+        next = segment.end();
+    }
+
+    if (next < depth) {
+        writeGap(out, next, depth);
+    }
+
+    out << "END;\n";
+}
+
+void writeMIF(std::ostream& out, const std::vector<uint16_t>& machineCode,
+              const std::vector<bool>& isData, int depth, const MifOptions& options) {
+    std::vector<Segment> segments;
+    if (!machineCode.empty()) {
+        segments.push_back({0, static_cast<int>(machineCode.size()), 0, false});
+    }
+    writeMIF(out, machineCode, isData, segments, depth, options);
+}
+
+bool writeMIF(const std::vector<uint16_t>& machineCode,
+              const std::vector<bool>& isData,
+              const std::vector<Segment>& segments,
+              std::string& outputFile,
+              int depth,
+              const MifOptions& options) {
+    if (outputFile.size() < 4 || outputFile.substr(outputFile.size() - 4) != ".mif") {
+        outputFile += ".mif";
+    }
+
+    std::ostringstream out;
+    writeMIF(out, machineCode, isData, segments, depth, options);
+    return writeFileIfChanged(outputFile, out.str());
+}
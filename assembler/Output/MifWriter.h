@@ -0,0 +1,51 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Writes assembled images as Quartus Memory Initialization
+//              Files. Runs of identical words become "[a..b] : XXXX;"
+//              address ranges, and every word can be annotated with its
+//              disassembly (or "data"). Images are written per segment,
+//              with zero fill for the addresses between segments.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "InstructionEncoder/MemoryImage.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum class MifComments {
+    ALL,            // every line, runs get the comment of their word
+    INSTRUCTIONS,   // instruction words only; they are never merged
+    NONE
+};
+
+struct MifOptions {
+    bool compressRuns = true;   // merge runs of identical words
+    MifComments comments = MifComments::ALL;
+};
+
+// Disassembly of one word as it appears in MIF comments; address is needed
+// to print branch targets.
+std::string disassembleWord(uint16_t word, size_t address);
+
+// Writes the words of each segment at its addresses; addresses outside
+// every segment (below depth) are written as zero fill.
+void writeMIF(std::ostream& out, const std::vector<uint16_t>& machineCode,
+              const std::vector<bool>& isData, const std::vector<Segment>& segments,
+              int depth, const MifOptions& options = MifOptions());
+
+// Same for an image that starts at address 0 without gaps.
+void writeMIF(std::ostream& out, const std::vector<uint16_t>& machineCode,
+              const std::vector<bool>& isData, int depth,
+              const MifOptions& options = MifOptions());
+
+// Appends ".mif" to outputFile when missing, then writes the file unless
+// it already holds the same image. Returns whether the file was written.
+bool writeMIF(const std::vector<uint16_t>& machineCode,
+              const std::vector<bool>& isData,
+              const std::vector<Segment>& segments,
+              std::string& outputFile,
+              int depth = 256,
+              const MifOptions& options = MifOptions());
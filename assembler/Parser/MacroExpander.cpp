@@ -0,0 +1,258 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "MacroExpander.h"
+#include <algorithm>
+
+constexpr int MacroExpander::MAX_DEPTH;
+
+static AssemblyError errorAt(const std::string& message, const Token& token) {
+    return AssemblyError(message + " at line " + std::to_string(token.line), token.line, token.column);
+}
+
+static bool isDirective(const Token& token, const char* name) {
+    return token.type == TokenType::DIRECTIVE && token.value == name;
+}
+
+void MacroExpander::expand(std::vector<Token>& tokens) {
+    const bool hasMacros = std::any_of(tokens.begin(), tokens.end(), [](const Token& token) {
+        return token.type == TokenType::DIRECTIVE &&
+               (token.value == ".macro" || token.value == ".rept" ||
+                token.value == ".endm" || token.value == ".endr");
+    });
+    if (!hasMacros) {
+        return;
+    }
+
+    size_t end = tokens.size();
+    if (end > 0 && tokens[end - 1].type == TokenType::END_OF_FILE) {
+        end--;
+    }
+    std::vector<Token> output;
+    output.reserve(tokens.size());
+    MacroExpander expander(tokens, output);
+    expander.emitRange(0, end, nullptr);
+    if (end < tokens.size()) {
+        output.push_back(tokens[end]);
+    }
+    tokens.swap(output);
+}
+
+// Invocations are recognised where a statement can start: first on a
+// line, or right after a label.
+bool MacroExpander::atStatementStart(size_t index, size_t begin) const {
+    return index == begin || input[index - 1].line != input[index].line ||
+           input[index - 1].type == TokenType::LABEL;
+}
+
+size_t MacroExpander::lineEnd(size_t index, size_t end) const {
+    const int line = input[index].line;
+    while (index < end && input[index].line == line) {
+        index++;
+    }
+    return index;
+}
+
+size_t MacroExpander::matchingEnd(size_t index, size_t end, const char* open, const char* close) const {
+    int nesting = 0;
+    for (size_t i = index + 1; i < end; i++) {
+        if (isDirective(input[i], open)) {
+            nesting++;
+        } else if (isDirective(input[i], close) && nesting-- == 0) {
+            return i;
+        }
+    }
+    throw errorAt(std::string("Missing ") + close + " for " + open, input[index]);
+}
+
+void MacroExpander::emitRange(size_t begin, size_t end, const Frame* frame) {
+    for (size_t i = begin; i < end;) {
+        const Token& token = input[i];
+        if (token.type == TokenType::DIRECTIVE) {
+            if (token.value == ".macro") {
+                if (frame) {
+                    throw errorAt(".macro inside a macro body", token);
+                }
+                i = define(i, end);
+                continue;
+            }
+            if (token.value == ".rept") {
+                i = repeat(i, end, frame);
+                continue;
+            }
+            if (token.value == ".endm" || token.value == ".endr") {
+                throw errorAt(token.value + " without " + (token.value == ".endm" ? ".macro" : ".rept"), token);
+            }
+        }
+        if (token.type == TokenType::LABEL_REF && !macros.empty() && atStatementStart(i, begin) &&
+            (!frame || frame->macro->roles[i - frame->macro->begin] == 0) && macros.count(token.value)) {
+            i = invoke(i, end, frame);
+            continue;
+        }
+        emitToken(i, frame, output);
+        i++;
+    }
+}
+
+void MacroExpander::emitToken(size_t index, const Frame* frame, std::vector<Token>& into) const {
+    const Token& token = input[index];
+    const int role = frame ? frame->macro->roles[index - frame->macro->begin] : 0;
+    if (role <= 0) {
+        into.push_back(token);
+        if (frame) {
+            into.back().line = frame->line;
+            into.back().column = frame->column;
+            if (role < 0) {
+                into.back().value += frame->suffix;
+            }
+        }
+        return;
+    }
+
+    const std::vector<Token>& arg = frame->args[role - 1];
+    if (token.type == TokenType::LABEL_REF) {
+        for (const Token& part : arg) {
+            into.push_back(part);
+            into.back().line = frame->line;
+            into.back().column = frame->column;
+        }
+        return;
+    }
+
+    // #param, =param and param: take the value of a single number or name.
+    const bool isName = arg.size() == 1 && arg[0].type == TokenType::LABEL_REF;
+    const bool isNumber = arg.size() == 1 && arg[0].type == TokenType::NUMBER;
+    if (!isName && !(isNumber && token.type != TokenType::LABEL)) {
+        throw AssemblyError("Argument for '" + token.value + "' must be a single " +
+                            (token.type == TokenType::LABEL ? "name" : "number or name") +
+                            " at line " + std::to_string(frame->line), frame->line, frame->column);
+    }
+    into.push_back(arg[0]);
+    into.back().type = token.type;
+    into.back().line = frame->line;
+    into.back().column = frame->column;
+}
+
+// .macro NAME [param {, param}] <body> .endm
+size_t MacroExpander::define(size_t index, size_t end) {
+    const Token& directive = input[index];
+    const size_t header = lineEnd(index, end);
+    size_t i = index + 1;
+    if (i == header || input[i].type != TokenType::LABEL_REF) {
+        throw errorAt("Expected macro name after .macro", directive);
+    }
+    const std::string& name = input[i++].value;
+
+    Macro macro;
+    while (i < header) {
+        if (input[i].type != TokenType::LABEL_REF) {
+            throw errorAt("Expected parameter name in .macro " + name, input[i]);
+        }
+        macro.params.push_back(input[i++].value);
+        if (i < header && (input[i].type != TokenType::COMMA || ++i == header)) {
+            throw errorAt("Expected ', parameter' in .macro " + name, input[i - 1]);
+        }
+    }
+
+    size_t close = header;
+    for (; close < end && !isDirective(input[close], ".endm"); close++) {
+        if (isDirective(input[close], ".macro")) {
+            throw errorAt(".macro inside a macro body", input[close]);
+        }
+    }
+    if (close == end) {
+        throw errorAt("Missing .endm for .macro " + name, directive);
+    }
+    macro.begin = header;
+    macro.end = close;
+
+    auto indexOf = [](const std::vector<std::string>& names, const std::string& value) {
+        return static_cast<int>(std::find(names.begin(), names.end(), value) - names.begin());
+    };
+    for (size_t j = macro.begin; j < macro.end; j++) {
+        if (input[j].type == TokenType::LABEL && indexOf(macro.params, input[j].value) == (int)macro.params.size() &&
+            indexOf(macro.locals, input[j].value) == (int)macro.locals.size()) {
+            macro.locals.push_back(input[j].value);
+        }
+    }
+    macro.roles.assign(macro.end - macro.begin, 0);
+    for (size_t j = macro.begin; j < macro.end; j++) {
+        const Token& token = input[j];
+        if (token.hasNumber || (token.type != TokenType::LABEL_REF && token.type != TokenType::LABEL &&
+                                token.type != TokenType::NUMBER_IMMEDIATE &&
+                                token.type != TokenType::LABEL_IMMEDIATE)) {
+            continue;
+        }
+        const int param = indexOf(macro.params, token.value);
+        const int local = indexOf(macro.locals, token.value);
+        if (param < (int)macro.params.size()) {
+            macro.roles[j - macro.begin] = param + 1;
+        } else if (local < (int)macro.locals.size()) {
+            macro.roles[j - macro.begin] = -local - 1;
+        }
+    }
+
+    if (!macros.emplace(name, std::move(macro)).second) {
+        throw errorAt("Macro " + name + " is already defined", directive);
+    }
+    return close + 1;
+}
+
+// NAME [arg {, arg}] on one line. Arguments are substituted in the
+// caller's frame first, so they may use its parameters and local labels.
+size_t MacroExpander::invoke(size_t index, size_t end, const Frame* frame) {
+    const Token& call = input[index];
+    const Macro& macro = macros.find(call.value)->second;
+    const size_t stop = lineEnd(index, end);
+
+    Frame inner;
+    inner.macro = &macro;
+    inner.line = frame ? frame->line : call.line;
+    inner.column = frame ? frame->column : call.column;
+    size_t i = index + 1;
+    while (i < stop) {
+        std::vector<Token> arg;
+        while (i < stop && input[i].type != TokenType::COMMA) {
+            emitToken(i++, frame, arg);
+        }
+        if (arg.empty() || (i < stop && ++i == stop)) {
+            throw errorAt("Empty argument in call of macro " + call.value, call);
+        }
+        inner.args.push_back(std::move(arg));
+    }
+    if (inner.args.size() != macro.params.size()) {
+        throw errorAt("Macro " + call.value + " expects " + std::to_string(macro.params.size()) +
+                      " argument(s), got " + std::to_string(inner.args.size()), call);
+    }
+    if (depth == MAX_DEPTH) {
+        throw errorAt("Macro " + call.value + " nested more than " + std::to_string(MAX_DEPTH) +
+                      " levels deep", call);
+    }
+    inner.suffix = "@" + std::to_string(++expansions);
+
+    depth++;
+    emitRange(macro.begin, macro.end, &inner);
+    depth--;
+    return stop;
+}
+
+// .rept COUNT <body> .endr
+size_t MacroExpander::repeat(size_t index, size_t end, const Frame* frame) {
+    const Token& directive = input[index];
+    const size_t header = lineEnd(index, end);
+    std::vector<Token> count;
+    for (size_t i = index + 1; i < header; i++) {
+        emitToken(i, frame, count);
+    }
+    if (count.size() != 1 || count[0].type != TokenType::NUMBER || count[0].number < 0) {
+        throw errorAt("Expected a non-negative count after .rept", directive);
+    }
+
+    const size_t close = matchingEnd(index, end, ".rept", ".endr");
+    for (int64_t n = 0; n < count[0].number; n++) {
+        emitRange(header, close, frame);
+    }
+    return close + 1;
+}
@@ -0,0 +1,63 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Expands .macro/.endm definitions, macro invocations and
+//              .rept/.endr blocks on the token stream, between the lexer and
+//              the parser. Bodies are kept as ranges of the lexed tokens and
+//              copied with their parameters substituted, so nothing is lexed
+//              twice and the work is linear in the size of the expansion.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "common.h"
+#include "Lexer/Lexer.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class MacroExpander {
+private:
+    struct Macro {
+        std::vector<std::string> params;
+        std::vector<std::string> locals;    // labels defined in the body
+        size_t begin;                       // body tokens in input
+        size_t end;
+        // Per body token: 0 = copy, k > 0 = parameter k - 1,
+        // k < 0 = local label -k - 1.
+        std::vector<int> roles;
+    };
+
+    struct Frame {
+        const Macro* macro;
+        std::vector<std::vector<Token>> args;
+        std::string suffix;                 // appended to local labels
+        int line;                           // outermost invocation
+        int column;
+    };
+
+    static constexpr int MAX_DEPTH = 64;
+
+    const std::vector<Token>& input;
+    std::vector<Token>& output;
+    std::unordered_map<std::string, Macro> macros;
+    size_t expansions = 0;
+    int depth = 0;
+
+    bool atStatementStart(size_t index, size_t begin) const;
+    size_t lineEnd(size_t index, size_t end) const;
+    size_t matchingEnd(size_t index, size_t end, const char* open, const char* close) const;
+    void emitRange(size_t begin, size_t end, const Frame* frame);
+    void emitToken(size_t index, const Frame* frame, std::vector<Token>& into) const;
+    size_t define(size_t index, size_t end);
+    size_t invoke(size_t index, size_t end, const Frame* frame);
+    size_t repeat(size_t index, size_t end, const Frame* frame);
+
+    MacroExpander(const std::vector<Token>& input, std::vector<Token>& output)
+        : input(input), output(output) {}
+
+public:
+    // Replaces tokens with its expansion. Streams without .macro or .rept
+    // are left untouched. Throws AssemblyError for malformed definitions,
+    // unknown .endm/.endr, wrong argument counts and runaway recursion.
+    static void expand(std::vector<Token>& tokens);
+};
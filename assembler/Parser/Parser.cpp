@@ -6,7 +6,7 @@
 #include "Parser.h"
 
 std::unique_ptr<Statement> Parser::parseStatement() {
-    Token current = peek();
+    const Token& current = peek();
 
     if (current.type == TokenType::LABEL) {
         return parseLabel();
@@ -31,12 +31,20 @@ std::unique_ptr<Statement> Parser::parseStatement() {
 }
 
 std::unique_ptr<Instruction> Parser::parseInstruction() {
-    Token instr = advance();
+    const Token& instr = advance();
     std::string opcode = instr.value;
     std::string operand1, operand2;
     bool hasComma = false;
     bool isLabelImmediate = false;
     bool isImmediate = false;
+    int64_t number = 0;
+    bool hasNumber = false;
+
+    auto finish = [&](std::unique_ptr<Instruction> result) {
+        result->number = number;
+        result->hasNumber = hasNumber;
+        return result;
+    };
 
     if (opcode == "b" || opcode == "beq" || opcode == "bne" || 
         opcode == "bcc" || opcode == "bcs" || opcode == "bpl" || 
@@ -46,8 +54,8 @@ std::unique_ptr<Instruction> Parser::parseInstruction() {
                                    "' at line " + std::to_string(instr.line));
         }
         operand1 = advance().value;
-        return std::make_unique<Instruction>(opcode, operand1, "", false, false, false,
-                                           instr.line, instr.column);
+        return finish(std::make_unique<Instruction>(opcode, operand1, "", false, false, false,
+                                           instr.line, instr.column));
     }
 
     if (opcode == "push" || opcode == "pop") {
@@ -56,8 +64,8 @@ std::unique_ptr<Instruction> Parser::parseInstruction() {
                                    "' at line " + std::to_string(instr.line));
         }
         operand1 = advance().value;
-        return std::make_unique<Instruction>(opcode, operand1, "", false, false, false,
-                                           instr.line, instr.column);
+        return finish(std::make_unique<Instruction>(opcode, operand1, "", false, false, false,
+                                           instr.line, instr.column));
     }
 
     if (!check(TokenType::REGISTER)) {
@@ -81,36 +89,38 @@ std::unique_ptr<Instruction> Parser::parseInstruction() {
             throw std::runtime_error("Expected register inside brackets for '" + opcode + 
                                    "' at line " + std::to_string(instr.line));
         }
-        operand2 = advance().value;
+        operand2 = takeOperand(number, hasNumber);
         if (!match(TokenType::BRACKET_CLOSE)) {
             throw std::runtime_error("Expected ']' after register for '" + opcode + 
                                    "' at line " + std::to_string(instr.line));
         }
-        return std::make_unique<Instruction>(opcode, operand1, operand2, hasComma, false, false,
-                                           instr.line, instr.column);
+        return finish(std::make_unique<Instruction>(opcode, operand1, operand2, hasComma, false, false,
+                                           instr.line, instr.column));
     }
 
     if (opcode == "mv") {
         if (check(TokenType::LABEL_IMMEDIATE) || check(TokenType::NUMBER_IMMEDIATE)) {
-            Token labelImm = advance();
+            const Token& labelImm = advance();
             operand2 = labelImm.value;
+            number = labelImm.number;
+            hasNumber = labelImm.hasNumber;
             isImmediate = true;
             isLabelImmediate = (labelImm.type == TokenType::LABEL_IMMEDIATE);
         }
         else if (check(TokenType::REGISTER)) {
-            operand2 = advance().value;
+            operand2 = takeOperand(number, hasNumber);
         } 
         else if (check(TokenType::NUMBER)) {
-            operand2 = advance().value;
+            operand2 = takeOperand(number, hasNumber);
             isImmediate = true;
         } else if (check(TokenType::LABEL_REF)) {
-            operand2 = advance().value;
+            operand2 = takeOperand(number, hasNumber);
         } else {
             throw std::runtime_error("Expected register, numeric immediate, or label immediate after 'mv' at line " + 
                                    std::to_string(instr.line));
         }
-        return std::make_unique<Instruction>(opcode, operand1, operand2, hasComma, isLabelImmediate, isImmediate,
-                                           instr.line, instr.column);
+        return finish(std::make_unique<Instruction>(opcode, operand1, operand2, hasComma, isLabelImmediate, isImmediate,
+                                           instr.line, instr.column));
     }
 
     if (opcode == "mvt") {
@@ -118,61 +128,61 @@ std::unique_ptr<Instruction> Parser::parseInstruction() {
             throw std::runtime_error("Expected immediate value after 'mvt' at line " + 
                                    std::to_string(instr.line));
         }
-        operand2 = advance().value;
+        operand2 = takeOperand(number, hasNumber);
         isImmediate = true;
-        return std::make_unique<Instruction>(opcode, operand1, operand2, hasComma, false, isImmediate,
-                                           instr.line, instr.column);
+        return finish(std::make_unique<Instruction>(opcode, operand1, operand2, hasComma, false, isImmediate,
+                                           instr.line, instr.column));
     }
 
     if (opcode == "add" || opcode == "sub" || opcode == "and") {
         if (check(TokenType::REGISTER)) {
-            operand2 = advance().value;
+            operand2 = takeOperand(number, hasNumber);
         }
         else if (check(TokenType::NUMBER) || check(TokenType::NUMBER_IMMEDIATE)) {
-            operand2 = advance().value;
+            operand2 = takeOperand(number, hasNumber);
             isImmediate = true;
         }
         else {
             throw std::runtime_error("Expected register or immediate value after '" + opcode + 
                                    "' at line " + std::to_string(instr.line));
         }
-        return std::make_unique<Instruction>(opcode, operand1, operand2, hasComma, false, isImmediate,
-                                           instr.line, instr.column);
+        return finish(std::make_unique<Instruction>(opcode, operand1, operand2, hasComma, false, isImmediate,
+                                           instr.line, instr.column));
     }
 
     if (opcode == "cmp") {
         if (check(TokenType::REGISTER)) {
-            operand2 = advance().value;
+            operand2 = takeOperand(number, hasNumber);
         }
         else if (check(TokenType::NUMBER) || check(TokenType::NUMBER_IMMEDIATE)) {
-            operand2 = advance().value;
+            operand2 = takeOperand(number, hasNumber);
             isImmediate = true;
         }
         else {
             throw std::runtime_error("Expected register or immediate value after 'cmp' at line " + 
                                    std::to_string(instr.line));
         }
-        return std::make_unique<Instruction>(opcode, operand1, operand2, hasComma, false, isImmediate,
-                                           instr.line, instr.column);
+        return finish(std::make_unique<Instruction>(opcode, operand1, operand2, hasComma, false, isImmediate,
+                                           instr.line, instr.column));
     }
 
     if (opcode == "lsl" || opcode == "lsr" || opcode == "asr" || opcode == "ror" || opcode == "xor") {
         if (check(TokenType::REGISTER)) {
-            operand2 = advance().value;
+            operand2 = takeOperand(number, hasNumber);
         }
         else if (check(TokenType::NUMBER) || check(TokenType::NUMBER_IMMEDIATE)) {
             if(opcode == "xor") {
                 throw std::runtime_error("XOR instruction does not support immediate values '" + opcode + "' at line " + std::to_string(instr.line));
             }
-            operand2 = advance().value;
+            operand2 = takeOperand(number, hasNumber);
             isImmediate = true;
         }
         else {
             throw std::runtime_error("Expected register or immediate value after '" + opcode + 
                                    "' at line " + std::to_string(instr.line));
         }
-        return std::make_unique<Instruction>(opcode, operand1, operand2, hasComma, false, isImmediate,
-                                           instr.line, instr.column);
+        return finish(std::make_unique<Instruction>(opcode, operand1, operand2, hasComma, false, isImmediate,
+                                           instr.line, instr.column));
     }
 
     throw std::runtime_error("Unrecognized instruction '" + opcode + 
@@ -180,9 +190,15 @@ std::unique_ptr<Instruction> Parser::parseInstruction() {
 }
 
 std::unique_ptr<Directive> Parser::parseDirective() {
-    Token dir = advance();
+    const Token& dir = advance();
     std::string name = dir.value;
     std::string label, value;
+    int64_t number = 0;
+    bool hasNumber = false;
+    int64_t count = 0;
+    std::vector<int64_t> values;
+    int64_t byteOffset = 0;
+    int64_t byteLength = -1;
 
     if (name == ".define") {
         if (!check(TokenType::LABEL_REF)) {
@@ -195,27 +211,100 @@ std::unique_ptr<Directive> Parser::parseDirective() {
             throw std::runtime_error("Expected number after .define " + label + 
                                    " at line " + std::to_string(dir.line));
         }
-        value = advance().value;
+        value = takeOperand(number, hasNumber);
     }
     else if (name == ".word") {
         if (!check(TokenType::NUMBER)) {
             throw std::runtime_error("Expected number after .word at line " + 
                                    std::to_string(dir.line));
         }
+        value = takeOperand(number, hasNumber);
+        // .word a, b, c: one statement for the whole list.
+        if (check(TokenType::COMMA)) {
+            values.push_back(number);
+            while (match(TokenType::COMMA)) {
+                if (!check(TokenType::NUMBER)) {
+                    throw std::runtime_error("Expected number after ',' in .word at line " +
+                                           std::to_string(dir.line));
+                }
+                values.push_back(advance().number);
+            }
+        }
+    }
+    else if (name == ".incbin") {
+        if (!check(TokenType::STRING)) {
+            throw std::runtime_error("Expected \"file\" after .incbin at line " +
+                                   std::to_string(dir.line));
+        }
         value = advance().value;
+        if (match(TokenType::COMMA)) {
+            if (!check(TokenType::NUMBER)) {
+                throw std::runtime_error("Expected byte offset after .incbin file at line " +
+                                       std::to_string(dir.line));
+            }
+            byteOffset = advance().number;
+            if (match(TokenType::COMMA)) {
+                if (!check(TokenType::NUMBER)) {
+                    throw std::runtime_error("Expected byte count after .incbin offset at line " +
+                                           std::to_string(dir.line));
+                }
+                byteLength = advance().number;
+                if (byteLength < 0) {
+                    throw std::runtime_error(".incbin byte count must not be negative at line " +
+                                           std::to_string(dir.line));
+                }
+            }
+        }
+    }
+    else if (name == ".org" || name == ".space") {
+        if (!check(TokenType::NUMBER)) {
+            throw std::runtime_error("Expected number after " + name + " at line " +
+                                   std::to_string(dir.line));
+        }
+        value = takeOperand(number, hasNumber);
+    }
+    else if (name == ".fill") {
+        if (!check(TokenType::NUMBER)) {
+            throw std::runtime_error("Expected word count after .fill at line " +
+                                   std::to_string(dir.line));
+        }
+        count = advance().number;
+        if (!match(TokenType::COMMA) || !check(TokenType::NUMBER)) {
+            throw std::runtime_error("Expected ', value' after .fill count at line " +
+                                   std::to_string(dir.line));
+        }
+        value = takeOperand(number, hasNumber);
     }
 
-    return std::make_unique<Directive>(name, label, value, dir.line, dir.column);
+    auto directive = std::make_unique<Directive>(name, label, value, dir.line, dir.column);
+    directive->number = number;
+    directive->hasNumber = hasNumber;
+    directive->count = count;
+    directive->values = std::move(values);
+    directive->byteOffset = byteOffset;
+    directive->byteLength = byteLength;
+    return directive;
+}
+
+std::string Parser::takeOperand(int64_t& number, bool& hasNumber) {
+    const Token& operand = advance();
+    number = operand.number;
+    hasNumber = operand.hasNumber;
+    return operand.value;
 }
 
 std::unique_ptr<Label> Parser::parseLabel() {
-    Token label = advance();
+    const Token& label = advance();
     return std::make_unique<Label>(label.value, label.line, label.column);
 }
 
 std::vector<std::unique_ptr<Statement>> Parser::parse() {
     std::vector<std::unique_ptr<Statement>> statements;
-    
+    parse(statements);
+    return statements;
+}
+
+void Parser::parse(std::vector<std::unique_ptr<Statement>>& statements) {
     while (!isAtEnd()) {
         try {
             if (peek().type == TokenType::END_OF_FILE) break;
@@ -225,25 +314,23 @@ std::vector<std::unique_ptr<Statement>> Parser::parse() {
                 statements.push_back(std::move(stmt));
             }
         } catch (const std::exception& e) {
-            throw std::runtime_error("Parse error at line " + 
-                std::to_string(peek().line) + ": " + e.what());
+            throw AssemblyError("Parse error at line " + 
+                std::to_string(peek().line) + ": " + e.what(), peek().line, peek().column);
         }
     }
-
-    return statements;
 }
 
-Token Parser::peek() const {
-    if (isAtEnd()) return Token(TokenType::END_OF_FILE, "", -1, -1);
+const Token& Parser::peek() const {
+    if (isAtEnd()) return endOfInput;
     return tokens[current];
 }
 
-Token Parser::advance() {
+const Token& Parser::advance() {
     if (!isAtEnd()) current++;
     return previous();
 }
 
-Token Parser::previous() const {
+const Token& Parser::previous() const {
     return tokens[current - 1];
 }
 
@@ -21,6 +21,7 @@ public:
     StatementType type;
     int line;
     int column;
+    int file = 0;   // source index in AssemblerContext::assembleFiles()
 
     Statement(StatementType t, int l, int c) : type(t), line(l), column(c) {}
     virtual ~Statement() = default;
@@ -34,6 +35,9 @@ public:
     bool hasComma;
     bool isLabelImmediate;
     bool isImmediate;
+    // Value of a numeric operand2 as decoded by the lexer.
+    int64_t number = 0;
+    bool hasNumber = false;
 
     Instruction(const std::string& op, const std::string& op1, 
                 const std::string& op2, bool comma, bool labelImm, bool imm,
@@ -48,6 +52,19 @@ public:
     std::string name;
     std::string label;
     std::string value;
+    int64_t number = 0;
+    bool hasNumber = false;
+    // Word count of .fill (number/value hold the fill word) and .incbin.
+    int64_t count = 0;
+    // Further values of a multi-value .word; the first is number/value.
+    std::vector<int64_t> values;
+    // .incbin: value is the file name, the slice is given in bytes (length
+    // -1 for the rest of the file). payload, bigEndian and count are set by
+    // resolveBinaryIncludes().
+    int64_t byteOffset = 0;
+    int64_t byteLength = -1;
+    const uint8_t* payload = nullptr;
+    bool bigEndian = false;
 
     Directive(const std::string& n, const std::string& l, 
               const std::string& v, int line, int col)
@@ -65,12 +82,13 @@ public:
 
 class Parser {
 private:
-    std::vector<Token> tokens;
+    const std::vector<Token>& tokens;
     size_t current;
+    const Token endOfInput;
 
-    Token peek() const;
-    Token advance();
-    Token previous() const;
+    const Token& peek() const;
+    const Token& advance();
+    const Token& previous() const;
     bool isAtEnd() const;
     bool match(TokenType type);
     bool check(TokenType type) const;
@@ -79,8 +97,14 @@ private:
     std::unique_ptr<Instruction> parseInstruction();
     std::unique_ptr<Directive> parseDirective();
     std::unique_ptr<Label> parseLabel();
+    std::string takeOperand(int64_t& number, bool& hasNumber);
 
 public:
-    Parser(const std::vector<Token>& tokens) : tokens(tokens), current(0) {}
+    // The token stream is borrowed, not copied, and must outlive the parser.
+    Parser(const std::vector<Token>& tokens)
+        : tokens(tokens), current(0), endOfInput(TokenType::END_OF_FILE, "", -1, -1) {}
+    Parser(std::vector<Token>&&) = delete;
     std::vector<std::unique_ptr<Statement>> parse();
+    // Appends to `statements`, letting callers reuse the vector's storage.
+    void parse(std::vector<std::unique_ptr<Statement>>& statements);
 };
\ No newline at end of file
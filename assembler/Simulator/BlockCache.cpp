@@ -0,0 +1,158 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "BlockCache.h"
+#include <algorithm>
+
+constexpr size_t BlockCache::MAX_BLOCK_WORDS;
+
+namespace {
+constexpr size_t ADDRESSES = 0x10000;
+constexpr uint16_t BRANCH_TO_SELF = 0x21FF;
+constexpr uint16_t HALT_MASK = 0xE1F0;
+
+inline uint16_t signExtend9(uint16_t instr) {
+    return (instr & 0x100) ? (instr | 0xFE00) : (instr & 0x1FF);
+}
+
+// Decodes one body instruction into op, or returns false when it has to end
+// the block (branches, halt, anything reading or writing pc).
+bool decodeBody(uint16_t instr, BlockOp& op) {
+    if ((instr & HALT_MASK) == HALT_MASK && !(instr & 0x1000)) {
+        return false;
+    }
+    const unsigned opcode = instr >> 13;
+    const bool immediate = (instr & 0x1000) != 0;
+    op.rX = (instr >> 9) & 7;
+    op.rY = instr & 7;
+    op.operand = signExtend9(instr);
+    bool readsY = !immediate;
+
+    switch (opcode) {
+        case 0: op.kind = immediate ? BlockOp::MV_I : BlockOp::MV_R; break;
+        case 1:
+            if (!immediate) return false;       // branch
+            op.kind = BlockOp::MV_I;            // mvt
+            op.operand = (instr & 0xFF) << 8;
+            break;
+        case 2: op.kind = immediate ? BlockOp::ADD_I : BlockOp::ADD_R; break;
+        case 3: op.kind = immediate ? BlockOp::SUB_I : BlockOp::SUB_R; break;
+        case 4: op.kind = immediate ? BlockOp::POP : BlockOp::LD; break;
+        case 5: op.kind = immediate ? BlockOp::PUSH : BlockOp::ST; break;
+        case 6: op.kind = immediate ? BlockOp::AND_I : BlockOp::AND_R; break;
+        default:
+            if (immediate || !(instr & 0x100)) {
+                op.kind = immediate ? BlockOp::CMP_I : BlockOp::CMP_R;
+            } else if ((instr & 0xF0) == 0x10) {
+                op.kind = BlockOp::XOR_R;
+            } else {
+                // LSL_R, LSL_I, LSR_R, ... are in (type, immediate) order.
+                const bool amountImmediate = (instr & 0x80) != 0;
+                op.kind = static_cast<BlockOp::Kind>(BlockOp::LSL_R + 2 * ((instr >> 5) & 3) + amountImmediate);
+                op.operand = instr & 0xF;
+                readsY = !amountImmediate;
+            }
+            break;
+    }
+    return op.rX != 7 && !(readsY && op.rY == 7);
+}
+}
+
+BlockCache::BlockCache() : blockAt(ADDRESSES, -1), code(ADDRESSES, 0), modified(ADDRESSES, 0) {}
+
+void BlockCache::clear() {
+    for (uint16_t entry : entries) {
+        blockAt[entry] = -1;
+    }
+    entries.clear();
+    blocks.clear();
+    ops.clear();
+    std::fill(code.begin(), code.end(), 0);
+    generation++;
+}
+
+void BlockCache::reset() {
+    clear();
+    std::fill(modified.begin(), modified.end(), 0);
+}
+
+const Block& BlockCache::translate(const uint16_t* memory, uint16_t pc) {
+    Block block;
+    block.firstOp = static_cast<uint32_t>(ops.size());
+    block.steps = 0;
+
+    uint16_t address = pc;
+    for (size_t words = 0;; words++) {
+        const uint16_t instr = memory[address];
+        BlockOp op = {};
+        op.address = address;
+        op.steps = 1;
+        op.stepsBefore = static_cast<uint16_t>(block.steps);
+
+        if (words == MAX_BLOCK_WORDS) {
+            op.kind = BlockOp::FALL_THROUGH;
+            op.steps = 0;
+            op.target = address;
+            ops.push_back(op);
+            break;
+        }
+        code[address] = 1;
+
+        if ((instr >> 13) == 1 && !(instr & 0x1000) && instr != BRANCH_TO_SELF) {
+            op.kind = BlockOp::BRANCH;
+            op.condition = (instr >> 9) & 7;
+            op.target = static_cast<uint16_t>(address + 1 + signExtend9(instr));
+            // A conditional branch right after cmp or sub #imm tests the
+            // flags that instruction sets: evaluate both in one op.
+            BlockOp* previous = ops.size() > block.firstOp ? &ops.back() : nullptr;
+            const bool conditional = op.condition != 0 && op.condition != 7;
+            if (conditional && previous &&
+                (previous->kind == BlockOp::CMP_R || previous->kind == BlockOp::CMP_I ||
+                 previous->kind == BlockOp::SUB_I)) {
+                previous->kind = previous->kind == BlockOp::CMP_R   ? BlockOp::CMP_R_BRANCH
+                                 : previous->kind == BlockOp::CMP_I ? BlockOp::CMP_I_BRANCH
+                                                                    : BlockOp::SUB_I_BRANCH;
+                previous->condition = op.condition;
+                previous->target = op.target;
+                previous->steps = 2;
+            } else {
+                ops.push_back(op);
+            }
+            block.steps++;
+            break;
+        }
+        if (instr == BRANCH_TO_SELF || !decodeBody(instr, op)) {
+            op.kind = BlockOp::GENERIC;
+            ops.push_back(op);
+            block.steps++;
+            break;
+        }
+
+        // mvt rX, #hi followed by add rX, #lo is mv rX, =value: a constant
+        // whose flags are known at translation time.
+        const uint16_t next = memory[static_cast<uint16_t>(address + 1)];
+        if (instr >> 13 == 1 && words + 1 < MAX_BLOCK_WORDS && next >> 13 == 2 && (next & 0x1000) &&
+            ((next >> 9) & 7) == op.rX) {
+            const uint32_t value = uint32_t(op.operand) + signExtend9(next);
+            const uint16_t result = static_cast<uint16_t>(value);
+            op.kind = BlockOp::CONST;
+            op.operand = result;
+            op.flags = static_cast<uint8_t>((result == 0) | ((result >> 15) << 1) | ((value > 0xFFFF) << 2));
+            op.steps = 2;
+            address++;
+            words++;
+            code[address] = 1;
+        }
+        ops.push_back(op);
+        block.steps += op.steps;
+        address++;
+    }
+
+    block.opCount = static_cast<uint32_t>(ops.size()) - block.firstOp;
+    blockAt[pc] = static_cast<int32_t>(blocks.size());
+    entries.push_back(pc);
+    blocks.push_back(block);
+    return blocks.back();
+}
@@ -0,0 +1,92 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Basic-block translation for the simulator's block engine. A
+//              block is the straight-line run of words from an entry address
+//              up to the first branch or instruction that touches pc, decoded
+//              once into operations with their operands resolved:
+//              - "mvt rX, #hi; add rX, #lo" (what mv rX, =value assembles to)
+//                becomes one constant load with precomputed flags
+//              - cmp or sub followed by a conditional branch becomes one
+//                compare-and-branch terminator
+//              - halt, b-to-self and instructions that read or write pc end
+//                the block as GENERIC and are left to the interpreter
+//              Every address covered by a cached block is marked, so stores
+//              can tell cheaply whether they modify translated code. Such
+//              stores are remembered per address until the next reset(), for
+//              engines that stop optimizing self-modifying code.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct BlockOp {
+    enum Kind : uint8_t {
+        // Body operations; operand is rY (_R) or the immediate (_I).
+        MV_R, MV_I, CONST, ADD_R, ADD_I, SUB_R, SUB_I, AND_R, AND_I, CMP_R, CMP_I, XOR_R,
+        LSL_R, LSL_I, LSR_R, LSR_I, ASR_R, ASR_I, ROR_R, ROR_I,
+        LD, ST, POP, PUSH,
+        // Terminators; the last op of every block is one of these.
+        BRANCH, CMP_R_BRANCH, CMP_I_BRANCH, SUB_I_BRANCH, FALL_THROUGH, GENERIC
+    };
+
+    Kind kind;
+    uint8_t rX;
+    uint8_t rY;
+    uint8_t condition;      // branches: the rX field of b<cond>
+    uint16_t operand;       // immediate, shift amount or constant
+    uint16_t target;        // branches: destination; FALL_THROUGH: next address
+    uint16_t address;       // of the (first) instruction
+    uint8_t flags;          // CONST: z | n << 1 | c << 2
+    uint8_t steps;          // instructions covered, 2 for fused pairs
+    uint16_t stepsBefore;   // instructions of the block before this op
+};
+
+struct Block {
+    uint32_t firstOp;
+    uint32_t opCount;
+    uint32_t steps;         // instructions executed by a complete run
+};
+
+class BlockCache {
+public:
+    static constexpr size_t MAX_BLOCK_WORDS = 64;
+
+private:
+    std::vector<int32_t> blockAt;       // per entry address, -1 = untranslated
+    std::vector<uint8_t> code;          // per address, 1 when inside a block
+    std::vector<uint8_t> modified;      // per address, 1 after a store into a block
+    std::vector<uint16_t> entries;      // addresses with a block, for clear()
+    std::vector<Block> blocks;
+    std::vector<BlockOp> ops;
+    uint32_t generation = 0;            // incremented by every clear()
+
+public:
+    BlockCache();
+
+    // Returns the block starting at pc, translating it from memory first
+    // if needed. The reference stays valid until the next translate/clear.
+    const Block& lookup(const uint16_t* memory, uint16_t pc) {
+        const int32_t index = blockAt[pc];
+        return index >= 0 ? blocks[index] : translate(memory, pc);
+    }
+    const BlockOp* opsOf(const Block& block) const { return ops.data() + block.firstOp; }
+    bool isCode(uint16_t address) const { return code[address] != 0; }
+    const uint8_t* codeMap() const { return code.data(); }
+    bool wasModified(uint16_t address) const { return modified[address] != 0; }
+    uint32_t getGeneration() const { return generation; }
+    // Drops every block. Called when code memory changes.
+    void clear();
+    // clear() after the program stored into translated code at address.
+    void invalidate(uint16_t address) {
+        modified[address] = 1;
+        clear();
+    }
+    // clear() and forget earlier stores, for a newly loaded image.
+    void reset();
+
+private:
+    const Block& translate(const uint16_t* memory, uint16_t pc);
+};
@@ -0,0 +1,411 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "JitCompiler.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && defined(__linux__)
+#define SBASM_JIT_X64 1
+#include <sys/mman.h>
+#endif
+
+constexpr unsigned JitCompiler::DEFAULT_THRESHOLD;
+
+namespace {
+constexpr size_t ADDRESSES = 0x10000;
+}
+
+#if SBASM_JIT_X64
+
+namespace {
+
+constexpr size_t BUFFER_BYTES = 4 << 20;
+constexpr size_t MAX_OP_BYTES = 128;         // bound on an op and its stubs
+
+enum Reg : uint8_t { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+constexpr Reg Q[7] = {R8, R9, R10, R11, R12, R13, R14};     // qCore r0..r6
+constexpr Reg FLAG_Z = RBX, FLAG_N = RBP, FLAG_C = RDX, BUDGET = R15;
+
+enum Cond : uint8_t { CC_B = 0x2, CC_AE = 0x3, CC_E = 0x4, CC_NE = 0x5, CC_S = 0x8 };
+
+#define STATE_OFFSET(member) static_cast<uint8_t>(offsetof(JitCompiler::State, member))
+
+// Appends x86-64 machine code at a moving pointer.
+class Emitter {
+private:
+    uint8_t* p;
+
+    void rex(bool w, unsigned reg, unsigned index, unsigned base, bool force = false) {
+        const uint8_t value = 0x40 | (w << 3) | ((reg >> 3) << 2) | ((index >> 3) << 1) | (base >> 3);
+        if (value != 0x40 || force) byte(value);
+    }
+    void modrm(unsigned mod, unsigned reg, unsigned rm) { byte(static_cast<uint8_t>(mod << 6 | (reg & 7) << 3 | (rm & 7))); }
+    // [rdi + disp8]
+    void stateOperand(unsigned reg, uint8_t offset) {
+        modrm(1, reg, RDI);
+        byte(offset);
+    }
+
+public:
+    explicit Emitter(uint8_t* at) : p(at) {}
+    uint8_t* here() const { return p; }
+
+    void byte(uint8_t value) { *p++ = value; }
+    void word(uint16_t value) { std::memcpy(p, &value, 2); p += 2; }
+    void dword(uint32_t value) { std::memcpy(p, &value, 4); p += 4; }
+    void qword(uint64_t value) { std::memcpy(p, &value, 8); p += 8; }
+
+    void push(Reg r) { rex(false, 0, 0, r); byte(0x50 + (r & 7)); }
+    void pop(Reg r) { rex(false, 0, 0, r); byte(0x58 + (r & 7)); }
+    void ret() { byte(0xC3); }
+    void jmpRax() { byte(0xFF); byte(0xE0); }
+    void xorEaxEax() { byte(0x31); byte(0xC0); }
+
+    void movRR(Reg dst, Reg src) { rex(false, src, 0, dst); byte(0x89); modrm(3, src, dst); }
+    void movRR64(Reg dst, Reg src) { rex(true, src, 0, dst); byte(0x89); modrm(3, src, dst); }
+    void movRI(Reg dst, uint32_t imm) { rex(false, 0, 0, dst); byte(0xB8 + (dst & 7)); dword(imm); }
+    void movRaxI64(uint64_t imm) { byte(0x48); byte(0xB8); qword(imm); }
+
+    // 16-bit register ALU ops: opcode is the r/m16, r16 form.
+    void alu16(uint8_t opcode, Reg dst, Reg src) { byte(0x66); rex(false, src, 0, dst); byte(opcode); modrm(3, src, dst); }
+    // 16-bit immediate ALU ops: digit selects add/or/.../cmp.
+    void alu16Imm(unsigned digit, Reg dst, uint16_t imm) { byte(0x66); rex(false, 0, 0, dst); byte(0x81); modrm(3, digit, dst); word(imm); }
+    void shift16Cl(unsigned digit, Reg dst) { byte(0x66); rex(false, 0, 0, dst); byte(0xD3); modrm(3, digit, dst); }
+    void shift16(unsigned digit, Reg dst, uint8_t amount) { byte(0x66); rex(false, 0, 0, dst); byte(0xC1); modrm(3, digit, dst); byte(amount); }
+    void andEcx15() { byte(0x83); byte(0xE1); byte(0x0F); }
+
+    void setcc(Cond cc, Reg dst) { rex(false, 0, 0, dst, true); byte(0x0F); byte(0x90 + cc); modrm(3, 0, dst); }
+    void btZero(Reg r) { rex(false, 0, 0, r); byte(0x0F); byte(0xBA); modrm(3, 4, r); byte(0); }  // CF = bit 0
+    void test8(Reg r) { rex(false, r, 0, r, true); byte(0x84); modrm(3, r, r); }
+
+    // movzx dst32, word [rsi + index*2]
+    void loadWord(Reg dst, Reg index) {
+        rex(false, dst, index, RSI); byte(0x0F); byte(0xB7); modrm(0, dst, 4);
+        byte(static_cast<uint8_t>(1 << 6 | (index & 7) << 3 | RSI));
+    }
+    // mov word [rsi + index*2], src16
+    void storeWord(Reg index, Reg src) {
+        byte(0x66); rex(false, src, index, RSI); byte(0x89); modrm(0, src, 4);
+        byte(static_cast<uint8_t>(1 << 6 | (index & 7) << 3 | RSI));
+    }
+    // cmp byte [rax + index], 0
+    void cmpCodeByte(Reg index) {
+        rex(false, 0, index, RAX); byte(0x80); modrm(0, 7, 4);
+        byte(static_cast<uint8_t>((index & 7) << 3 | RAX));
+        byte(0);
+    }
+
+    void loadState16(Reg dst, uint8_t offset) { rex(false, dst, 0, RDI); byte(0x0F); byte(0xB7); stateOperand(dst, offset); }
+    void loadState8(Reg dst, uint8_t offset) { rex(false, dst, 0, RDI); byte(0x0F); byte(0xB6); stateOperand(dst, offset); }
+    void loadState64(Reg dst, uint8_t offset) { rex(true, dst, 0, RDI); byte(0x8B); stateOperand(dst, offset); }
+    void storeState16(uint8_t offset, Reg src) { byte(0x66); rex(false, src, 0, RDI); byte(0x89); stateOperand(src, offset); }
+    void storeState8(uint8_t offset, Reg src) { rex(false, src, 0, RDI, true); byte(0x88); stateOperand(src, offset); }
+    void storeState64(uint8_t offset, Reg src) { rex(true, src, 0, RDI); byte(0x89); stateOperand(src, offset); }
+    void storeState16(uint8_t offset, uint16_t imm) { byte(0x66); byte(0xC7); stateOperand(0, offset); word(imm); }
+    void storeState8(uint8_t offset, uint8_t imm) { byte(0xC6); stateOperand(0, offset); byte(imm); }
+
+    void subBudget(uint32_t steps) { byte(0x49); byte(0x81); modrm(3, 5, BUDGET); dword(steps); }
+    void addBudget(uint32_t steps) { byte(0x49); byte(0x81); modrm(3, 0, BUDGET); dword(steps); }
+
+    // Jumps with a rel32 that is filled in later; return the rel32's address.
+    uint8_t* jcc(Cond cc) { byte(0x0F); byte(0x80 + cc); uint8_t* at = p; dword(0); return at; }
+    uint8_t* jmp() { byte(0xE9); uint8_t* at = p; dword(0); return at; }
+};
+
+void patchRel32(uint8_t* at, const uint8_t* target) {
+    const int32_t offset = static_cast<int32_t>(target - (at + 4));
+    std::memcpy(at, &offset, 4);
+}
+
+// Exits are emitted after the block body so the fall-through path stays
+// straight.
+struct Stub {
+    enum Kind { EXIT, STORE, BUDGET } kind;
+    uint8_t* jump;          // rel32 that must reach the stub
+    uint16_t pc;            // next pc
+    uint32_t refund;        // STORE/BUDGET: steps given back
+    Reg address;            // STORE: register holding the stored-to address
+};
+
+void setAddFlags(Emitter& e) {
+    e.setcc(CC_B, FLAG_C);
+    e.setcc(CC_E, FLAG_Z);
+    e.setcc(CC_S, FLAG_N);
+}
+
+// qCore c after subtraction is the carry of rX + ~op + 1, i.e. no borrow.
+void setSubFlags(Emitter& e) {
+    e.setcc(CC_AE, FLAG_C);
+    e.setcc(CC_E, FLAG_Z);
+    e.setcc(CC_S, FLAG_N);
+}
+
+void setLogicFlags(Emitter& e) {
+    e.setcc(CC_E, FLAG_Z);
+    e.setcc(CC_S, FLAG_N);
+}
+
+// Jumps to a new exit stub when condition holds (or always for b/bl).
+void emitBranch(Emitter& e, const BlockOp& op, std::vector<Stub>& stubs) {
+    const uint16_t next = static_cast<uint16_t>(op.address + op.steps);
+    if (op.condition == 0 || op.condition == 7) {
+        if (op.condition == 7) {
+            e.movRI(Q[6], next);
+        }
+        stubs.push_back({Stub::EXIT, e.jmp(), op.target, 0, RAX});
+        return;
+    }
+    static const Reg flag[] = {RAX, FLAG_Z, FLAG_Z, FLAG_C, FLAG_C, FLAG_N, FLAG_N};
+    // beq, bcs and bmi branch when their flag is set.
+    const bool whenSet = op.condition == 1 || op.condition == 4 || op.condition == 6;
+    e.test8(flag[op.condition]);
+    stubs.push_back({Stub::EXIT, e.jcc(whenSet ? CC_NE : CC_E), op.target, 0, RAX});
+    stubs.push_back({Stub::EXIT, e.jmp(), next, 0, RAX});
+}
+
+void emitShift(Emitter& e, const BlockOp& op, bool amountInRegister) {
+    static const unsigned digit[] = {4, 5, 7, 1};   // shl, shr, sar, ror
+    const unsigned type = (op.kind - (amountInRegister ? BlockOp::LSL_R : BlockOp::LSL_I)) / 2;
+    // CF ends up as the last bit shifted out (the msb for rotates), which
+    // is qCore c; a shift by 0 leaves CF alone, so it starts out as c.
+    if (amountInRegister) {
+        e.movRR(RCX, Q[op.rY]);
+        e.andEcx15();
+        e.btZero(FLAG_C);
+        e.shift16Cl(digit[type], Q[op.rX]);
+        e.setcc(CC_B, FLAG_C);
+    } else if (op.operand) {
+        e.shift16(digit[type], Q[op.rX], static_cast<uint8_t>(op.operand));
+        e.setcc(CC_B, FLAG_C);
+    }
+    // Shifts by 0 and rotates leave z and n alone: test the result.
+    e.alu16(0x85, Q[op.rX], Q[op.rX]);
+    setLogicFlags(e);
+}
+
+// Stores end with a check of the code map for the stored-to address.
+void emitCodeCheck(Emitter& e, Reg address, uint16_t pc, uint32_t refund, std::vector<Stub>& stubs) {
+    e.loadState64(RAX, STATE_OFFSET(code));
+    e.cmpCodeByte(address);
+    stubs.push_back({Stub::STORE, e.jcc(CC_NE), pc, refund, address});
+}
+
+}
+
+bool JitCompiler::isSupported() {
+    return true;
+}
+
+JitCompiler::JitCompiler() : nativeAt(ADDRESSES, 0), stepsAt(ADDRESSES, 0), hits(ADDRESSES, 0) {
+    void* memory = mmap(nullptr, BUFFER_BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::runtime_error("JIT: could not map a code buffer");
+    }
+    buffer = static_cast<uint8_t*>(memory);
+    capacity = BUFFER_BYTES;
+    writable = true;
+    emitTrampolines();
+    setWritable(false);
+}
+
+JitCompiler::~JitCompiler() {
+    if (buffer) {
+        munmap(buffer, capacity);
+    }
+}
+
+void JitCompiler::setWritable(bool value) {
+    if (writable == value) return;
+    if (mprotect(buffer, capacity, value ? PROT_READ | PROT_WRITE : PROT_READ | PROT_EXEC) != 0) {
+        throw std::runtime_error("JIT: could not change code buffer protection");
+    }
+    writable = value;
+}
+
+// run() enters through the prologue with rdi = State*, rsi = block entry;
+// every exit leaves through the epilogue with rax = patchable exit or null.
+void JitCompiler::emitTrampolines() {
+    static const Reg saved[] = {RBX, RBP, R12, R13, R14, R15};
+    Emitter e(buffer);
+    for (Reg r : saved) e.push(r);
+    e.movRR64(RAX, RSI);
+    for (int i = 0; i < 7; i++) e.loadState16(Q[i], static_cast<uint8_t>(STATE_OFFSET(registers) + 2 * i));
+    e.loadState8(FLAG_Z, STATE_OFFSET(z));
+    e.loadState8(FLAG_N, STATE_OFFSET(n));
+    e.loadState8(FLAG_C, STATE_OFFSET(c));
+    e.loadState64(RSI, STATE_OFFSET(memory));
+    e.loadState64(BUDGET, STATE_OFFSET(budget));
+    e.jmpRax();
+
+    epilogue = e.here();
+    for (int i = 0; i < 7; i++) e.storeState16(static_cast<uint8_t>(STATE_OFFSET(registers) + 2 * i), Q[i]);
+    e.storeState8(STATE_OFFSET(z), FLAG_Z);
+    e.storeState8(STATE_OFFSET(n), FLAG_N);
+    e.storeState8(STATE_OFFSET(c), FLAG_C);
+    e.storeState64(STATE_OFFSET(budget), BUDGET);
+    e.storeState64(STATE_OFFSET(lastExit), RAX);
+    for (int i = 5; i >= 0; i--) e.pop(saved[i]);
+    e.ret();
+    used = codeStart = static_cast<size_t>(e.here() - buffer);
+}
+
+bool JitCompiler::compile(uint16_t pc, const Block& block, const BlockCache& cache) {
+    const BlockOp* ops = cache.opsOf(block);
+    bool compilable = !(block.opCount == 1 && ops[0].kind == BlockOp::GENERIC);
+    for (uint32_t i = 0; i < block.opCount && compilable; i++) {
+        for (unsigned k = 0; k < ops[i].steps; k++) {
+            compilable = compilable && !cache.wasModified(static_cast<uint16_t>(ops[i].address + k));
+        }
+    }
+    if (!compilable) {
+        hits[pc] = UINT32_MAX;
+        return false;
+    }
+    if (used + (block.opCount + 1) * MAX_OP_BYTES > capacity) {
+        flush(generation);
+    }
+
+    setWritable(true);
+    uint8_t* start = buffer + used;
+    Emitter e(start);
+    std::vector<Stub> stubs;
+    e.subBudget(block.steps);
+    stubs.push_back({Stub::BUDGET, e.jcc(CC_B), pc, block.steps, RAX});
+
+    for (uint32_t i = 0; i < block.opCount; i++) {
+        const BlockOp& op = ops[i];
+        const Reg x = op.rX < 7 ? Q[op.rX] : RAX;
+        const Reg y = op.rY < 7 ? Q[op.rY] : RAX;
+        const uint32_t refund = block.steps - op.stepsBefore - 1;
+        switch (op.kind) {
+            case BlockOp::MV_R: e.movRR(x, y); break;
+            case BlockOp::MV_I: e.movRI(x, op.operand); break;
+            case BlockOp::CONST:
+                e.movRI(x, op.operand);
+                e.movRI(FLAG_Z, op.flags & 1);
+                e.movRI(FLAG_N, (op.flags >> 1) & 1);
+                e.movRI(FLAG_C, (op.flags >> 2) & 1);
+                break;
+            case BlockOp::ADD_R: e.alu16(0x01, x, y); setAddFlags(e); break;
+            case BlockOp::ADD_I: e.alu16Imm(0, x, op.operand); setAddFlags(e); break;
+            case BlockOp::SUB_R: e.alu16(0x29, x, y); setSubFlags(e); break;
+            case BlockOp::SUB_I: e.alu16Imm(5, x, op.operand); setSubFlags(e); break;
+            case BlockOp::AND_R: e.alu16(0x21, x, y); setLogicFlags(e); break;
+            case BlockOp::AND_I: e.alu16Imm(4, x, op.operand); setLogicFlags(e); break;
+            case BlockOp::CMP_R: e.alu16(0x39, x, y); setSubFlags(e); break;
+            case BlockOp::CMP_I: e.alu16Imm(7, x, op.operand); setSubFlags(e); break;
+            case BlockOp::XOR_R: e.alu16(0x31, x, y); setLogicFlags(e); break;
+            case BlockOp::LSL_R: case BlockOp::LSR_R: case BlockOp::ASR_R: case BlockOp::ROR_R:
+                emitShift(e, op, true);
+                break;
+            case BlockOp::LSL_I: case BlockOp::LSR_I: case BlockOp::ASR_I: case BlockOp::ROR_I:
+                emitShift(e, op, false);
+                break;
+            case BlockOp::LD: e.loadWord(x, y); break;
+            case BlockOp::POP:
+                e.loadWord(x, Q[5]);
+                e.alu16Imm(0, Q[5], 1);
+                break;
+            case BlockOp::ST:
+                e.storeWord(y, x);
+                emitCodeCheck(e, y, static_cast<uint16_t>(op.address + 1), refund, stubs);
+                break;
+            case BlockOp::PUSH:
+                e.alu16Imm(5, Q[5], 1);
+                e.storeWord(Q[5], x);
+                emitCodeCheck(e, Q[5], static_cast<uint16_t>(op.address + 1), refund, stubs);
+                break;
+            case BlockOp::CMP_R_BRANCH: e.alu16(0x39, x, y); setSubFlags(e); emitBranch(e, op, stubs); break;
+            case BlockOp::CMP_I_BRANCH: e.alu16Imm(7, x, op.operand); setSubFlags(e); emitBranch(e, op, stubs); break;
+            case BlockOp::SUB_I_BRANCH: e.alu16Imm(5, x, op.operand); setSubFlags(e); emitBranch(e, op, stubs); break;
+            case BlockOp::BRANCH: emitBranch(e, op, stubs); break;
+            case BlockOp::FALL_THROUGH:
+                stubs.push_back({Stub::EXIT, e.jmp(), op.target, 0, RAX});
+                break;
+            case BlockOp::GENERIC:
+                // Left to the block engine: give its step back and exit.
+                stubs.push_back({Stub::BUDGET, e.jmp(), op.address, 1, RAX});
+                break;
+        }
+    }
+
+    for (const Stub& stub : stubs) {
+        patchRel32(stub.jump, e.here());
+        if (stub.kind != Stub::EXIT) {
+            e.addBudget(stub.refund);
+        }
+        e.storeState16(STATE_OFFSET(registers) + 2 * 7, stub.pc);
+        if (stub.kind == Stub::STORE) {
+            e.storeState16(STATE_OFFSET(storeAddress), stub.address);
+            e.storeState8(STATE_OFFSET(storedIntoCode), 1);
+        }
+        if (stub.kind == Stub::EXIT) {
+            e.movRaxI64(reinterpret_cast<uint64_t>(stub.jump));
+        } else {
+            e.xorEaxEax();
+        }
+        patchRel32(e.jmp(), epilogue);
+    }
+    setWritable(false);
+
+    used = static_cast<size_t>(e.here() - buffer);
+    nativeAt[pc] = static_cast<uint32_t>(start - buffer);
+    stepsAt[pc] = block.steps;
+    entries.push_back(pc);
+    return true;
+}
+
+void JitCompiler::run(State& state, uint16_t pc) {
+    using Entry = void (*)(State*, const uint8_t*);
+    state.storedIntoCode = 0;
+    state.lastExit = nullptr;
+    reinterpret_cast<Entry>(buffer)(&state, buffer + nativeAt[pc]);
+}
+
+void JitCompiler::chain(uint8_t* exit, uint16_t pc) {
+    if (!nativeAt[pc]) return;
+    setWritable(true);
+    patchRel32(exit, buffer + nativeAt[pc]);
+    setWritable(false);
+}
+
+void JitCompiler::flush(uint32_t cacheGeneration) {
+    for (uint16_t entry : entries) {
+        nativeAt[entry] = 0;
+        stepsAt[entry] = 0;
+    }
+    entries.clear();
+    std::fill(hits.begin(), hits.end(), 0);
+    used = codeStart;
+    generation = cacheGeneration;
+}
+
+#else
+
+bool JitCompiler::isSupported() {
+    return false;
+}
+
+JitCompiler::JitCompiler() : nativeAt(ADDRESSES, 0), stepsAt(ADDRESSES, 0), hits(ADDRESSES, 0) {}
+JitCompiler::~JitCompiler() {}
+void JitCompiler::setWritable(bool) {}
+void JitCompiler::emitTrampolines() {}
+
+bool JitCompiler::compile(uint16_t pc, const Block&, const BlockCache&) {
+    hits[pc] = UINT32_MAX;
+    return false;
+}
+
+void JitCompiler::run(State&, uint16_t) {}
+void JitCompiler::chain(uint8_t*, uint16_t) {}
+
+void JitCompiler::flush(uint32_t cacheGeneration) {
+    generation = cacheGeneration;
+}
+
+#endif
@@ -0,0 +1,95 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: x86-64 code generation for the simulator's JIT engine (Linux
+//              only; isSupported() is false elsewhere and Engine::JIT runs as
+//              Engine::BLOCKS). Hot blocks from the BlockCache are compiled
+//              into an mmap'd buffer that is writable only while code is
+//              emitted or patched.
+//
+//              Host register assignment inside compiled code:
+//                r8w..r14w  qCore r0..r6 (pc only exists at block exits)
+//                bl bpl dl  z, n, c as 0/1
+//                rsi        qCore memory, rdi the State below
+//                r15        steps left; every block subtracts its length
+//                           on entry and leaves before running if short
+//              A block exit stores the next pc and returns to the dispatcher
+//              with the address of its jump, which is patched to jump
+//              straight into the target block once that is compiled. Stores
+//              into translated code leave through a separate exit so the
+//              caches can be dropped; blocks containing addresses the
+//              program has written to are never compiled again and keep
+//              running in the block engine.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "BlockCache.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class JitCompiler {
+public:
+    static constexpr unsigned DEFAULT_THRESHOLD = 8;
+
+    // Machine state handed to and returned from compiled code.
+    struct State {
+        uint16_t registers[8];
+        uint8_t z, n, c;
+        uint8_t storedIntoCode;     // set by the self-modifying-code exit
+        uint16_t storeAddress;
+        uint16_t padding;
+        uint16_t* memory;
+        const uint8_t* code;        // BlockCache::codeMap()
+        uint64_t budget;
+        uint8_t* lastExit;          // patchable rel32 of the exit taken, or null
+    };
+
+private:
+    uint8_t* buffer = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t codeStart = 0;               // after the entry/exit trampolines
+    uint8_t* epilogue = nullptr;
+    bool writable = false;
+
+    std::vector<uint32_t> nativeAt;     // buffer offset per entry pc, 0 = none
+    std::vector<uint32_t> stepsAt;      // block length of compiled entries
+    std::vector<uint32_t> hits;         // block-engine executions per entry pc
+    std::vector<uint16_t> entries;
+    uint32_t generation = 0;            // of the BlockCache the code came from
+    unsigned threshold = DEFAULT_THRESHOLD;
+
+    void setWritable(bool value);
+    void emitTrampolines();
+
+public:
+    static bool isSupported();
+
+    JitCompiler();
+    ~JitCompiler();
+    JitCompiler(const JitCompiler&) = delete;
+    JitCompiler& operator=(const JitCompiler&) = delete;
+
+    void setThreshold(unsigned executions) { threshold = executions; }
+
+    // Steps of the compiled block at pc, 0 when there is none.
+    uint32_t compiledSteps(uint16_t pc) const { return stepsAt[pc]; }
+    // Counts one block-engine run of the block at pc; true when it has run
+    // often enough to be compiled.
+    bool isHot(uint16_t pc) {
+        return hits[pc] != UINT32_MAX && ++hits[pc] >= threshold;
+    }
+    // Compiles block (translated at pc by cache). Returns false, and never
+    // tries again until the next flush, when the block cannot be compiled.
+    bool compile(uint16_t pc, const Block& block, const BlockCache& cache);
+    // Runs compiled code from pc until it leaves through an exit.
+    void run(State& state, uint16_t pc);
+    // Points the exit behind state.lastExit at the compiled block at pc.
+    void chain(uint8_t* exit, uint16_t pc);
+
+    // Drops all compiled code; cacheGeneration is the BlockCache generation
+    // that new code will be compiled from.
+    void flush(uint32_t cacheGeneration);
+    uint32_t getGeneration() const { return generation; }
+};
@@ -0,0 +1,161 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: One 16-bit value per simulator lane for LockstepSimulator:
+//              16 lanes in an AVX2 register, 8 lanes in an SSE2 register, or
+//              8 lanes in a plain array when the compiler targets neither (or
+//              SBASM_SIMULATOR_SCALAR is defined). Masks are lanes of 0 or
+//              0xFFFF, as the SIMD compares produce them.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+
+#if !defined(SBASM_SIMULATOR_SCALAR) && (defined(__GNUC__) || defined(__clang__))
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SBASM_LANES_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SBASM_LANES_SSE2 1
+#endif
+#endif
+
+namespace lanes {
+
+#if defined(SBASM_LANES_AVX2)
+constexpr int COUNT = 16;
+#else
+constexpr int COUNT = 8;
+#endif
+
+using Bits = uint32_t;      // one bit per lane, lane 0 in bit 0
+
+struct Vector {
+#if defined(SBASM_LANES_AVX2)
+    __m256i v;
+#elif defined(SBASM_LANES_SSE2)
+    __m128i v;
+#else
+    uint16_t v[COUNT];
+#endif
+};
+
+#if defined(SBASM_LANES_AVX2)
+
+inline Vector splat(uint16_t x) { return {_mm256_set1_epi16(static_cast<short>(x))}; }
+inline Vector load(const uint16_t* p) { return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))}; }
+inline void store(uint16_t* p, Vector a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a.v); }
+inline Vector add(Vector a, Vector b) { return {_mm256_add_epi16(a.v, b.v)}; }
+inline Vector sub(Vector a, Vector b) { return {_mm256_sub_epi16(a.v, b.v)}; }
+inline Vector bitAnd(Vector a, Vector b) { return {_mm256_and_si256(a.v, b.v)}; }
+inline Vector bitOr(Vector a, Vector b) { return {_mm256_or_si256(a.v, b.v)}; }
+inline Vector bitXor(Vector a, Vector b) { return {_mm256_xor_si256(a.v, b.v)}; }
+inline Vector equal(Vector a, Vector b) { return {_mm256_cmpeq_epi16(a.v, b.v)}; }
+inline Vector select(Vector mask, Vector a, Vector b) { return {_mm256_blendv_epi8(b.v, a.v, mask.v)}; }
+inline Vector saturatingAdd(Vector a, Vector b) { return {_mm256_adds_epu16(a.v, b.v)}; }
+inline Vector saturatingSub(Vector a, Vector b) { return {_mm256_subs_epu16(a.v, b.v)}; }
+inline Vector signMask(Vector a) { return {_mm256_srai_epi16(a.v, 15)}; }
+inline Vector shiftLeft(Vector a, int n) { return {_mm256_sll_epi16(a.v, _mm_cvtsi32_si128(n))}; }
+inline Vector shiftRight(Vector a, int n) { return {_mm256_srl_epi16(a.v, _mm_cvtsi32_si128(n))}; }
+inline Vector shiftRightSigned(Vector a, int n) { return {_mm256_sra_epi16(a.v, _mm_cvtsi32_si128(n))}; }
+inline Bits bits(Vector mask) {
+    const __m128i packed = _mm_packs_epi16(_mm256_castsi256_si128(mask.v), _mm256_extracti128_si256(mask.v, 1));
+    return static_cast<Bits>(_mm_movemask_epi8(packed));
+}
+
+#elif defined(SBASM_LANES_SSE2)
+
+inline Vector splat(uint16_t x) { return {_mm_set1_epi16(static_cast<short>(x))}; }
+inline Vector load(const uint16_t* p) { return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))}; }
+inline void store(uint16_t* p, Vector a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a.v); }
+inline Vector add(Vector a, Vector b) { return {_mm_add_epi16(a.v, b.v)}; }
+inline Vector sub(Vector a, Vector b) { return {_mm_sub_epi16(a.v, b.v)}; }
+inline Vector bitAnd(Vector a, Vector b) { return {_mm_and_si128(a.v, b.v)}; }
+inline Vector bitOr(Vector a, Vector b) { return {_mm_or_si128(a.v, b.v)}; }
+inline Vector bitXor(Vector a, Vector b) { return {_mm_xor_si128(a.v, b.v)}; }
+inline Vector equal(Vector a, Vector b) { return {_mm_cmpeq_epi16(a.v, b.v)}; }
+inline Vector select(Vector mask, Vector a, Vector b) {
+    return {_mm_or_si128(_mm_and_si128(mask.v, a.v), _mm_andnot_si128(mask.v, b.v))};
+}
+inline Vector saturatingAdd(Vector a, Vector b) { return {_mm_adds_epu16(a.v, b.v)}; }
+inline Vector saturatingSub(Vector a, Vector b) { return {_mm_subs_epu16(a.v, b.v)}; }
+inline Vector signMask(Vector a) { return {_mm_srai_epi16(a.v, 15)}; }
+inline Vector shiftLeft(Vector a, int n) { return {_mm_sll_epi16(a.v, _mm_cvtsi32_si128(n))}; }
+inline Vector shiftRight(Vector a, int n) { return {_mm_srl_epi16(a.v, _mm_cvtsi32_si128(n))}; }
+inline Vector shiftRightSigned(Vector a, int n) { return {_mm_sra_epi16(a.v, _mm_cvtsi32_si128(n))}; }
+inline Bits bits(Vector mask) {
+    return static_cast<Bits>(_mm_movemask_epi8(_mm_packs_epi16(mask.v, _mm_setzero_si128())));
+}
+
+#else
+
+template <typename Op>
+inline Vector map(Vector a, Vector b, Op op) {
+    Vector result;
+    for (int i = 0; i < COUNT; i++) result.v[i] = static_cast<uint16_t>(op(a.v[i], b.v[i]));
+    return result;
+}
+
+inline Vector splat(uint16_t x) {
+    Vector result;
+    for (int i = 0; i < COUNT; i++) result.v[i] = x;
+    return result;
+}
+inline Vector load(const uint16_t* p) {
+    Vector result;
+    for (int i = 0; i < COUNT; i++) result.v[i] = p[i];
+    return result;
+}
+inline void store(uint16_t* p, Vector a) {
+    for (int i = 0; i < COUNT; i++) p[i] = a.v[i];
+}
+inline Vector add(Vector a, Vector b) { return map(a, b, [](unsigned x, unsigned y) { return x + y; }); }
+inline Vector sub(Vector a, Vector b) { return map(a, b, [](unsigned x, unsigned y) { return x - y; }); }
+inline Vector bitAnd(Vector a, Vector b) { return map(a, b, [](unsigned x, unsigned y) { return x & y; }); }
+inline Vector bitOr(Vector a, Vector b) { return map(a, b, [](unsigned x, unsigned y) { return x | y; }); }
+inline Vector bitXor(Vector a, Vector b) { return map(a, b, [](unsigned x, unsigned y) { return x ^ y; }); }
+inline Vector equal(Vector a, Vector b) { return map(a, b, [](unsigned x, unsigned y) { return x == y ? 0xFFFF : 0; }); }
+inline Vector select(Vector mask, Vector a, Vector b) {
+    return bitOr(bitAnd(mask, a), map(mask, b, [](unsigned m, unsigned y) { return ~m & y; }));
+}
+inline Vector saturatingAdd(Vector a, Vector b) {
+    return map(a, b, [](unsigned x, unsigned y) { return x + y > 0xFFFF ? 0xFFFF : x + y; });
+}
+inline Vector saturatingSub(Vector a, Vector b) { return map(a, b, [](unsigned x, unsigned y) { return x > y ? x - y : 0; }); }
+inline Vector signMask(Vector a) { return map(a, a, [](unsigned x, unsigned) { return (x & 0x8000) ? 0xFFFF : 0; }); }
+inline Vector shiftLeft(Vector a, int n) { return map(a, a, [n](unsigned x, unsigned) { return n > 15 ? 0 : x << n; }); }
+inline Vector shiftRight(Vector a, int n) { return map(a, a, [n](unsigned x, unsigned) { return n > 15 ? 0 : x >> n; }); }
+inline Vector shiftRightSigned(Vector a, int n) {
+    return map(a, a, [n](unsigned x, unsigned) { return static_cast<int16_t>(x) >> (n > 15 ? 15 : n); });
+}
+inline Bits bits(Vector mask) {
+    Bits result = 0;
+    for (int i = 0; i < COUNT; i++) result |= (mask.v[i] ? 1u : 0u) << i;
+    return result;
+}
+
+#endif
+
+inline Vector zero() { return splat(0); }
+inline Vector ones() { return splat(0xFFFF); }
+inline Vector invert(Vector a) { return bitXor(a, ones()); }
+
+// Lane mask with 0xFFFF in every lane whose bit is set.
+inline Vector maskOf(Bits lanes) {
+    uint16_t values[COUNT];
+    for (int i = 0; i < COUNT; i++) values[i] = (lanes >> i & 1) ? 0xFFFF : 0;
+    return load(values);
+}
+
+inline int firstLane(Bits lanes) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(lanes);
+#else
+    int lane = 0;
+    while (!(lanes >> lane & 1)) lane++;
+    return lane;
+#endif
+}
+
+}
@@ -0,0 +1,349 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "LockstepSimulator.h"
+#include <algorithm>
+
+using namespace lanes;
+
+namespace {
+constexpr uint16_t BRANCH_TO_SELF = 0x21FF;
+constexpr uint16_t HALT_MASK = 0xE1F0;
+constexpr int SP = Simulator::SP;
+constexpr int LR = Simulator::LR;
+constexpr int PC = Simulator::PC;
+
+inline uint16_t signExtend9(uint16_t instr) {
+    return (instr & 0x100) ? (instr | 0xFE00) : (instr & 0x1FF);
+}
+
+inline uint16_t shiftWord(uint16_t value, unsigned type, unsigned amount) {
+    switch (type) {
+        case 0: return static_cast<uint16_t>(value << amount);
+        case 1: return static_cast<uint16_t>(value >> amount);
+        case 2: return static_cast<uint16_t>(static_cast<int16_t>(value) >> amount);
+        default: return amount ? static_cast<uint16_t>((value >> amount) | (value << (16 - amount))) : value;
+    }
+}
+
+inline Vector shiftLanes(Vector value, unsigned type, unsigned amount) {
+    switch (type) {
+        case 0: return shiftLeft(value, amount);
+        case 1: return shiftRight(value, amount);
+        case 2: return shiftRightSigned(value, amount);
+        default: return bitOr(shiftRight(value, amount), shiftLeft(value, 16 - amount));    // << 16 gives 0
+    }
+}
+
+// The last bit shifted out, as in Simulator; amount is not 0.
+inline bool shiftCarry(uint16_t value, unsigned type, unsigned amount) {
+    return type == 0 ? (value >> (16 - amount)) & 1 : (value >> (amount - 1)) & 1;
+}
+
+inline Vector carryLanes(Vector value, unsigned type, unsigned amount) {
+    const Vector bit = type == 0 ? shiftRight(value, 16 - amount) : shiftRight(value, amount - 1);
+    return sub(zero(), bitAnd(bit, splat(1)));      // 1 -> 0xFFFF
+}
+
+// True when every lane of group holds the same value as the first one.
+inline bool isUniform(Vector values, const uint16_t* stored, Bits group) {
+    return (bits(equal(values, splat(stored[firstLane(group)]))) & group) == group;
+}
+}
+
+LockstepSimulator::LockstepSimulator() : memory(Simulator::MEMORY_WORDS * LANES) {
+    load({}, {});
+}
+
+void LockstepSimulator::load(const std::vector<uint16_t>& words, const std::vector<Segment>& segments) {
+    std::fill(memory.begin(), memory.end(), 0);
+    for (const auto& segment : segments) {
+        const size_t length = std::min(static_cast<size_t>(segment.length),
+                                       Simulator::MEMORY_WORDS - static_cast<size_t>(segment.base));
+        for (size_t i = 0; i < length; i++) {
+            store(&memory[(segment.base + i) * LANES], splat(words[segment.offset + i]));
+        }
+    }
+    for (auto& reg : registers) {
+        std::fill(reg, reg + LANES, 0);
+    }
+    std::fill(z, z + LANES, 0);
+    std::fill(n, n + LANES, 0);
+    std::fill(c, c + LANES, 0);
+}
+
+void LockstepSimulator::run(const uint64_t* maxSteps, Simulator::RunResult* results) {
+    uint64_t steps[LANES] = {};
+    Bits active = 0;
+    for (int lane = 0; lane < LANES; lane++) {
+        if (maxSteps[lane]) {
+            active |= 1u << lane;
+        } else {
+            results[lane] = {Simulator::StopReason::STEP_LIMIT, 0};
+        }
+    }
+    divergentSteps = 0;
+
+    // While all running lanes execute together their step counts move as
+    // one: pending is added to each of them only when the group changes or
+    // budget (the steps until the first of them reaches its limit) runs out.
+    uint64_t pending = 0;
+    uint64_t budget = 0;
+    auto flush = [&]() {
+        budget = UINT64_MAX;
+        for (Bits b = active; b; b &= b - 1) {
+            const int lane = firstLane(b);
+            steps[lane] += pending;
+            budget = std::min(budget, maxSteps[lane] - steps[lane]);
+        }
+        pending = 0;
+    };
+    auto stop = [&](Bits stopped, Simulator::StopReason reason) {
+        for (Bits b = stopped; b; b &= b - 1) {
+            const int lane = firstLane(b);
+            results[lane] = {reason, steps[lane]};
+        }
+        active &= ~stopped;
+    };
+    flush();
+
+    Bits group = 0;
+    Vector mask = zero();
+    int common = -1;    // pc of every running lane when step() could tell
+    while (active) {
+        uint16_t pc;
+        Bits next = active;
+        if (common >= 0) {
+            pc = static_cast<uint16_t>(common);
+        } else {
+            // Lanes at the lowest pc go first; usually that is all of them.
+            const Vector pcs = lanes::load(registers[PC]);
+            pc = registers[PC][firstLane(active)];
+            next = bits(equal(pcs, splat(pc))) & active;
+            if (next != active) {
+                for (Bits b = active; b; b &= b - 1) {
+                    pc = std::min(pc, registers[PC][firstLane(b)]);
+                }
+                next = bits(equal(pcs, splat(pc))) & active;
+            }
+        }
+        const uint16_t* row = &memory[size_t(pc) * LANES];
+        const uint16_t instr = row[firstLane(next)];
+        next &= bits(equal(lanes::load(row), splat(instr)));     // lanes that rewrote this word wait
+        if (next != group) {
+            group = next;
+            mask = maskOf(group);
+        }
+
+        const bool halts = instr == BRANCH_TO_SELF || ((instr & HALT_MASK) == HALT_MASK && !(instr & 0x1000));
+        common = -1;
+        if (!halts) {
+            const int after = step(instr, pc, mask, group);
+            if (group == active) {
+                common = after;     // lanes that stop below do not change it
+            }
+        }
+
+        if (group == active) {
+            pending++;
+            if (halts) {
+                flush();
+                stop(group, instr == BRANCH_TO_SELF ? Simulator::StopReason::BRANCH_TO_SELF
+                                                    : Simulator::StopReason::HALT);
+            } else if (pending == budget) {
+                flush();
+                Bits limited = 0;
+                for (Bits b = active; b; b &= b - 1) {
+                    const int lane = firstLane(b);
+                    if (steps[lane] == maxSteps[lane]) limited |= 1u << lane;
+                }
+                stop(limited, Simulator::StopReason::STEP_LIMIT);
+            }
+        } else {
+            divergentSteps++;
+            flush();
+            Bits limited = 0;
+            for (Bits b = group; b; b &= b - 1) {
+                const int lane = firstLane(b);
+                if (++steps[lane] == maxSteps[lane]) limited |= 1u << lane;
+            }
+            if (halts) {
+                stop(group, instr == BRANCH_TO_SELF ? Simulator::StopReason::BRANCH_TO_SELF
+                                                    : Simulator::StopReason::HALT);
+            } else {
+                stop(limited, Simulator::StopReason::STEP_LIMIT);
+            }
+        }
+        if (pending == 0) {
+            flush();
+        }
+    }
+}
+
+// One instruction for the lanes in group (mask has 0xFFFF in exactly those),
+// with the semantics of Simulator::execute. Returns the pc all of them go to
+// next, or -1 when that may differ per lane.
+int LockstepSimulator::step(uint16_t instr, uint16_t pc, Vector mask, Bits group) {
+    auto write = [&](int index, Vector value) {
+        store(registers[index], select(mask, value, lanes::load(registers[index])));
+    };
+    auto setZN = [&](Vector value) {
+        store(z, select(mask, equal(value, zero()), lanes::load(z)));
+        store(n, select(mask, signMask(value), lanes::load(n)));
+    };
+    auto subtract = [&](Vector a, Vector b) {
+        const Vector result = sub(a, b);
+        store(c, select(mask, equal(saturatingSub(b, a), zero()), lanes::load(c)));    // no borrow: a >= b
+        setZN(result);
+        return result;
+    };
+
+    write(PC, splat(static_cast<uint16_t>(pc + 1)));
+    int next = static_cast<uint16_t>(pc + 1);
+    const unsigned rX = (instr >> 9) & 7;
+    const bool immediate = (instr & 0x1000) != 0;
+    const Vector operand = immediate ? splat(signExtend9(instr)) : lanes::load(registers[instr & 7]);
+
+    switch (instr >> 13) {
+        case 0:     // mv
+            write(rX, operand);
+            break;
+        case 1:
+            if (immediate) {    // mvt
+                write(rX, splat(static_cast<uint16_t>((instr & 0xFF) << 8)));
+            } else {            // b<cond>, cond in the rX field
+                Vector take;
+                switch (rX) {
+                    case 1: take = lanes::load(z); break;
+                    case 2: take = invert(lanes::load(z)); break;
+                    case 3: take = invert(lanes::load(c)); break;
+                    case 4: take = lanes::load(c); break;
+                    case 5: take = invert(lanes::load(n)); break;
+                    case 6: take = lanes::load(n); break;
+                    default: take = ones(); break;
+                }
+                take = bitAnd(take, mask);
+                if (rX == 7) {
+                    store(registers[LR], select(take, splat(static_cast<uint16_t>(pc + 1)), lanes::load(registers[LR])));
+                }
+                const uint16_t target = static_cast<uint16_t>(pc + 1 + signExtend9(instr));
+                store(registers[PC], select(take, splat(target), lanes::load(registers[PC])));
+                const Bits taken = bits(take);
+                next = taken == group ? target : taken ? -1 : next;
+            }
+            break;
+        case 2: {   // add
+            const Vector a = lanes::load(registers[rX]);
+            const Vector result = add(a, operand);
+            store(c, select(mask, invert(equal(saturatingAdd(a, operand), result)), lanes::load(c)));
+            write(rX, result);
+            setZN(result);
+            break;
+        }
+        case 3:     // sub
+            write(rX, subtract(lanes::load(registers[rX]), operand));
+            break;
+        case 4:
+            if (immediate) {    // pop
+                write(rX, gather(lanes::load(registers[SP]), group));
+                write(SP, add(lanes::load(registers[SP]), splat(1)));
+            } else {            // ld
+                write(rX, gather(operand, group));
+            }
+            break;
+        case 5:
+            if (immediate) {    // push
+                write(SP, sub(lanes::load(registers[SP]), splat(1)));
+                scatter(lanes::load(registers[SP]), lanes::load(registers[rX]), mask, group);
+            } else {            // st
+                scatter(operand, lanes::load(registers[rX]), mask, group);
+            }
+            break;
+        case 6: {   // and
+            const Vector result = bitAnd(lanes::load(registers[rX]), operand);
+            write(rX, result);
+            setZN(result);
+            break;
+        }
+        case 7:
+            if (immediate || !(instr & 0x100)) {    // cmp
+                subtract(lanes::load(registers[rX]), operand);
+            } else if ((instr & 0xF0) == 0x10) {    // xor
+                const Vector result = bitXor(lanes::load(registers[rX]), operand);
+                write(rX, result);
+                setZN(result);
+            } else {                                // lsl, lsr, asr, ror
+                const unsigned type = (instr >> 5) & 3;
+                const Vector value = lanes::load(registers[rX]);
+                Vector result;
+                Vector carry = lanes::load(c);      // kept by shifts of 0
+                auto shiftAll = [&](unsigned amount) {
+                    result = shiftLanes(value, type, amount);
+                    if (amount) carry = carryLanes(value, type, amount);
+                };
+                if (instr & 0x80) {
+                    shiftAll(instr & 0xF);
+                } else {
+                    const Vector amounts = bitAnd(operand, splat(0xF));
+                    uint16_t amount[LANES];
+                    store(amount, amounts);
+                    if (isUniform(amounts, amount, group)) {
+                        shiftAll(amount[firstLane(group)]);
+                    } else {
+                        uint16_t words[LANES], carries[LANES];
+                        store(words, value);
+                        store(carries, carry);
+                        for (int lane = 0; lane < LANES; lane++) {
+                            if (amount[lane]) carries[lane] = shiftCarry(words[lane], type, amount[lane]) ? 0xFFFF : 0;
+                            words[lane] = shiftWord(words[lane], type, amount[lane]);
+                        }
+                        result = lanes::load(words);
+                        carry = lanes::load(carries);
+                    }
+                }
+                store(c, select(mask, carry, lanes::load(c)));
+                write(rX, result);
+                setZN(result);
+            }
+            break;
+    }
+
+    // Anything else that wrote pc leaves it per lane.
+    const unsigned op = instr >> 13;
+    const bool keepsRX = (op == 1 && !immediate) || op == 5 || (op == 7 && (immediate || !(instr & 0x100)));
+    return rX == PC && !keepsRX ? -1 : next;
+}
+
+// The word at addresses[lane] of each lane in group. One row load when all
+// of them read the same address.
+Vector LockstepSimulator::gather(Vector addresses, Bits group) const {
+    uint16_t address[LANES];
+    store(address, addresses);
+    if (isUniform(addresses, address, group)) {
+        return lanes::load(&memory[size_t(address[firstLane(group)]) * LANES]);
+    }
+    uint16_t words[LANES] = {};
+    for (Bits b = group; b; b &= b - 1) {
+        const int lane = firstLane(b);
+        words[lane] = memory[size_t(address[lane]) * LANES + lane];
+    }
+    return lanes::load(words);
+}
+
+void LockstepSimulator::scatter(Vector addresses, Vector values, Vector mask, Bits group) {
+    uint16_t address[LANES];
+    store(address, addresses);
+    if (isUniform(addresses, address, group)) {
+        uint16_t* row = &memory[size_t(address[firstLane(group)]) * LANES];
+        store(row, select(mask, values, lanes::load(row)));
+        return;
+    }
+    uint16_t words[LANES];
+    store(words, values);
+    for (Bits b = group; b; b &= b - 1) {
+        const int lane = firstLane(b);
+        memory[size_t(address[lane]) * LANES + lane] = words[lane];
+    }
+}
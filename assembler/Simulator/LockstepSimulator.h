@@ -0,0 +1,67 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Runs LANES independent qCore machines on one program in
+//              lockstep, one machine per SIMD lane (see LaneVector.h). Every
+//              step executes one instruction for all lanes that are at the
+//              same pc and fetch the same word there; the others are masked
+//              out. When lanes disagree (a data-dependent branch, a jump
+//              through a register, self-modifying code) the lanes at the
+//              lowest pc run first, so the ones left behind catch up and the
+//              group joins again at the next common pc.
+//
+//              Memory is interleaved by lane (word a of lane l is at
+//              a * LANES + l), so an access to the same address in every lane,
+//              and the instruction fetch, are one vector load or store.
+//              Results are exactly those of Simulator::run per lane,
+//              including the step counts and stop reasons.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "LaneVector.h"
+#include "Simulator.h"
+#include <cstdint>
+#include <vector>
+
+class LockstepSimulator {
+public:
+    static constexpr int LANES = lanes::COUNT;
+
+private:
+    std::vector<uint16_t> memory;           // MEMORY_WORDS * LANES, interleaved
+    uint16_t registers[8][LANES];
+    uint16_t z[LANES], n[LANES], c[LANES];  // 0 or 0xFFFF
+    uint64_t divergentSteps = 0;
+
+    int step(uint16_t instr, uint16_t pc, lanes::Vector mask, lanes::Bits group);
+    lanes::Vector gather(lanes::Vector addresses, lanes::Bits group) const;
+    void scatter(lanes::Vector addresses, lanes::Vector values, lanes::Vector mask, lanes::Bits group);
+
+public:
+    LockstepSimulator();
+
+    // Clears every lane and places each segment of an assembled image at its
+    // base in all of them.
+    void load(const std::vector<uint16_t>& words, const std::vector<Segment>& segments);
+
+    // Runs every lane like Simulator::run(maxSteps[lane]) and stores its
+    // result in results[lane]; both arrays have LANES entries. Lanes with
+    // a limit of 0 do not run (STEP_LIMIT after 0 steps).
+    void run(const uint64_t* maxSteps, Simulator::RunResult* results);
+
+    // Steps of the last run() executed for only part of the running lanes.
+    uint64_t getDivergentSteps() const { return divergentSteps; }
+
+    uint16_t getRegister(int lane, int index) const { return registers[index & 7][lane]; }
+    void setRegister(int lane, int index, uint16_t value) { registers[index & 7][lane] = value; }
+    uint16_t readMemory(int lane, uint16_t address) const { return memory[size_t(address) * LANES + lane]; }
+    void writeMemory(int lane, uint16_t address, uint16_t value) { memory[size_t(address) * LANES + lane] = value; }
+    bool zeroFlag(int lane) const { return z[lane] != 0; }
+    bool negativeFlag(int lane) const { return n[lane] != 0; }
+    bool carryFlag(int lane) const { return c[lane] != 0; }
+    void setFlags(int lane, bool zero, bool negative, bool carry) {
+        z[lane] = zero ? 0xFFFF : 0;
+        n[lane] = negative ? 0xFFFF : 0;
+        c[lane] = carry ? 0xFFFF : 0;
+    }
+};
@@ -0,0 +1,98 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "Profiler.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+static bool isBranchWord(uint16_t word) {
+    return (word & 0xF000) == 0x2000;
+}
+
+std::vector<LineProfile> profileLines(const AssembleResult& result, const Simulator::Profile& profile,
+                                      size_t lineCount) {
+    std::vector<LineProfile> lines(lineCount);
+    for (const auto& row : result.lineTable) {
+        if (row.line < 1 || static_cast<size_t>(row.line) > lineCount) {
+            continue;
+        }
+        const long index = wordIndex(result.segments, row.address);
+        if (index < 0 || result.isData[index]) {
+            continue;
+        }
+
+        // A statement's words run in sequence, so its first word's count
+        // is the statement's count.
+        LineProfile& line = lines[row.line - 1];
+        const uint16_t word = result.words[index];
+        line.hasCode = true;
+        line.executions = std::max(line.executions, profile.executions[row.address]);
+        if (isBranchWord(word)) {
+            const unsigned condition = (word >> 9) & 7;
+            line.isBranch = true;
+            line.isConditional = condition != 0 && condition != 7;
+            line.taken += profile.taken[row.address];
+            line.notTaken += profile.notTaken[row.address];
+        }
+    }
+    return lines;
+}
+
+CoverageSummary summarizeCoverage(const std::vector<LineProfile>& lines) {
+    CoverageSummary summary;
+    for (const auto& line : lines) {
+        if (!line.hasCode) continue;
+        summary.codeLines++;
+        if (line.executions) summary.executedLines++;
+        if (line.isConditional) {
+            summary.conditionalBranches++;
+            if (line.taken && line.notTaken) summary.branchesBothWays++;
+            if (!line.executions) summary.branchesNeverExecuted++;
+        }
+    }
+    return summary;
+}
+
+static std::string percent(size_t part, size_t whole) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1) << (whole ? 100.0 * part / whole : 100.0) << "%";
+    return text.str();
+}
+
+void writeProfileReport(std::ostream& out, const std::string& source, const AssembleResult& result,
+                        const Simulator::Profile& profile, const Simulator::RunResult& run) {
+    std::vector<std::string> text;
+    std::istringstream in(source);
+    for (std::string line; std::getline(in, line); ) {
+        text.push_back(line);
+    }
+    std::vector<LineProfile> lines = profileLines(result, profile, text.size());
+
+    // executions | taken/not taken | line | source; "-" marks lines without
+    // code and "#####" code that never ran, as gcov does.
+    for (size_t i = 0; i < text.size(); i++) {
+        const LineProfile& line = lines[i];
+        std::string branch;
+        if (line.isConditional) {
+            branch = std::to_string(line.taken) + "/" + std::to_string(line.notTaken);
+        }
+        out << std::setw(12) << (!line.hasCode ? "-" : line.executions ? std::to_string(line.executions) : "#####")
+            << " " << std::setw(15) << branch
+            << " " << std::setw(5) << (i + 1) << ": " << text[i] << "\n";
+    }
+
+    CoverageSummary summary = summarizeCoverage(lines);
+    const char* reason = run.reason == Simulator::StopReason::HALT ? "halt"
+                       : run.reason == Simulator::StopReason::BRANCH_TO_SELF ? "branch to self"
+                       : "step limit";
+    out << "\nCoverage summary:\n"
+        << "  Instructions executed: " << run.steps << " (stopped at " << reason << ")\n"
+        << "  Lines executed:        " << summary.executedLines << " of " << summary.codeLines
+        << " (" << percent(summary.executedLines, summary.codeLines) << ")\n"
+        << "  Branches both ways:    " << summary.branchesBothWays << " of " << summary.conditionalBranches
+        << " (" << percent(summary.branchesBothWays, summary.conditionalBranches) << ")\n"
+        << "  Branches never run:    " << summary.branchesNeverExecuted << "\n";
+}
@@ -0,0 +1,41 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Maps the simulator's per-address counters back to source
+//              lines through the assembler's line table and prints a
+//              gcov-style annotated listing and a coverage summary.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "Assembler/Assembler.h"
+#include "Simulator.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct LineProfile {
+    bool hasCode = false;       // emits at least one instruction word
+    bool isBranch = false;
+    bool isConditional = false;
+    uint64_t executions = 0;
+    uint64_t taken = 0;
+    uint64_t notTaken = 0;
+};
+
+struct CoverageSummary {
+    size_t codeLines = 0;
+    size_t executedLines = 0;
+    size_t conditionalBranches = 0;
+    size_t branchesBothWays = 0;      // taken and not taken at least once
+    size_t branchesNeverExecuted = 0;
+};
+
+// One entry per source line (index 0 is line 1). result must have been
+// assembled with AssembleOptions::debugInfo so that lineTable is filled.
+std::vector<LineProfile> profileLines(const AssembleResult& result, const Simulator::Profile& profile,
+                                      size_t lineCount);
+
+CoverageSummary summarizeCoverage(const std::vector<LineProfile>& lines);
+
+void writeProfileReport(std::ostream& out, const std::string& source, const AssembleResult& result,
+                        const Simulator::Profile& profile, const Simulator::RunResult& run);
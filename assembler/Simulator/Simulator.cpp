@@ -0,0 +1,438 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "Simulator.h"
+#include <algorithm>
+
+constexpr size_t Simulator::MEMORY_WORDS;
+
+namespace {
+constexpr uint16_t BRANCH_TO_SELF = 0x21FF;     // b with offset -1
+constexpr uint16_t HALT_MASK = 0xE1F0;
+
+struct NoHooks {
+    void execute(uint16_t) {}
+    void branch(uint16_t, bool) {}
+    void store(uint16_t) {}
+};
+
+// Interpreted steps of a BLOCKS run: stores into translated code drop the cache.
+struct CodeWatchHooks {
+    BlockCache* cache;
+
+    void execute(uint16_t) {}
+    void branch(uint16_t, bool) {}
+    void store(uint16_t address) {
+        if (cache->isCode(address)) cache->invalidate(address);
+    }
+};
+
+struct ProfileHooks {
+    uint64_t* executions;
+    uint64_t* taken;
+    uint64_t* notTaken;
+
+    void execute(uint16_t address) { executions[address]++; }
+    void branch(uint16_t address, bool isTaken) { (isTaken ? taken : notTaken)[address]++; }
+    void store(uint16_t) {}
+};
+
+inline uint16_t signExtend9(uint16_t instr) {
+    return (instr & 0x100) ? (instr | 0xFE00) : (instr & 0x1FF);
+}
+
+// Shift type 0..3 is lsl, lsr, asr, ror; amount is 0..15.
+inline uint16_t shiftWord(uint16_t value, unsigned type, unsigned amount) {
+    switch (type) {
+        case 0: return static_cast<uint16_t>(value << amount);
+        case 1: return static_cast<uint16_t>(value >> amount);
+        case 2: return static_cast<uint16_t>(static_cast<int16_t>(value) >> amount);
+        default: return amount ? static_cast<uint16_t>((value >> amount) | (value << (16 - amount))) : value;
+    }
+}
+
+// The last bit shifted out (for ror the one rotated into the msb); only
+// meaningful when amount is not 0.
+inline bool shiftCarry(uint16_t value, unsigned type, unsigned amount) {
+    return type == 0 ? (value >> (16 - amount)) & 1 : (value >> (amount - 1)) & 1;
+}
+
+inline bool conditionHolds(unsigned condition, bool z, bool n, bool c) {
+    switch (condition) {
+        case 1: return z;
+        case 2: return !z;
+        case 3: return !c;
+        case 4: return c;
+        case 5: return !n;
+        case 6: return n;
+        default: return true;
+    }
+}
+}
+
+Simulator::Profile::Profile()
+    : executions(MEMORY_WORDS), taken(MEMORY_WORDS), notTaken(MEMORY_WORDS) {}
+
+void Simulator::Profile::clear() {
+    std::fill(executions.begin(), executions.end(), 0);
+    std::fill(taken.begin(), taken.end(), 0);
+    std::fill(notTaken.begin(), notTaken.end(), 0);
+}
+
+Simulator::Simulator() : memory(MEMORY_WORDS) {
+    load({});
+}
+
+void Simulator::load(const std::vector<uint16_t>& image) {
+    std::fill(memory.begin(), memory.end(), 0);
+    std::copy(image.begin(), image.begin() + std::min(image.size(), MEMORY_WORDS), memory.begin());
+    std::fill(registers, registers + 8, 0);
+    z = n = c = false;
+    if (blocks) {
+        blocks->reset();
+    }
+}
+
+void Simulator::load(const std::vector<uint16_t>& words, const std::vector<Segment>& segments) {
+    load({});
+    for (const auto& segment : segments) {
+        const size_t length = std::min(static_cast<size_t>(segment.length),
+                                       MEMORY_WORDS - static_cast<size_t>(segment.base));
+        std::copy(words.begin() + segment.offset, words.begin() + segment.offset + length,
+                  memory.begin() + segment.base);
+    }
+}
+
+void Simulator::setJitThreshold(unsigned executions) {
+    jitThreshold = executions;
+    if (jit) {
+        jit->setThreshold(executions);
+    }
+}
+
+Simulator::RunResult Simulator::run(uint64_t maxSteps) {
+    if (engine == Engine::JIT && JitCompiler::isSupported()) {
+        return runJit(maxSteps);
+    }
+    if (engine != Engine::INTERPRETER) {
+        return runBlocks(maxSteps);
+    }
+    NoHooks hooks;
+    return execute(maxSteps, hooks);
+}
+
+Simulator::RunResult Simulator::run(uint64_t maxSteps, Profile& profile) {
+    ProfileHooks hooks = {profile.executions.data(), profile.taken.data(), profile.notTaken.data()};
+    RunResult result = execute(maxSteps, hooks);
+    if (blocks) {
+        blocks->clear();    // the run may have stored into translated code
+    }
+    return result;
+}
+
+Simulator::RunResult Simulator::runBlocks(uint64_t maxSteps) {
+    if (!blocks) {
+        blocks.reset(new BlockCache());
+    }
+    uint64_t steps = 0;
+    RunResult stop;
+    for (;;) {
+        const Block& block = blocks->lookup(memory.data(), registers[PC]);
+        if (block.steps > maxSteps - steps) {
+            // Too few steps left for the whole block: finish one word at a time.
+            CodeWatchHooks hooks = {blocks.get()};
+            RunResult tail = execute(maxSteps - steps, hooks);
+            return {tail.reason, steps + tail.steps};
+        }
+        if (!runBlock(block, steps, stop)) {
+            return stop;
+        }
+    }
+}
+
+// The block engine with hot blocks compiled to native code. Compiled blocks
+// chain into each other and come back here at uncompiled targets, at stores
+// into translated code and when the steps left do not cover a block.
+Simulator::RunResult Simulator::runJit(uint64_t maxSteps) {
+    if (!blocks) {
+        blocks.reset(new BlockCache());
+    }
+    if (!jit) {
+        jit.reset(new JitCompiler());
+        jit->setThreshold(jitThreshold);
+    }
+    uint64_t steps = 0;
+    RunResult stop;
+    JitCompiler::State state;
+    state.memory = memory.data();
+    for (;;) {
+        if (jit->getGeneration() != blocks->getGeneration()) {
+            jit->flush(blocks->getGeneration());
+        }
+        const uint16_t pc = registers[PC];
+        const uint32_t compiled = jit->compiledSteps(pc);
+        if (compiled && compiled <= maxSteps - steps) {
+            std::copy(registers, registers + 8, state.registers);
+            state.z = z;
+            state.n = n;
+            state.c = c;
+            state.code = blocks->codeMap();
+            state.budget = maxSteps - steps;
+            jit->run(state, pc);
+            std::copy(state.registers, state.registers + 8, registers);
+            z = state.z != 0;
+            n = state.n != 0;
+            c = state.c != 0;
+            steps = maxSteps - state.budget;
+            if (state.storedIntoCode) {
+                blocks->invalidate(state.storeAddress);
+            } else if (state.lastExit) {
+                jit->chain(state.lastExit, registers[PC]);
+            }
+            continue;
+        }
+
+        const Block& block = blocks->lookup(memory.data(), pc);
+        if (block.steps > maxSteps - steps) {
+            CodeWatchHooks hooks = {blocks.get()};
+            RunResult tail = execute(maxSteps - steps, hooks);
+            return {tail.reason, steps + tail.steps};
+        }
+        if (jit->isHot(pc) && jit->compile(pc, block, *blocks)) {
+            continue;
+        }
+        if (!runBlock(block, steps, stop)) {
+            return stop;
+        }
+    }
+}
+
+// Runs block from its first op and leaves pc at the next block. Returns
+// false with stop filled in when the program halted.
+bool Simulator::runBlock(const Block& block, uint64_t& steps, RunResult& stop) {
+    uint16_t* r = registers;
+    uint16_t* mem = memory.data();
+
+    auto setZN = [&](uint16_t value) {
+        z = value == 0;
+        n = (value & 0x8000) != 0;
+    };
+    auto subtract = [&](uint16_t a, uint16_t b) {
+        uint32_t result = uint32_t(a) + uint16_t(~b) + 1;
+        c = (result >> 16) & 1;
+        setZN(static_cast<uint16_t>(result));
+        return static_cast<uint16_t>(result);
+    };
+    auto add = [&](uint16_t& target, uint16_t operand) {
+        uint32_t result = uint32_t(target) + operand;
+        c = result > 0xFFFF;
+        target = static_cast<uint16_t>(result);
+        setZN(target);
+    };
+    auto shift = [&](uint16_t& target, unsigned type, unsigned amount) {
+        amount &= 0xF;
+        if (amount) c = shiftCarry(target, type, amount);
+        target = shiftWord(target, type, amount);
+        setZN(target);
+    };
+    // A store into translated code ends the block after the store; the rest
+    // is translated again from the new memory contents. invalidate() frees
+    // the ops, so nothing of the block is read after it.
+    auto stored = [&](const BlockOp* op, uint16_t address) {
+        if (!blocks->isCode(address)) return false;
+        const uint16_t next = static_cast<uint16_t>(op->address + 1);
+        const uint64_t done = op->stepsBefore + 1;
+        blocks->invalidate(address);
+        r[PC] = next;
+        steps += done;
+        return true;
+    };
+    auto branch = [&](const BlockOp* op, bool take) {
+        if (take && op->condition == 7) r[LR] = op->address + op->steps;
+        r[PC] = take ? op->target : static_cast<uint16_t>(op->address + op->steps);
+        steps += block.steps;
+        return true;
+    };
+
+    for (const BlockOp* op = blocks->opsOf(block);; op++) {
+        switch (op->kind) {
+            case BlockOp::MV_R: r[op->rX] = r[op->rY]; break;
+            case BlockOp::MV_I: r[op->rX] = op->operand; break;
+            case BlockOp::CONST:
+                r[op->rX] = op->operand;
+                z = op->flags & 1;
+                n = (op->flags >> 1) & 1;
+                c = (op->flags >> 2) & 1;
+                break;
+            case BlockOp::ADD_R: add(r[op->rX], r[op->rY]); break;
+            case BlockOp::ADD_I: add(r[op->rX], op->operand); break;
+            case BlockOp::SUB_R: r[op->rX] = subtract(r[op->rX], r[op->rY]); break;
+            case BlockOp::SUB_I: r[op->rX] = subtract(r[op->rX], op->operand); break;
+            case BlockOp::AND_R: r[op->rX] &= r[op->rY]; setZN(r[op->rX]); break;
+            case BlockOp::AND_I: r[op->rX] &= op->operand; setZN(r[op->rX]); break;
+            case BlockOp::CMP_R: subtract(r[op->rX], r[op->rY]); break;
+            case BlockOp::CMP_I: subtract(r[op->rX], op->operand); break;
+            case BlockOp::XOR_R: r[op->rX] ^= r[op->rY]; setZN(r[op->rX]); break;
+            case BlockOp::LSL_R: case BlockOp::LSR_R: case BlockOp::ASR_R: case BlockOp::ROR_R:
+                shift(r[op->rX], (op->kind - BlockOp::LSL_R) / 2, r[op->rY]);
+                break;
+            case BlockOp::LSL_I: case BlockOp::LSR_I: case BlockOp::ASR_I: case BlockOp::ROR_I:
+                shift(r[op->rX], (op->kind - BlockOp::LSL_R) / 2, op->operand);
+                break;
+            case BlockOp::LD: r[op->rX] = mem[r[op->rY]]; break;
+            case BlockOp::POP: r[op->rX] = mem[r[SP]]; r[SP]++; break;
+            case BlockOp::ST: {
+                const uint16_t address = r[op->rY];
+                mem[address] = r[op->rX];
+                if (stored(op, address)) return true;
+                break;
+            }
+            case BlockOp::PUSH:
+                r[SP]--;
+                mem[r[SP]] = r[op->rX];
+                if (stored(op, r[SP])) return true;
+                break;
+            case BlockOp::BRANCH:
+                return branch(op, conditionHolds(op->condition, z, n, c));
+            case BlockOp::CMP_R_BRANCH:
+                subtract(r[op->rX], r[op->rY]);
+                return branch(op, conditionHolds(op->condition, z, n, c));
+            case BlockOp::CMP_I_BRANCH:
+                subtract(r[op->rX], op->operand);
+                return branch(op, conditionHolds(op->condition, z, n, c));
+            case BlockOp::SUB_I_BRANCH:
+                r[op->rX] = subtract(r[op->rX], op->operand);
+                return branch(op, conditionHolds(op->condition, z, n, c));
+            case BlockOp::FALL_THROUGH:
+                r[PC] = op->target;
+                steps += block.steps;
+                return true;
+            case BlockOp::GENERIC: {
+                // Halt, b-to-self and pc-relative instructions: one interpreted step.
+                steps += block.steps;
+                r[PC] = op->address;
+                CodeWatchHooks hooks = {blocks.get()};
+                RunResult one = execute(1, hooks);
+                if (one.reason != StopReason::STEP_LIMIT) {
+                    stop = {one.reason, steps};
+                    return false;
+                }
+                return true;
+            }
+        }
+    }
+}
+
+template <typename Hooks>
+Simulator::RunResult Simulator::execute(uint64_t maxSteps, Hooks& hooks) {
+    uint16_t* r = registers;
+    uint16_t* mem = memory.data();
+    uint64_t steps = 0;
+
+    auto setZN = [&](uint16_t value) {
+        z = value == 0;
+        n = (value & 0x8000) != 0;
+    };
+    auto subtract = [&](uint16_t a, uint16_t b) {
+        uint32_t result = uint32_t(a) + uint16_t(~b) + 1;
+        c = (result >> 16) & 1;
+        setZN(static_cast<uint16_t>(result));
+        return static_cast<uint16_t>(result);
+    };
+
+    while (steps < maxSteps) {
+        const uint16_t pc = r[PC];
+        const uint16_t instr = mem[pc];
+        hooks.execute(pc);
+        steps++;
+
+        if (instr == BRANCH_TO_SELF) {
+            hooks.branch(pc, true);
+            return {StopReason::BRANCH_TO_SELF, steps};
+        }
+        if ((instr & HALT_MASK) == HALT_MASK && !(instr & 0x1000)) {
+            return {StopReason::HALT, steps};
+        }
+
+        r[PC] = pc + 1;
+        const unsigned rX = (instr >> 9) & 7;
+        const bool immediate = (instr & 0x1000) != 0;
+        const uint16_t operand = immediate ? signExtend9(instr) : r[instr & 7];
+
+        switch (instr >> 13) {
+            case 0:     // mv
+                r[rX] = operand;
+                break;
+            case 1:
+                if (immediate) {    // mvt
+                    r[rX] = (instr & 0xFF) << 8;
+                } else {            // b<cond>, cond in the rX field
+                    bool take;
+                    switch (rX) {
+                        case 1: take = z; break;
+                        case 2: take = !z; break;
+                        case 3: take = !c; break;
+                        case 4: take = c; break;
+                        case 5: take = !n; break;
+                        case 6: take = n; break;
+                        default: take = true; break;
+                    }
+                    hooks.branch(pc, take);
+                    if (take) {
+                        if (rX == 7) r[LR] = pc + 1;
+                        r[PC] = pc + 1 + signExtend9(instr);
+                    }
+                }
+                break;
+            case 2: {   // add
+                uint32_t result = uint32_t(r[rX]) + operand;
+                c = result > 0xFFFF;
+                r[rX] = static_cast<uint16_t>(result);
+                setZN(r[rX]);
+                break;
+            }
+            case 3:     // sub
+                r[rX] = subtract(r[rX], operand);
+                break;
+            case 4:
+                if (immediate) {    // pop
+                    r[rX] = mem[r[SP]];
+                    r[SP]++;
+                } else {            // ld
+                    r[rX] = mem[operand];
+                }
+                break;
+            case 5:
+                if (immediate) {    // push
+                    r[SP]--;
+                    mem[r[SP]] = r[rX];
+                    hooks.store(r[SP]);
+                } else {            // st
+                    mem[operand] = r[rX];
+                    hooks.store(operand);
+                }
+                break;
+            case 6:     // and
+                r[rX] &= operand;
+                setZN(r[rX]);
+                break;
+            case 7:
+                if (immediate || !(instr & 0x100)) {    // cmp
+                    subtract(r[rX], operand);
+                } else if ((instr & 0xF0) == 0x10) {    // xor
+                    r[rX] ^= operand;
+                    setZN(r[rX]);
+                } else {                                // lsl, lsr, asr, ror
+                    const unsigned amount = (instr & 0x80) ? (instr & 0xF) : (operand & 0xF);
+                    const unsigned type = (instr >> 5) & 3;
+                    if (amount) c = shiftCarry(r[rX], type, amount);
+                    r[rX] = shiftWord(r[rX], type, amount);
+                    setZN(r[rX]);
+                }
+                break;
+        }
+    }
+    return {StopReason::STEP_LIMIT, steps};
+}
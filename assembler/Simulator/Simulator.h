@@ -0,0 +1,116 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Instruction-level qCore simulator. Executes an assembled image
+//              in a 64K-word memory, optionally counting executions per
+//              address and taken/not-taken outcomes per branch for the
+//              profiler. The counting variant is the same loop instantiated
+//              with different hooks, so it costs one increment per step.
+//
+//              Semantics not pinned down by the encoder:
+//              - immediates are 9-bit two's complement, mvt sets rX = D << 8
+//              - sub/cmp compute rX + ~op + 1; c is the carry out (no borrow)
+//              - and/xor update z and n only
+//              - shifts also set c to the last bit shifted out (for ror
+//                the bit rotated into the msb); a shift by 0 leaves c
+//              - register shift amounts use the low 4 bits of rY
+//              - push pre-decrements sp, pop post-increments it
+//              - execution stops at the halt encoding (1110---11111----) or
+//                at an unconditional branch to itself ("END: b END")
+//
+//              Engine::BLOCKS runs the same semantics from a cache of
+//              translated basic blocks (see BlockCache.h) instead of decoding
+//              every word; Engine::JIT additionally compiles hot blocks to
+//              x86-64 code (see JitCompiler.h). Profiled runs always use the
+//              interpreter.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "InstructionEncoder/MemoryImage.h"
+#include "BlockCache.h"
+#include "JitCompiler.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Simulator {
+public:
+    static constexpr size_t MEMORY_WORDS = 0x10000;
+    static constexpr int SP = 5;
+    static constexpr int LR = 6;
+    static constexpr int PC = 7;
+
+    enum class StopReason { HALT, BRANCH_TO_SELF, STEP_LIMIT };
+    enum class Engine { INTERPRETER, BLOCKS, JIT };
+
+    struct RunResult {
+        StopReason reason;
+        uint64_t steps;     // instructions executed, including the final one
+    };
+
+    // Flat per-address counters, indexed by the address of the instruction.
+    struct Profile {
+        std::vector<uint64_t> executions;
+        std::vector<uint64_t> taken;        // branches only
+        std::vector<uint64_t> notTaken;
+
+        Profile();
+        void clear();
+    };
+
+private:
+    std::vector<uint16_t> memory;
+    uint16_t registers[8];
+    bool z, n, c;
+    Engine engine = Engine::INTERPRETER;
+    std::unique_ptr<BlockCache> blocks;     // created by the first BLOCKS run
+    std::unique_ptr<JitCompiler> jit;       // created by the first JIT run
+    unsigned jitThreshold = JitCompiler::DEFAULT_THRESHOLD;
+
+    template <typename Hooks>
+    RunResult execute(uint64_t maxSteps, Hooks& hooks);
+    RunResult runBlocks(uint64_t maxSteps);
+    RunResult runJit(uint64_t maxSteps);
+    bool runBlock(const Block& block, uint64_t& steps, RunResult& stop);
+    void invalidateCode(uint16_t address) {
+        if (blocks && blocks->isCode(address)) blocks->clear();
+    }
+
+public:
+    Simulator();
+
+    // Clears memory, registers and flags and places image at address 0.
+    void load(const std::vector<uint16_t>& image);
+    // Same, placing each segment of an assembled image at its base.
+    void load(const std::vector<uint16_t>& words, const std::vector<Segment>& segments);
+
+    // All engines give the same registers, memory, flags and step counts.
+    // JIT runs as BLOCKS where JitCompiler::isSupported() is false.
+    void setEngine(Engine value) { engine = value; }
+    Engine getEngine() const { return engine; }
+    // JIT when this build can generate code, otherwise BLOCKS.
+    static Engine fastestEngine() { return JitCompiler::isSupported() ? Engine::JIT : Engine::BLOCKS; }
+    // Block-engine runs of a block before the JIT compiles it (0 or 1 =
+    // compile on first use).
+    void setJitThreshold(unsigned executions);
+
+    RunResult run(uint64_t maxSteps);
+    RunResult run(uint64_t maxSteps, Profile& profile);
+
+    uint16_t getRegister(int index) const { return registers[index & 7]; }
+    void setRegister(int index, uint16_t value) { registers[index & 7] = value; }
+    uint16_t readMemory(uint16_t address) const { return memory[address]; }
+    void writeMemory(uint16_t address, uint16_t value) {
+        memory[address] = value;
+        invalidateCode(address);
+    }
+    bool zeroFlag() const { return z; }
+    bool negativeFlag() const { return n; }
+    bool carryFlag() const { return c; }
+    void setFlags(bool zero, bool negative, bool carry) {
+        z = zero;
+        n = negative;
+        c = carry;
+    }
+};
@@ -0,0 +1,606 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "TestRunner.h"
+#include "LockstepSimulator.h"
+#include "Assembler/Assembler.h"
+#include "Lexer/CharScan.h"
+#include "Lexer/Lexer.h"
+#include "Lsp/Json.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t MAX_FAILURE_LINES = 16;
+
+// Manifest member path used in error messages, e.g. programs[0].cases[2].
+std::string member(const std::string& where, const std::string& key) {
+    return where.empty() ? key : where + "." + key;
+}
+
+std::string element(const std::string& where, size_t index) {
+    return where + "[" + std::to_string(index) + "]";
+}
+
+[[noreturn]] void invalid(const std::string& where, const std::string& message) {
+    throw std::runtime_error("manifest " + where + ": " + message);
+}
+
+const JsonValue& requireObject(const JsonValue& value, const std::string& where) {
+    if (!value.isObject()) invalid(where, "expected an object");
+    return value;
+}
+
+int64_t integer(const JsonValue& value, const std::string& where, int64_t low, int64_t high) {
+    const double number = value.asNumber();
+    if (!value.isNumber() || std::floor(number) != number || number < low || number > high) {
+        invalid(where, "expected an integer in " + std::to_string(low) + ".." + std::to_string(high));
+    }
+    return static_cast<int64_t>(number);
+}
+
+// Numbers, numeric strings ("0x800") and label names.
+TestValue parseValue(const JsonValue& value, const std::string& text, const std::string& where,
+                     int64_t low, int64_t high) {
+    TestValue result;
+    if (value.isNumber()) {
+        result.number = integer(value, where, low, high);
+        return result;
+    }
+    if (text.empty()) invalid(where, "expected a number or a label");
+    if (parseNumericLiteral(text.data(), text.data() + text.length(), result.number) == NumberStatus::OK) {
+        if (result.number < low || result.number > high) invalid(where, "value out of range");
+        return result;
+    }
+    if (!charscan::is(text[0], charscan::IDENT_START)) invalid(where, "'" + text + "' is not a number or a label");
+    result.label = text;
+    return result;
+}
+
+int registerIndex(const std::string& name, const std::string& where) {
+    if (name == "sp") return Simulator::SP;
+    if (name == "lr") return Simulator::LR;
+    if (name == "pc") return Simulator::PC;
+    if (name.length() == 2 && name[0] == 'r' && name[1] >= '0' && name[1] <= '7') return name[1] - '0';
+    invalid(where, "unknown register '" + name + "'");
+}
+
+std::vector<TestRegister> parseRegisters(const JsonValue& value, const std::string& where) {
+    std::vector<TestRegister> registers;
+    if (value.isNull()) return registers;
+    for (const auto& entry : requireObject(value, where).getMembers()) {
+        const std::string at = member(where, entry.first);
+        registers.push_back({registerIndex(entry.first, at),
+                             parseValue(entry.second, entry.second.asString(), at, -0x8000, 0xFFFF)});
+    }
+    return registers;
+}
+
+// {"address": word or [words]}
+std::vector<TestMemory> parseMemory(const JsonValue& value, const std::string& where) {
+    std::vector<TestMemory> memory;
+    if (value.isNull()) return memory;
+    for (const auto& entry : requireObject(value, where).getMembers()) {
+        const std::string at = member(where, entry.first);
+        TestMemory block;
+        block.address = parseValue(JsonValue(), entry.first, at, 0, 0xFFFF);
+        if (entry.second.isArray()) {
+            for (size_t i = 0; i < entry.second.size(); i++) {
+                block.words.push_back(static_cast<uint16_t>(integer(entry.second[i], element(at, i), -0x8000, 0xFFFF)));
+            }
+        } else {
+            block.words.push_back(static_cast<uint16_t>(integer(entry.second, at, -0x8000, 0xFFFF)));
+        }
+        if (block.address.label.empty() && block.address.number + block.words.size() > Simulator::MEMORY_WORDS) {
+            invalid(at, "words run past the end of memory");
+        }
+        memory.push_back(std::move(block));
+    }
+    return memory;
+}
+
+uint64_t parseMaxSteps(const JsonValue& value, const std::string& where, uint64_t inherited) {
+    return value.isNull() ? inherited : static_cast<uint64_t>(integer(value, where, 1, INT64_C(1) << 53));
+}
+
+TestCase parseCase(const JsonValue& value, const std::string& where, size_t index, uint64_t maxSteps) {
+    requireObject(value, where);
+    TestCase test;
+    test.name = value.get("name").isString() ? value.get("name").asString() : "case " + std::to_string(index + 1);
+    test.maxSteps = parseMaxSteps(value.get("maxSteps"), member(where, "maxSteps"), maxSteps);
+    test.registers = parseRegisters(value.get("registers"), member(where, "registers"));
+    test.memory = parseMemory(value.get("memory"), member(where, "memory"));
+
+    const JsonValue& expect = value.get("expect");
+    const std::string at = member(where, "expect");
+    if (expect.isNull()) return test;
+    requireObject(expect, at);
+    test.expectRegisters = parseRegisters(expect.get("registers"), member(at, "registers"));
+    test.expectMemory = parseMemory(expect.get("memory"), member(at, "memory"));
+    const JsonValue& stop = expect.get("stop");
+    if (!stop.isNull()) {
+        if (stop.asString() == "halted") {
+            test.expectStop = TestStop::HALTED;
+        } else if (stop.asString() == "step-limit") {
+            test.expectStop = TestStop::STEP_LIMIT;
+        } else if (stop.asString() == "any") {
+            test.expectStop = TestStop::ANY;
+        } else {
+            invalid(member(at, "stop"), "expected halted, step-limit or any");
+        }
+    }
+    return test;
+}
+
+std::string directoryOf(const std::string& path) {
+    const size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? "" : path.substr(0, std::max<size_t>(slash, 1));
+}
+
+std::string hex(uint16_t value) {
+    std::ostringstream text;
+    text << "0x" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << value;
+    return text.str();
+}
+
+const char* stopName(Simulator::StopReason reason) {
+    switch (reason) {
+        case Simulator::StopReason::HALT: return "halt";
+        case Simulator::StopReason::BRANCH_TO_SELF: return "branch-to-self";
+        default: return "step-limit";
+    }
+}
+
+const char* registerName(int index) {
+    static const char* const names[] = {"r0", "r1", "r2", "r3", "r4", "sp", "lr", "pc"};
+    return names[index & 7];
+}
+
+// An assembled program and its labels by name.
+struct PreparedProgram {
+    AssembleResult result;
+    std::unordered_map<std::string, int> labels;
+};
+
+uint16_t resolve(const TestValue& value, const PreparedProgram& program) {
+    if (value.label.empty()) {
+        return static_cast<uint16_t>(value.number);
+    }
+    auto it = program.labels.find(value.label);
+    if (it == program.labels.end()) {
+        throw std::runtime_error("unknown label '" + value.label + "'");
+    }
+    return static_cast<uint16_t>(it->second);
+}
+
+void fail(TestCaseResult& result, const std::string& message) {
+    if (result.failures.size() < MAX_FAILURE_LINES) {
+        result.failures.push_back(message);
+    } else if (result.failures.size() == MAX_FAILURE_LINES) {
+        result.failures.push_back("...");
+    }
+}
+
+// A Simulator, or one lane of a LockstepSimulator, behind the calls a case
+// needs.
+struct SimulatorMachine {
+    Simulator& simulator;
+
+    uint16_t getRegister(int index) const { return simulator.getRegister(index); }
+    void setRegister(int index, uint16_t value) { simulator.setRegister(index, value); }
+    uint16_t readMemory(uint16_t address) const { return simulator.readMemory(address); }
+    void writeMemory(uint16_t address, uint16_t value) { simulator.writeMemory(address, value); }
+};
+
+struct LaneMachine {
+    LockstepSimulator& simulator;
+    int lane;
+
+    uint16_t getRegister(int index) const { return simulator.getRegister(lane, index); }
+    void setRegister(int index, uint16_t value) { simulator.setRegister(lane, index, value); }
+    uint16_t readMemory(uint16_t address) const { return simulator.readMemory(lane, address); }
+    void writeMemory(uint16_t address, uint16_t value) { simulator.writeMemory(lane, address, value); }
+};
+
+// Applies the initial memory and registers of test to a freshly loaded machine.
+template <typename Machine>
+void setUpCase(const TestCase& test, const PreparedProgram& program, Machine machine) {
+    for (const TestMemory& block : test.memory) {
+        uint16_t address = resolve(block.address, program);
+        for (uint16_t word : block.words) {
+            machine.writeMemory(address++, word);
+        }
+    }
+    for (const TestRegister& reg : test.registers) {
+        machine.setRegister(reg.index, resolve(reg.value, program));
+    }
+}
+
+template <typename Machine>
+void checkCase(const TestCase& test, const PreparedProgram& program, Machine machine,
+               const Simulator::RunResult& run, TestCaseResult& result) {
+    result.stop = run.reason;
+    result.steps = run.steps;
+    if (test.expectStop == TestStop::HALTED && run.reason == Simulator::StopReason::STEP_LIMIT) {
+        fail(result, "did not halt within " + std::to_string(test.maxSteps) + " steps");
+    } else if (test.expectStop == TestStop::STEP_LIMIT && run.reason != Simulator::StopReason::STEP_LIMIT) {
+        fail(result, std::string("stopped at ") + stopName(run.reason) + " after " + std::to_string(run.steps) +
+                     " steps, expected to reach the step limit");
+    }
+
+    for (const TestRegister& reg : test.expectRegisters) {
+        const uint16_t expected = resolve(reg.value, program);
+        const uint16_t actual = machine.getRegister(reg.index);
+        if (actual != expected) {
+            fail(result, std::string(registerName(reg.index)) + ": expected " + hex(expected) + ", got " + hex(actual));
+        }
+    }
+    for (const TestMemory& block : test.expectMemory) {
+        uint16_t address = resolve(block.address, program);
+        for (uint16_t expected : block.words) {
+            const uint16_t actual = machine.readMemory(address);
+            if (actual != expected) {
+                fail(result, "[" + hex(address) + "]: expected " + hex(expected) + ", got " + hex(actual));
+            }
+            address++;
+        }
+    }
+}
+
+void runCase(const TestCase& test, const PreparedProgram& program, Simulator& simulator, TestCaseResult& result) {
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        simulator.load(program.result.words, program.result.segments);
+        setUpCase(test, program, SimulatorMachine{simulator});
+        const Simulator::RunResult run = simulator.run(test.maxSteps);
+        checkCase(test, program, SimulatorMachine{simulator}, run, result);
+    } catch (const std::exception& e) {
+        fail(result, e.what());
+    }
+    result.passed = result.failures.empty();
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs up to LANES consecutive cases of one program together, one per lane.
+// A case whose set-up fails does not run; the batch time is shared evenly.
+void runBatch(const TestCase* tests, size_t count, const PreparedProgram& program, LockstepSimulator& simulator,
+              TestCaseResult* results) {
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t maxSteps[LockstepSimulator::LANES] = {};
+    Simulator::RunResult runs[LockstepSimulator::LANES];
+    simulator.load(program.result.words, program.result.segments);
+    for (size_t lane = 0; lane < count; lane++) {
+        try {
+            setUpCase(tests[lane], program, LaneMachine{simulator, static_cast<int>(lane)});
+            maxSteps[lane] = tests[lane].maxSteps;
+        } catch (const std::exception& e) {
+            fail(results[lane], e.what());
+        }
+    }
+    simulator.run(maxSteps, runs);
+    const double milliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / count;
+    for (size_t lane = 0; lane < count; lane++) {
+        if (maxSteps[lane]) {
+            try {
+                checkCase(tests[lane], program, LaneMachine{simulator, static_cast<int>(lane)}, runs[lane],
+                          results[lane]);
+            } catch (const std::exception& e) {
+                fail(results[lane], e.what());
+            }
+        }
+        results[lane].passed = results[lane].failures.empty();
+        results[lane].milliseconds = milliseconds;
+    }
+}
+
+// Runs work() on the calling thread and workers - 1 more.
+template <typename Work>
+void runWorkers(size_t workers, const Work& work) {
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < workers; t++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void writeXmlEscaped(std::ostream& out, const std::string& text) {
+    for (char c : text) {
+        switch (c) {
+            case '&': out << "&amp;"; break;
+            case '<': out << "&lt;"; break;
+            case '>': out << "&gt;"; break;
+            case '"': out << "&quot;"; break;
+            default: out << c; break;
+        }
+    }
+}
+
+std::string seconds(double milliseconds) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(6) << milliseconds / 1000.0;
+    return text.str();
+}
+
+std::string joinLines(const std::vector<std::string>& lines) {
+    std::string text;
+    for (const auto& line : lines) {
+        text += (text.empty() ? "" : "\n") + line;
+    }
+    return text;
+}
+
+}
+
+TestManifest parseTestManifest(const std::string& json, const std::string& directory, uint64_t defaultMaxSteps) {
+    JsonValue root;
+    try {
+        root = JsonValue::parse(json);
+    } catch (const std::exception& e) {
+        throw std::runtime_error(std::string("manifest: ") + e.what());
+    }
+    requireObject(root, "root");
+
+    TestManifest manifest;
+    manifest.name = root.get("name").isString() ? root.get("name").asString() : "sbasmCpp";
+    const uint64_t maxSteps = parseMaxSteps(root.get("maxSteps"), "maxSteps", defaultMaxSteps);
+    const JsonValue& programs = root.get("programs");
+    if (!programs.isArray()) invalid("programs", "expected an array");
+
+    for (size_t p = 0; p < programs.size(); p++) {
+        const std::string where = element("programs", p);
+        const JsonValue& value = requireObject(programs[p], where);
+        TestProgram program;
+        const std::string& source = value.get("source").asString();
+        if (source.empty()) invalid(member(where, "source"), "expected a file name");
+        const bool absolute = source[0] == '/' || source[0] == '\\' || (source.length() > 1 && source[1] == ':');
+        program.path = absolute || directory.empty() ? source : directory + "/" + source;
+        program.name = value.get("name").isString() ? value.get("name").asString() : source;
+
+        const JsonValue& defines = value.get("defines");
+        if (!defines.isNull()) {
+            for (const auto& define : requireObject(defines, member(where, "defines")).getMembers()) {
+                const std::string at = member(member(where, "defines"), define.first);
+                if (define.first.empty() || !charscan::is(define.first[0], charscan::IDENT_START)) {
+                    invalid(at, "not a valid name");
+                }
+                const int number = define.second.getType() == JsonValue::Type::BOOLEAN
+                                       ? (define.second.asBool() ? 1 : 0)
+                                       : static_cast<int>(integer(define.second, at, INT32_MIN, INT32_MAX));
+                program.defines.push_back({define.first, number});
+            }
+        }
+
+        const uint64_t programSteps = parseMaxSteps(value.get("maxSteps"), member(where, "maxSteps"), maxSteps);
+        const JsonValue& cases = value.get("cases");
+        if (!cases.isArray()) invalid(member(where, "cases"), "expected an array");
+        for (size_t c = 0; c < cases.size(); c++) {
+            program.cases.push_back(parseCase(cases[c], element(member(where, "cases"), c), c, programSteps));
+        }
+        manifest.programs.push_back(std::move(program));
+    }
+    return manifest;
+}
+
+TestManifest loadTestManifest(const std::string& path, uint64_t defaultMaxSteps) {
+    auto read = [](const std::string& file, std::string& contents) {
+        std::ifstream in(file, std::ios::binary);
+        if (!in.is_open()) {
+            throw std::runtime_error("Could not open file '" + file + "'");
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        contents = buffer.str();
+    };
+    std::string json;
+    read(path, json);
+    TestManifest manifest = parseTestManifest(json, directoryOf(path), defaultMaxSteps);
+    for (TestProgram& program : manifest.programs) {
+        read(program.path, program.text);
+    }
+    return manifest;
+}
+
+TestReport runTests(const TestManifest& manifest, unsigned jobs, Simulator::Engine engine, bool lockstep) {
+    const auto start = std::chrono::steady_clock::now();
+    const size_t programCount = manifest.programs.size();
+    TestReport report;
+    report.assemblyErrors.resize(programCount);
+    report.cases.resize(programCount);
+    std::vector<PreparedProgram> prepared(programCount);
+    jobs = std::max(1u, jobs);
+
+    // Every program is assembled once, one AssemblerContext per worker.
+    std::atomic<size_t> next(0);
+    runWorkers(std::min<size_t>(jobs, std::max<size_t>(1, programCount)), [&]() {
+        AssemblerContext context;
+        for (size_t i; (i = next++) < programCount;) {
+            const TestProgram& program = manifest.programs[i];
+            AssembleOptions options;
+            options.defines = program.defines;
+            options.includeDirectory = directoryOf(program.path);
+            const AssembleResult& result = context.assemble(program.text, options);
+            if (!result.success) {
+                report.assemblyErrors[i] = result.diagnostics.front().message;
+                continue;
+            }
+            prepared[i].result = result;
+            for (const SymbolInfo& symbol : result.symbols) {
+                prepared[i].labels.emplace(symbol.name, symbol.value);
+            }
+        }
+    });
+
+    // Work items are single cases, or batches of up to LANES cases of one
+    // program in lockstep mode.
+    const size_t batch = lockstep ? LockstepSimulator::LANES : 1;
+    std::vector<std::pair<size_t, size_t>> work;
+    for (size_t p = 0; p < programCount; p++) {
+        const size_t caseCount = manifest.programs[p].cases.size();
+        report.cases[p].resize(caseCount);
+        for (size_t c = 0; c < caseCount; c++) {
+            if (report.assemblyErrors[p].empty()) {
+                if (c % batch == 0) work.push_back({p, c});
+            } else {
+                report.cases[p][c].error = true;
+                report.cases[p][c].failures.push_back(report.assemblyErrors[p]);
+            }
+        }
+    }
+
+    // Cases are independent: each worker reloads its own 64K-word machine.
+    next = 0;
+    runWorkers(std::min<size_t>(jobs, std::max<size_t>(1, work.size())), [&]() {
+        if (lockstep) {
+            LockstepSimulator simulator;
+            for (size_t i; (i = next++) < work.size();) {
+                const size_t p = work[i].first;
+                const size_t c = work[i].second;
+                const size_t count = std::min(batch, manifest.programs[p].cases.size() - c);
+                runBatch(&manifest.programs[p].cases[c], count, prepared[p], simulator, &report.cases[p][c]);
+            }
+            return;
+        }
+        Simulator simulator;
+        simulator.setEngine(engine);
+        for (size_t i; (i = next++) < work.size();) {
+            const size_t p = work[i].first;
+            const size_t c = work[i].second;
+            runCase(manifest.programs[p].cases[c], prepared[p], simulator, report.cases[p][c]);
+        }
+    });
+
+    for (const auto& cases : report.cases) {
+        for (const TestCaseResult& result : cases) {
+            if (result.error) {
+                report.errors++;
+            } else if (result.passed) {
+                report.passed++;
+            } else {
+                report.failed++;
+            }
+        }
+    }
+    report.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+void writeJUnitReport(std::ostream& out, const TestManifest& manifest, const TestReport& report) {
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites name=\"";
+    writeXmlEscaped(out, manifest.name);
+    out << "\" tests=\"" << report.passed + report.failed + report.errors << "\" failures=\"" << report.failed
+        << "\" errors=\"" << report.errors << "\" time=\"" << seconds(report.milliseconds) << "\">\n";
+
+    for (size_t p = 0; p < manifest.programs.size(); p++) {
+        const TestProgram& program = manifest.programs[p];
+        const std::vector<TestCaseResult>& cases = report.cases[p];
+        size_t failures = 0;
+        double milliseconds = 0;
+        for (const TestCaseResult& result : cases) {
+            failures += !result.passed && !result.error;
+            milliseconds += result.milliseconds;
+        }
+        const size_t errors = report.assemblyErrors[p].empty() ? 0 : cases.size();
+
+        out << "  <testsuite name=\"";
+        writeXmlEscaped(out, program.name);
+        out << "\" tests=\"" << cases.size() << "\" failures=\"" << failures << "\" errors=\"" << errors
+            << "\" time=\"" << seconds(milliseconds) << "\">\n";
+        for (size_t c = 0; c < cases.size(); c++) {
+            const TestCaseResult& result = cases[c];
+            out << "    <testcase name=\"";
+            writeXmlEscaped(out, program.cases[c].name);
+            out << "\" classname=\"";
+            writeXmlEscaped(out, program.name);
+            out << "\" time=\"" << seconds(result.milliseconds) << "\"";
+            if (result.passed) {
+                out << "/>\n";
+                continue;
+            }
+            const char* tag = result.error ? "error" : "failure";
+            out << ">\n      <" << tag << " message=\"";
+            writeXmlEscaped(out, result.failures.front());
+            out << "\">";
+            writeXmlEscaped(out, joinLines(result.failures));
+            out << "</" << tag << ">\n    </testcase>\n";
+        }
+        out << "  </testsuite>\n";
+    }
+    out << "</testsuites>\n";
+}
+
+void writeJsonReport(std::ostream& out, const TestManifest& manifest, const TestReport& report) {
+    JsonValue root = JsonValue::object();
+    root.set("name", manifest.name);
+    root.set("passed", static_cast<int64_t>(report.passed));
+    root.set("failed", static_cast<int64_t>(report.failed));
+    root.set("errors", static_cast<int64_t>(report.errors));
+    root.set("milliseconds", report.milliseconds);
+    JsonValue& programs = root.set("programs", JsonValue::array());
+    for (size_t p = 0; p < manifest.programs.size(); p++) {
+        JsonValue& program = programs.push(JsonValue::object());
+        program.set("name", manifest.programs[p].name);
+        if (!report.assemblyErrors[p].empty()) {
+            program.set("error", report.assemblyErrors[p]);
+        }
+        JsonValue& cases = program.set("cases", JsonValue::array());
+        for (size_t c = 0; c < report.cases[p].size(); c++) {
+            const TestCaseResult& result = report.cases[p][c];
+            JsonValue& test = cases.push(JsonValue::object());
+            test.set("name", manifest.programs[p].cases[c].name);
+            test.set("status", result.error ? "error" : result.passed ? "passed" : "failed");
+            if (!result.error) {
+                test.set("stop", stopName(result.stop));
+                test.set("steps", static_cast<int64_t>(result.steps));
+            }
+            test.set("milliseconds", result.milliseconds);
+            if (!result.failures.empty()) {
+                JsonValue& failures = test.set("failures", JsonValue::array());
+                for (const auto& failure : result.failures) {
+                    failures.push(failure);
+                }
+            }
+        }
+    }
+    out << root.serialize() << "\n";
+}
+
+void writeTestSummary(std::ostream& out, const TestManifest& manifest, const TestReport& report, bool verbose) {
+    for (size_t p = 0; p < manifest.programs.size(); p++) {
+        const TestProgram& program = manifest.programs[p];
+        if (!report.assemblyErrors[p].empty()) {
+            out << "ERROR " << program.name << ": " << report.assemblyErrors[p] << "\n";
+            continue;
+        }
+        for (size_t c = 0; c < program.cases.size(); c++) {
+            const TestCaseResult& result = report.cases[p][c];
+            if (result.passed && !verbose) {
+                continue;
+            }
+            out << (result.passed ? "PASS " : "FAIL ") << program.name << " / " << program.cases[c].name << " ("
+                << stopName(result.stop) << " after " << result.steps << " steps)\n";
+            for (const auto& failure : result.failures) {
+                out << "    " << failure << "\n";
+            }
+        }
+    }
+    out << report.passed << " passed, " << report.failed << " failed";
+    if (report.errors) {
+        out << ", " << report.errors << " not run (assembly errors)";
+    }
+    out << " in " << std::fixed << std::setprecision(2) << report.milliseconds << " ms\n";
+}
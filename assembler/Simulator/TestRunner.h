@@ -0,0 +1,123 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Headless test runner ("sbasmCpp test"). A JSON manifest lists
+//              programs and, per program, cases made of an initial register
+//              and memory state, a step limit and the expected registers,
+//              memory and stop reason. Every program is assembled once; the
+//              cases then run on a thread pool, one Simulator (or, in
+//              lockstep mode, one LockstepSimulator) per worker, and the
+//              outcome is written as a JUnit XML or JSON report.
+//
+//              {
+//                "maxSteps": 100000,
+//                "programs": [{
+//                  "source": "sum.s",            // relative to the manifest
+//                  "defines": {"N": 4},          // like -D N=4
+//                  "cases": [{
+//                    "name": "four values",
+//                    "registers": {"r0": "DATA", "r1": 4},
+//                    "memory": {"DATA": [1, 2, 3, 4]},
+//                    "maxSteps": 1000,
+//                    "expect": {
+//                      "registers": {"r2": 10},
+//                      "memory": {"0x800": [10]},
+//                      "stop": "halted"          // halted | step-limit | any
+//                    }
+//                  }]
+//                }]
+//              }
+//
+//              Addresses and register values are numbers or label names of
+//              the program. "halted" accepts the halt instruction and a
+//              branch to itself ("END: b END").
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include "Simulator.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A number, or a label resolved after the program is assembled.
+struct TestValue {
+    int64_t number = 0;
+    std::string label;
+};
+
+struct TestRegister {
+    int index;
+    TestValue value;
+};
+
+struct TestMemory {
+    TestValue address;
+    std::vector<uint16_t> words;
+};
+
+enum class TestStop { HALTED, STEP_LIMIT, ANY };
+
+struct TestCase {
+    std::string name;
+    uint64_t maxSteps = 0;
+    std::vector<TestRegister> registers;
+    std::vector<TestMemory> memory;
+    std::vector<TestRegister> expectRegisters;
+    std::vector<TestMemory> expectMemory;
+    TestStop expectStop = TestStop::HALTED;
+};
+
+struct TestProgram {
+    std::string name;
+    std::string path;       // source file, already joined with the manifest directory
+    std::string text;       // filled by loadTestManifest()
+    std::vector<std::pair<std::string, int>> defines;
+    std::vector<TestCase> cases;
+};
+
+struct TestManifest {
+    std::string name;
+    std::vector<TestProgram> programs;
+};
+
+struct TestCaseResult {
+    bool passed = false;
+    bool error = false;                 // the program did not assemble
+    Simulator::StopReason stop = Simulator::StopReason::STEP_LIMIT;
+    uint64_t steps = 0;
+    double milliseconds = 0;
+    std::vector<std::string> failures;  // one line per mismatch, or the error
+};
+
+struct TestReport {
+    std::vector<std::string> assemblyErrors;        // per program, empty when it assembled
+    std::vector<std::vector<TestCaseResult>> cases; // per program, per case
+    size_t passed = 0;
+    size_t failed = 0;
+    size_t errors = 0;
+    double milliseconds = 0;
+};
+
+// Parses a manifest; program paths are joined with directory. Cases without
+// maxSteps inherit the program's, then the manifest's, then defaultMaxSteps.
+// Throws std::runtime_error naming the offending member.
+TestManifest parseTestManifest(const std::string& json, const std::string& directory,
+                               uint64_t defaultMaxSteps);
+
+// Reads the manifest at path and the source of every program.
+TestManifest loadTestManifest(const std::string& path, uint64_t defaultMaxSteps);
+
+// Assembles every program once and runs all cases on up to jobs threads.
+// Results are in manifest order whatever the thread count. With lockstep the
+// cases of a program run LockstepSimulator::LANES at a time, one per SIMD
+// lane, and engine is not used.
+TestReport runTests(const TestManifest& manifest, unsigned jobs,
+                    Simulator::Engine engine = Simulator::fastestEngine(), bool lockstep = false);
+
+void writeJUnitReport(std::ostream& out, const TestManifest& manifest, const TestReport& report);
+void writeJsonReport(std::ostream& out, const TestManifest& manifest, const TestReport& report);
+// Failures one per line, then "N passed, M failed"; with verbose every case.
+void writeTestSummary(std::ostream& out, const TestManifest& manifest, const TestReport& report,
+                      bool verbose);
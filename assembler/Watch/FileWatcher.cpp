@@ -0,0 +1,156 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "FileWatcher.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+constexpr int FileWatcher::DEBOUNCE_MS;
+constexpr int FileWatcher::POLL_INTERVAL_MS;
+
+static std::time_t modificationTime(const std::string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return 0;
+    }
+    return info.st_mtime;
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+    }
+#endif
+}
+
+std::string FileWatcher::directoryOf(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    if (slash == std::string::npos) return ".";
+    if (slash == 0) return "/";
+    return path.substr(0, slash);
+}
+
+std::string FileWatcher::fileNameOf(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool FileWatcher::isWatched(int wd, const std::string& name) const {
+    auto names = watchedNames.find(wd);
+    return names != watchedNames.end() && names->second.count(name) != 0;
+}
+
+void FileWatcher::setFiles(const std::vector<std::string>& paths) {
+    files = paths;
+    modified.clear();
+    for (const auto& file : files) {
+        modified.push_back(modificationTime(file));
+    }
+
+#ifdef __linux__
+    if (inotifyFd < 0) {
+        inotifyFd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    }
+    if (inotifyFd < 0) {
+        return;     // out of instances: poll instead
+    }
+    for (const auto& entry : watchedNames) {
+        inotify_rm_watch(inotifyFd, entry.first);
+    }
+    watchedNames.clear();
+    for (const auto& file : files) {
+        std::string directory = directoryOf(file);
+        int wd = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (wd < 0) {
+            throw std::runtime_error("Could not watch directory: " + directory);
+        }
+        watchedNames[wd].insert(fileNameOf(file));
+    }
+#endif
+}
+
+bool FileWatcher::waitForChange(int timeoutMs) {
+    if (files.empty()) {
+        throw std::runtime_error("No files to watch");
+    }
+#ifdef __linux__
+    if (inotifyFd >= 0) {
+        return waitInotify(timeoutMs);
+    }
+#endif
+    return waitPolling(timeoutMs);
+}
+
+bool FileWatcher::waitInotify(int timeoutMs) {
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    bool changed = false;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    // Block for the first relevant event, then keep draining until the
+    // directory has been quiet for DEBOUNCE_MS.
+    for (;;) {
+        int timeout = -1;
+        if (changed) {
+            timeout = DEBOUNCE_MS;
+        } else if (timeoutMs >= 0) {
+            timeout = static_cast<int>(std::max<std::chrono::milliseconds::rep>(0,
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count()));
+        }
+        pollfd pfd = {inotifyFd, POLLIN, 0};
+        int ready = poll(&pfd, 1, timeout);
+        if (ready < 0) {
+            throw std::runtime_error("Waiting for file changes failed");
+        }
+        if (ready == 0) {
+            return changed;
+        }
+
+        ssize_t length;
+        while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + length; ) {
+                auto event = reinterpret_cast<const inotify_event*>(p);
+                if (event->len > 0 && isWatched(event->wd, event->name)) {
+                    changed = true;
+                }
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+#else
+    (void)timeoutMs;
+    return false;
+#endif
+}
+
+bool FileWatcher::waitPolling(int timeoutMs) {
+    for (int waited = 0; timeoutMs < 0 || waited < timeoutMs; waited += POLL_INTERVAL_MS) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+        bool changed = false;
+        for (size_t i = 0; i < files.size(); i++) {
+            std::time_t now = modificationTime(files[i]);
+            if (now != modified[i]) {
+                modified[i] = now;
+                changed = true;
+            }
+        }
+        if (changed) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(DEBOUNCE_MS));
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,48 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Blocks until one of a set of files is written. Uses inotify
+//              on Linux (watching the parent directories, so editors that
+//              save by renaming a temp file are caught too) and falls back to
+//              polling modification times elsewhere.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include <ctime>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class FileWatcher {
+private:
+    std::vector<std::string> files;
+    std::vector<std::time_t> modified;      // polling fallback
+    int inotifyFd = -1;
+    // Watch descriptor -> names of the watched files in its directory. One
+    // directory spelled several ways ("src", "src/.") has a single wd.
+    std::map<int, std::set<std::string>> watchedNames;
+
+    static std::string directoryOf(const std::string& path);
+    static std::string fileNameOf(const std::string& path);
+    bool isWatched(int wd, const std::string& name) const;
+    bool waitInotify(int timeoutMs);
+    bool waitPolling(int timeoutMs);
+
+public:
+    // How long to wait for more events after the first one, so that one save
+    // (truncate + write + close, or write temp + rename) reassembles once.
+    static constexpr int DEBOUNCE_MS = 15;
+    static constexpr int POLL_INTERVAL_MS = 100;
+
+    FileWatcher() = default;
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Replaces the watched set, e.g. when the includes of the input changed.
+    void setFiles(const std::vector<std::string>& paths);
+    // Blocks until a watched file is written and returns true, or returns
+    // false once timeoutMs passed without a change (-1 = wait forever).
+    bool waitForChange(int timeoutMs = -1);
+};
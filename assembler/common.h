@@ -8,3 +8,22 @@
 #include <cstdint>
 #include <cstddef>
 #include <unordered_map>
+#include <stdexcept>
+#include <string>
+
+// Error raised for problems in the assembled source. Carries the source
+// position so callers that collect diagnostics do not have to parse it back
+// out of the message; line is 0 when the position is unknown.
+class AssemblyError : public std::runtime_error {
+public:
+    int line;
+    int column;
+    // Index of the source in AssemblerContext::assembleFiles(), -1 when
+    // there is only one source or the file is not known.
+    int file = -1;
+
+    AssemblyError(const std::string& message, int line, int column = 0)
+        : std::runtime_error(message), line(line), column(column) {}
+    AssemblyError(const std::string& message, int line, int column, int file)
+        : std::runtime_error(message), line(line), column(column), file(file) {}
+};
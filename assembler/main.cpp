@@ -9,33 +9,233 @@
 // ----------------------------------------------------------------------------
 
 #include "common.h"
-#include "Lexer/Lexer.h"
-#include "Parser/Parser.h"
-#include "InstructionEncoder/InstructionEncoder.h"
-#include "InstructionEncoder/SymbolTable.h"
+#include "Assembler/Assembler.h"
+#include "Assembler/IncrementalAssembler.h"
+#include "DebugInfo/DebugInfo.h"
+#include "Simulator/Profiler.h"
+#include "Simulator/TestRunner.h"
+#include "Analysis/Wcet.h"
+#include "Output/MifWriter.h"
+#include "Output/FileUpdate.h"
+#include "Watch/FileWatcher.h"
+#include "Lsp/LanguageServer.h"
+#include <chrono>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <iomanip>
+#include <algorithm>
+#include <thread>
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+// output.mif -> output.sbdi
+std::string debugInfoPath(const std::string& outputFile) {
+    return outputFile.substr(0, outputFile.size() - 4) + ".sbdi";
+}
+
+// Reassembles inputFile every time it or a file it .incbin's is saved until
+// the process is killed.
+int watch(const std::string& inputFile, std::string& outputFile, const AssembleOptions& options,
+          const MifOptions& mifOptions, bool debugInfo) {
+    IncrementalAssembler assembler;
+    FileWatcher watcher;
+    std::vector<std::string> watched = {inputFile};
+    watcher.setFiles(watched);
+    std::cout << "Watching " << inputFile << " (Ctrl+C to stop)\n";
+
+    for (;;) {
+        std::string input;
+        if (!readFile(inputFile, input)) {
+            std::cerr << "Error: Could not open file '" << inputFile << "'" << std::endl;
+        } else {
+            auto start = std::chrono::steady_clock::now();
+            const AssembleResult& result = assembler.update(input, options);
+            bool written = false;
+            try {
+                if (result.success) {
+                    written = writeMIF(result.words, result.isData, result.segments, outputFile, result.depth, mifOptions);
+                    if (debugInfo) {
+                        writeDebugInfo(result, debugInfoPath(outputFile));
+                    }
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+            }
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+
+            if (!result.success) {
+                std::cerr << "Error: " << result.diagnostics.front().message << std::endl;
+            } else {
+                std::vector<std::string> files = assembler.getIncludedFiles();
+                files.insert(files.begin(), inputFile);
+                if (files != watched) {
+                    watched.swap(files);
+                    watcher.setFiles(watched);
+                }
+
+                const IncrementalAssembler::UpdateStats& stats = assembler.getStats();
+                std::cout << (written ? "Wrote " : "Unchanged ") << outputFile << " in " << std::fixed << std::setprecision(2)
+                          << ms << " ms (";
+                if (stats.fullRebuild) {
+                    std::cout << "full rebuild";
+                } else {
+                    std::cout << stats.linesRelexed << " lines re-lexed, "
+                              << stats.statementsEncoded << " statements re-encoded";
+                }
+                std::cout << ")" << std::endl;
+            }
+        }
+        watcher.waitForChange();
+    }
+}
+
+// sbasmCpp test <manifest.json> [options]: runs every case of the manifest
+// and returns 0 only when all of them pass.
+int runTestManifest(int argc, const char* argv[]) {
+    std::string manifestFile;
+    std::string junitFile;
+    std::string jsonFile;
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t maxSteps = 1000000;
+    Simulator::Engine engine = Simulator::fastestEngine();
+    bool lockstep = false;
+    bool verbose = false;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if ((arg == "--junit" || arg == "--json") && hasValue) {
+            (arg == "--junit" ? junitFile : jsonFile) = argv[++i];
+        } else if ((arg == "-j" || arg == "--jobs" || arg == "--max-steps") && hasValue) {
+            try {
+                if (arg == "--max-steps") {
+                    maxSteps = std::stoull(argv[++i]);
+                } else {
+                    jobs = static_cast<unsigned>(std::stoul(argv[++i]));
+                    if (jobs == 0) {
+                        jobs = std::max(1u, std::thread::hardware_concurrency());
+                    }
+                }
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid number '" << argv[i] << "' for " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg == "--engine" && hasValue) {
+            const std::string name = argv[++i];
+            if (name == "interpreter") {
+                engine = Simulator::Engine::INTERPRETER;
+            } else if (name == "blocks") {
+                engine = Simulator::Engine::BLOCKS;
+            } else if (name == "jit") {
+                engine = Simulator::Engine::JIT;
+            } else if (name == "lockstep") {
+                lockstep = true;
+            } else {
+                std::cerr << "Error: --engine expects interpreter, blocks, jit or lockstep" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-v" || arg == "--verbose") {
+            verbose = true;
+        } else if (arg[0] != '-' && manifestFile.empty()) {
+            manifestFile = arg;
+        } else {
+            std::cerr << "Error: Unexpected argument '" << arg << "'\n"
+                      << "Use -h for help" << std::endl;
+            return 1;
+        }
+    }
+    if (manifestFile.empty()) {
+        std::cerr << "Error: test requires a manifest file" << std::endl;
+        return 1;
+    }
 
-void writeMIF(const std::vector<uint16_t>& machineCode,
-              const std::vector<bool>& isData,
-              std::string& outputFile,
-              int depth = 256);
+    try {
+        const TestManifest manifest = loadTestManifest(manifestFile, maxSteps);
+        const TestReport report = runTests(manifest, jobs, engine, lockstep);
+        writeTestSummary(std::cout, manifest, report, verbose);
+        if (!junitFile.empty()) {
+            std::ostringstream xml;
+            writeJUnitReport(xml, manifest, report);
+            writeFileIfChanged(junitFile, xml.str());
+        }
+        if (!jsonFile.empty()) {
+            std::ostringstream json;
+            writeJsonReport(json, manifest, report);
+            writeFileIfChanged(jsonFile, json.str());
+        }
+        return report.failed || report.errors ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
 
 void printHelp(const char* programName) {
-    std::cout << "Usage: " << programName << " input_file [options]\n"
+    std::cout << "Usage: " << programName << " input_file [more_input_files] [options]\n"
+              << "       " << programName << " test manifest.json [test options]\n"
               << "Assemble qCore assembly to MIF format\n\n"
               << "Options:\n"
               << " -o <file>, --output <file>              Specify output file (default: a.mif)\n"
               << " -v, --verbose                           Enable verbose output\n"
-              << " -h, --help                              Display this help message\n"; 
+              << " -j <n>, --jobs <n>                      Lex and encode on n threads, 0 = all cores (default: 1,\n"
+              << "                                         all cores for several input files)\n"
+              << " --mif-comments <all|code|none>          Which MIF words get a disassembly comment (default: all)\n"
+              << " --no-rle                                Write one MIF line per word instead of address ranges\n"
+              << " -g, --debug-info                        Also write an address-to-source map (.sbdi)\n"
+              << " -O, --optimize                          Apply peephole optimizations to the emitted code\n"
+              << " --strip-unused                          Remove unreachable code and unused .word tables\n"
+              << " --profile                               Run the program and print an annotated execution profile\n"
+              << " --max-steps <n>                         Stop the profiled run after n instructions (default 10000000)\n"
+              << " --wcet                                  Print worst-case cycle counts per routine\n"
+              << " --loop-bound <label>=<n>                Loop headed by label runs at most n times (--wcet)\n"
+              << " --incbin-endian <little|big>            Byte order of .incbin files (default: little)\n"
+              << " -D <name>[=<n>]                         Define name (default 1) for .if/.ifdef and the code\n"
+              << " -w, --watch                             Reassemble whenever the input is saved\n"
+              << " --lsp                                   Run as a language server on stdin/stdout (no input file)\n"
+              << " -h, --help                              Display this help message\n\n"
+              << "Test options:\n"
+              << " -j <n>, --jobs <n>                      Run cases on n threads (default: all cores)\n"
+              << " --max-steps <n>                         Step limit of cases without maxSteps (default 1000000)\n"
+              << " --junit <file>                          Write a JUnit XML report\n"
+              << " --json <file>                           Write a JSON report\n"
+              << " --engine <interpreter|blocks|jit>       Simulator engine (default: jit on x86-64 Linux, else blocks)\n"
+              << " --engine lockstep                       Run the cases of a program 8 or 16 at a time in SIMD lanes\n"
+              << " -v, --verbose                           List passing cases too\n"; 
 }
 
 int main(int argc, const char* argv[]) {
     std::string outputFile = "a.mif";
     bool verbose = false;
+    unsigned jobs = 1;
+    bool watchInput = false;
+    bool debugInfo = false;
+    MifOptions mifOptions;
+    bool profile = false;
+    uint64_t maxSteps = 10000000;
+    bool wcet = false;
+    bool stripUnused = false;
+    bool optimize = false;
+    std::vector<std::pair<std::string, uint64_t>> loopBounds;
+    bool incbinBigEndian = false;
+    std::vector<std::pair<std::string, int>> defines;
     std::string inputFile;
+    std::vector<std::string> moreInputFiles;
+    bool jobsGiven = false;
 
     for(int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -43,6 +243,20 @@ int main(int argc, const char* argv[]) {
             printHelp("sbasmCpp");
             return 0;
         }
+        if (arg == "--lsp") {
+#if defined(_WIN32)
+            // Content-Length counts bytes; keep CRLF translation out of it.
+            _setmode(_fileno(stdin), _O_BINARY);
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+            std::ios::sync_with_stdio(false);
+            LanguageServer server(std::cin, std::cout);
+            return server.run();
+        }
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "test") {
+        return runTestManifest(argc, argv);
     }
 
     if (argc < 2) {
@@ -65,6 +279,106 @@ int main(int argc, const char* argv[]) {
         } else if (arg == "-v" || arg == "--verbose") {
             verbose = true;
             i += 1;
+        } else if (arg == "--mif-comments") {
+            std::string mode = i + 1 < argc ? argv[i + 1] : "";
+            if (mode == "all") {
+                mifOptions.comments = MifComments::ALL;
+            } else if (mode == "code") {
+                mifOptions.comments = MifComments::INSTRUCTIONS;
+            } else if (mode == "none") {
+                mifOptions.comments = MifComments::NONE;
+            } else {
+                std::cerr << "Error: --mif-comments expects all, code or none" << std::endl;
+                return 1;
+            }
+            i += 2;
+        } else if (arg == "--no-rle") {
+            mifOptions.compressRuns = false;
+            i += 1;
+        } else if (arg == "-g" || arg == "--debug-info") {
+            debugInfo = true;
+            i += 1;
+        } else if (arg == "--profile") {
+            profile = true;
+            i += 1;
+        } else if (arg == "--max-steps") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --max-steps requires a number" << std::endl;
+                return 1;
+            }
+            try {
+                maxSteps = std::stoull(argv[i + 1]);
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid step count '" << argv[i + 1] << "'" << std::endl;
+                return 1;
+            }
+            i += 2;
+        } else if (arg == "-O" || arg == "--optimize") {
+            optimize = true;
+            i += 1;
+        } else if (arg == "--strip-unused") {
+            stripUnused = true;
+            i += 1;
+        } else if (arg == "--wcet") {
+            wcet = true;
+            i += 1;
+        } else if (arg == "--loop-bound") {
+            std::string bound = i + 1 < argc ? argv[i + 1] : "";
+            size_t equals = bound.find('=');
+            try {
+                if (equals == std::string::npos || equals == 0) {
+                    throw std::invalid_argument(bound);
+                }
+                loopBounds.push_back({bound.substr(0, equals), std::stoull(bound.substr(equals + 1))});
+            } catch (const std::exception&) {
+                std::cerr << "Error: --loop-bound expects <label>=<count>" << std::endl;
+                return 1;
+            }
+            i += 2;
+        } else if (arg == "--incbin-endian") {
+            std::string order = i + 1 < argc ? argv[i + 1] : "";
+            if (order != "little" && order != "big") {
+                std::cerr << "Error: --incbin-endian expects little or big" << std::endl;
+                return 1;
+            }
+            incbinBigEndian = order == "big";
+            i += 2;
+        } else if (arg.compare(0, 2, "-D") == 0) {
+            std::string define = arg.length() > 2 ? arg.substr(2) : (i + 1 < argc ? argv[i + 1] : "");
+            const size_t equals = define.find('=');
+            const std::string name = define.substr(0, equals);
+            int64_t value = 1;
+            if (name.empty() || !charscan::is(name[0], charscan::IDENT_START) ||
+                (equals != std::string::npos &&
+                 (parseNumericLiteral(define.data() + equals + 1, define.data() + define.length(), value) !=
+                      NumberStatus::OK || value < INT32_MIN || value > INT32_MAX))) {
+                std::cerr << "Error: -D expects <name> or <name>=<number>" << std::endl;
+                return 1;
+            }
+            defines.push_back({name, static_cast<int>(value)});
+            i += arg.length() > 2 ? 1 : 2;
+        } else if (arg == "-w" || arg == "--watch") {
+            watchInput = true;
+            i += 1;
+        } else if (arg == "-j" || arg == "--jobs") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: -j requires a thread count" << std::endl;
+                return 1;
+            }
+            try {
+                jobs = static_cast<unsigned>(std::stoul(argv[i + 1]));
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid thread count '" << argv[i + 1] << "'" << std::endl;
+                return 1;
+            }
+            if (jobs == 0) {
+                jobs = std::max(1u, std::thread::hardware_concurrency());
+            }
+            jobsGiven = true;
+            i += 2;
+        } else if (arg[0] != '-') {
+            moreInputFiles.push_back(arg);
+            i += 1;
         } else {
             std::cerr << "Error: Unexpected argument '" << arg << "'\n"
                       << "Use -h for help" << std::endl;
@@ -72,175 +386,102 @@ int main(int argc, const char* argv[]) {
         }
     }
 
-    std::ifstream file(inputFile);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file '" << inputFile << "'" << std::endl;
-        return 1;
+    if (!moreInputFiles.empty()) {
+        if (watchInput || debugInfo || profile || wcet) {
+            std::cerr << "Error: --watch, -g, --profile and --wcet take a single input file" << std::endl;
+            return 1;
+        }
+        // Several files are lexed and parsed concurrently.
+        if (!jobsGiven) {
+            jobs = std::max(1u, std::thread::hardware_concurrency());
+        }
     }
 
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string input = buffer.str();
-    file.close();
+    AssembleOptions options;
+    options.jobs = jobs;
+    options.trace = verbose ? &std::cout : nullptr;
+    options.debugInfo = debugInfo || profile || wcet;
+    options.eliminateDeadCode = stripUnused;
+    options.optimize = optimize;
+    options.incbinBigEndian = incbinBigEndian;
+    options.defines = defines;
+    const size_t slash = inputFile.find_last_of("/\\");
+    if (slash != std::string::npos && moreInputFiles.empty()) {
+        options.includeDirectory = inputFile.substr(0, std::max<size_t>(slash, 1));
+    }
 
-    int memoryDepth = 256;
-    
-    std::istringstream iss(input);
-    std::string line;
-    while (std::getline(iss, line)) {
-        if (line.find("DEPTH") != std::string::npos) {
-            size_t pos = line.find('=');
-            if (pos != std::string::npos) {
-                std::string depthStr = line.substr(pos + 1);
-                memoryDepth = std::stoi(depthStr);
-            }
-        }
+    if (watchInput) {
+        return watch(inputFile, outputFile, options, mifOptions, debugInfo);
     }
 
-    try {
-        if (verbose) {
-            std::cout << "\n=== Lexical Analysis ===\n";
+    std::vector<SourceFile> sources(1 + moreInputFiles.size());
+    sources[0].name = inputFile;
+    for (size_t i = 0; i < moreInputFiles.size(); i++) {
+        sources[i + 1].name = moreInputFiles[i];
+    }
+    for (SourceFile& source : sources) {
+        if (!readFile(source.name, source.text)) {
+            std::cerr << "Error: Could not open file '" << source.name << "'" << std::endl;
+            return 1;
         }
-        Lexer lexer(input);
-        std::vector<Token> tokens = lexer.tokenize();
+    }
+    const std::string& input = sources[0].text;
+
+    AssemblerContext context;
+    const AssembleResult& result = sources.size() == 1 ? context.assemble(input, options)
+                                                       : context.assembleFiles(sources, options);
+    if (!result.success) {
+        const Diagnostic& error = result.diagnostics.front();
+        std::cerr << "\nError: " << (error.file.empty() ? "" : error.file + ": ") << error.message << std::endl;
+        return 1;
+    }
 
-        if (verbose) {
-            std::cout << "Tokens:\n";
-            for (const auto& token : tokens) {
-                std::cout << "Line " << token.line << ", Col " << token.column 
-                         << ": Type=" << static_cast<int>(token.type) 
-                         << ", Value=\"" << token.value << "\"\n";
-            }
+    try {
+        const bool written = writeMIF(result.words, result.isData, result.segments, outputFile, result.depth, mifOptions);
+        if (debugInfo && !writeDebugInfo(result, debugInfoPath(outputFile)) && verbose) {
+            std::cout << debugInfoPath(outputFile) << " is unchanged, not rewritten\n";
         }
-
-        if (verbose) {
-            std::cout << "\n=== Parsing ===\n";
+        if (written) {
+            std::cout << "\nAssembly completed successfully. Output written to " << outputFile << "\n";
+        } else {
+            std::cout << "\nAssembly completed successfully. " << outputFile
+                      << " is unchanged, not rewritten\n";
         }
-        Parser parser(tokens);
-        std::vector<std::unique_ptr<Statement>> ast = parser.parse();
 
-        if (verbose) {
-            std::cout << "Abstract Syntax Tree:\n";
-            for (const auto& stmt : ast) {
-                std::cout << "Line " << stmt->line << ", Col " << stmt->column << ": ";
-                switch(stmt->type) {
-                    case StatementType::LABEL: {
-                        auto label = static_cast<Label*>(stmt.get());
-                        std::cout << "LABEL \"" << label->name << "\"\n";
-                        break;
-                    }
-                    case StatementType::DIRECTIVE: {
-                        auto directive = static_cast<Directive*>(stmt.get());
-                        std::cout << "DIRECTIVE " << directive->name;
-                        if (!directive->label.empty()) 
-                            std::cout << " " << directive->label;
-                        if (!directive->value.empty()) 
-                            std::cout << " " << directive->value;
-                        std::cout << "\n";
-                        break;
-                    }
-                    case StatementType::INSTRUCTION: {
-                        auto instr = static_cast<Instruction*>(stmt.get());
-                        std::cout << "INSTRUCTION " << instr->opcode;
-                        if (!instr->operand1.empty()) 
-                            std::cout << " " << instr->operand1;
-                        if (!instr->operand2.empty()) 
-                            std::cout << " " << instr->operand2;
-                        std::cout << "\n";
-                        break;
-                    }
+        if (optimize) {
+            for (const auto& rule : result.peephole.rules) {
+                if (rule.applied) {
+                    std::cout << "Optimized " << rule.rule << ": " << rule.applied << "x\n";
                 }
             }
+            std::cout << "Peephole optimization saved " << result.peephole.wordsSaved << " words\n";
         }
-
-        SymbolTable symbolTable;
-        int currentAddress = 0;
-        
-        std::vector<bool> isData;
-
-        if (verbose) {
-            std::cout << "\n=== First Pass: Symbol Collection ===\n";
-        }
-        for(const auto& stmt : ast) {
-            switch(stmt->type) {
-                case StatementType::LABEL: {
-                    auto label = static_cast<Label*>(stmt.get());
-                    if (verbose) {
-                        std::cout << "Adding label: " << label->name << " at address 0x" 
-                                 << std::hex << currentAddress << std::dec << "\n";
-                    }
-                    symbolTable.addLabel(label->name, currentAddress);
-                    break;
-                }
-               case StatementType::DIRECTIVE: {
-                    auto directive = static_cast<Directive*>(stmt.get());
-                    if(directive->name == ".define") {
-                        int64_t value;
-                        std::string valStr = directive->value;
-                        
-                        if (valStr.size() >= 2 && (valStr.substr(0, 2) == "0b" || valStr.substr(0, 2) == "0B")) {
-                            value = std::stoll(valStr.substr(2), nullptr, 2);
-                        }
-                        else if (valStr.size() >= 2 && (valStr.substr(0, 2) == "0x" || valStr.substr(0, 2) == "0X")) {
-                            value = std::stoll(valStr.substr(2), nullptr, 16);
-                        }
-                        else {
-                            value = std::stoll(valStr, nullptr, 0);
-                        }
-
-                        if (verbose) {
-                            std::cout << "Adding define: " << directive->label << " = 0x" 
-                                    << std::hex << value << std::dec << "\n";
-                        }
-                        symbolTable.addDefine(directive->label, value);
-                    } else if(directive->name == ".word") {
-                        if (verbose) {
-                            std::cout << "Word directive at address 0x" 
-                                    << std::hex << currentAddress << std::dec << "\n";
-                        }
-                        currentAddress++;
-                        isData.push_back(true);
-                    }
-                    break;
-                } 
-                case StatementType::INSTRUCTION:
-                    auto instr = static_cast<Instruction*>(stmt.get());
-                    int numWords = 1;
-                    
-                    if (instr->opcode == "mv" && instr->isLabelImmediate) {
-                        numWords = 2;
-                    }
-
-                    if (verbose) {
-                        std::cout << "Instruction at address 0x" 
-                                    << std::hex << currentAddress << std::dec 
-                                    << " (size=" << numWords << ")\n";
-                    }
-
-                    currentAddress += numWords;
-
-                    for(int i = 0; i < numWords; i++) {
-                        isData.push_back(false);
-                    }
-                    break;
+        if (stripUnused) {
+            for (const auto& range : result.elimination.removed) {
+                std::cout << "Removed " << (range.isData ? "data " : "code ") << range.name
+                          << " (line " << range.line << ", " << range.words << " words)\n";
             }
+            std::cout << "Unused code and data removal saved " << result.elimination.wordsSaved << " words\n";
         }
 
-        Encoder encoder(symbolTable);
-        std::vector<uint16_t> machineCode = encoder.encode(ast);
+        if (profile) {
+            Simulator simulator;
+            Simulator::Profile counters;
+            simulator.load(result.words, result.segments);
+            Simulator::RunResult run = simulator.run(maxSteps, counters);
+            std::cout << "\n";
+            writeProfileReport(std::cout, input, result, counters, run);
+        }
 
-        if (verbose) {
-            std::cout << "\n=== Final Machine Code ===\n";
-            for (size_t i = 0; i < machineCode.size(); i++) {
-                std::cout << " " << std::hex << std::setw(3) << std::setfill('0') << i 
-                         << ":  " << std::setw(4) << std::setfill('0') 
-                         << machineCode[i] << std::dec << "\n";
+        if (wcet) {
+            WcetAnalysis analysis(result);
+            analysis.addSourceBounds(input);
+            for (const auto& bound : loopBounds) {
+                analysis.addLoopBound(bound.first, bound.second);
             }
+            std::cout << "\n";
+            writeWcetReport(std::cout, analysis.run());
         }
-
-        writeMIF(machineCode, isData, outputFile, memoryDepth);
-        std::cout << "\nAssembly completed successfully. Output written to " << outputFile << "\n";
-
     } catch (const std::exception& e) {
         std::cerr << "\nError: " << e.what() << std::endl;
         return 1;
@@ -248,156 +489,3 @@ int main(int argc, const char* argv[]) {
 
     return 0;
 }
-
-void writeMIF(const std::vector<uint16_t>& machineCode,
-    const std::vector<bool>& isData,
-    std::string& outputFile,
-    int depth) {
-
-    if(outputFile.size() < 4 || outputFile.substr(outputFile.size() - 4) != ".mif") {
-        outputFile += ".mif";
-    }
-
-    std::ofstream out(outputFile);
-        if (!out.is_open()) {
-        throw std::runtime_error("Could not open output file: " + outputFile);
-    }
-
-    out << "WIDTH = 16;\n";
-    out << "DEPTH = " << depth << ";\n";
-    out << "ADDRESS_RADIX = HEX;\n";
-    out << "DATA_RADIX = HEX;\n\n";
-    out << "CONTENT\n";
-    out << "BEGIN\n";
-
-    const char* regNames[] = {"r0", "r1", "r2", "r3", "r4", "sp", "lr", "pc"};
-    const char* conditions[] = {"b   ", "beq ", "bne ", "bcc ", "bcs ", "bpl ", "bmi ", "bl  "};
-
-    for (size_t i = 0; i < machineCode.size(); i++) {
-        out << std::hex << std::setw(1) << i;
-        out << std::string(i > 0xf ? 6 : 7, ' ');
-
-        out << ": " << std::setw(4) << std::setfill('0') << machineCode[i] << ";"
-        << std::string(8, ' ') << "% ";
-
-        if (i < isData.size() && isData[i]) {
-        out << "data";
-    } else {
-        uint16_t instr = machineCode[i];
-        uint16_t opcode = (instr >> 13) & 0x7;
-        uint16_t imm = (instr >> 12) & 0x1;
-        uint16_t rX = (instr >> 9) & 0x7;
-        uint16_t rY = instr & 0x7;
-        uint16_t immediate = instr & 0x1FF;
-        
-        std::ostringstream oss;
-        switch (opcode) {
-            case 0:
-                if (imm) {
-                    oss << "mv   " << regNames[rX] << ", #0x" << std::hex << immediate;
-                } else {
-                    oss << "mv   " << regNames[rX] << ", " << regNames[rY];
-                }
-                break;
-
-            case 1:
-                if (imm) {
-                    oss << "mvt  " << regNames[rX] << ", #0x" << std::hex << (immediate & 0xFF);
-                } else {
-                    uint16_t cond = (instr >> 9) & 0x7;
-                    int16_t offset = immediate;
-                    if (offset & 0x100) {
-                        offset |= 0xFF00;
-                    }
-                    int target = i + 1 + offset;
-                    oss << conditions[cond] << "0x" << std::hex << target;
-                }
-                break;
-
-            case 2:
-                if (imm) {
-                    oss << "add  " << regNames[rX] << ", #0x" << std::hex << immediate;
-                } else {
-                    oss << "add  " << regNames[rX] << ", " << regNames[rY];
-                }
-                break;
-
-            case 3:
-                if (imm) {
-                    oss << "sub  " << regNames[rX] << ", #0x" << std::hex << immediate;
-                } else {
-                    oss << "sub  " << regNames[rX] << ", " << regNames[rY];
-                }
-                break;
-
-            case 4:
-                if (imm) {
-                    oss << "pop  " << regNames[rX];
-                } else {
-                    oss << "ld   " << regNames[rX] << ", [" << regNames[rY] << "]";
-                }
-                break;
-
-            case 5:
-                if (imm) {
-                    oss << "push " << regNames[rX];
-                } else {
-                    oss << "st   " << regNames[rX] << ", [" << regNames[rY] << "]";
-                }
-                break;
-
-            case 6:
-                if (imm) {
-                    oss << "and  " << regNames[rX] << ", #0x" << std::hex << immediate;
-                } else {
-                    oss << "and  " << regNames[rX] << ", " << regNames[rY];
-                }
-                break;
-
-                case 7:
-                {
-                    uint16_t op_subtype = (instr >> 4) & 0x7;
-                    if (op_subtype == 1) {
-                        oss << "xor  " << regNames[rX] << ", " << regNames[rY];
-                    }
-                    else {
-                        uint16_t shift_flag = (instr >> 8) & 0x1;
-                        
-                        if (shift_flag) {
-                            uint16_t imm_shift = (instr >> 7) & 0x1;
-                            uint16_t shift_type = (instr >> 5) & 0x3;
-                            uint16_t shift_amount = instr & 0xF;
-                            const char* shift_types[] = {"lsl", "lsr", "asr", "ror"};
-                            
-                            oss << shift_types[shift_type] << "  " << regNames[rX];
-                            if (imm_shift) {
-                                oss << ", #0x" << std::hex << shift_amount;
-                            } else {
-                                oss << ", " << regNames[rY];
-                            }
-                        } else if (imm) {
-                            if (immediate & 0x100) {
-                                immediate |= 0xFF00;
-                                oss << "cmp  " << regNames[rX] << ", #-0x" << std::hex << (-immediate);
-                            } else {
-                                oss << "cmp  " << regNames[rX] << ", #0x" << std::hex << immediate;
-                            }
-                        } else {
-                            oss << "cmp  " << regNames[rX] << ", " << regNames[rY];
-                        }
-                    }
-                }
-                break;
-        }
-            out << oss.str();
-        }
-            out << " %\n";
-        }
-
-        if(machineCode.size() < static_cast<size_t>(depth)) {
-        out << "[" << std::hex << machineCode.size() << ".." << (depth - 1) << "]" << " : 0000;\n";
-    }
-
-    out << "END;\n";
-    out.close();
-}
\ No newline at end of file
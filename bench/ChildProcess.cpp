@@ -0,0 +1,173 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "ChildProcess.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+#if defined(_WIN32)
+// Quotes an argument for CommandLineToArgvW-style parsing.
+static std::string quoteArgument(const std::string& arg) {
+    if (!arg.empty() && arg.find_first_of(" \t\"") == std::string::npos) {
+        return arg;
+    }
+    std::string quoted = "\"";
+    size_t backslashes = 0;
+    for (char c : arg) {
+        if (c == '\\') {
+            backslashes++;
+            continue;
+        }
+        quoted.append(c == '"' ? backslashes * 2 + 1 : backslashes, '\\');
+        backslashes = 0;
+        quoted += c;
+    }
+    quoted.append(backslashes * 2, '\\');
+    return quoted + "\"";
+}
+
+ProcessStats runProcess(const std::string& program, const std::vector<std::string>& args) {
+    std::string commandLine = quoteArgument(program);
+    for (const std::string& arg : args) {
+        commandLine += " " + quoteArgument(arg);
+    }
+
+    SECURITY_ATTRIBUTES inherit = {sizeof(inherit), nullptr, TRUE};
+    HANDLE nul = CreateFileA("NUL", GENERIC_WRITE, FILE_SHARE_WRITE, &inherit, OPEN_EXISTING, 0, nullptr);
+    STARTUPINFOA startup = {};
+    startup.cb = sizeof(startup);
+    startup.dwFlags = STARTF_USESTDHANDLES;
+    startup.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+    startup.hStdOutput = nul;
+    startup.hStdError = nul;
+    PROCESS_INFORMATION info = {};
+
+    const auto start = std::chrono::steady_clock::now();
+    if (!CreateProcessA(nullptr, &commandLine[0], nullptr, nullptr, TRUE, 0, nullptr, nullptr,
+                        &startup, &info)) {
+        CloseHandle(nul);
+        throw std::runtime_error("Could not start '" + program + "'");
+    }
+    WaitForSingleObject(info.hProcess, INFINITE);
+    ProcessStats stats;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    DWORD exitCode = 0;
+    GetExitCodeProcess(info.hProcess, &exitCode);
+    stats.exitCode = static_cast<int>(exitCode);
+    PROCESS_MEMORY_COUNTERS memory = {};
+    if (GetProcessMemoryInfo(info.hProcess, &memory, sizeof(memory))) {
+        stats.peakRssKb = static_cast<long>(memory.PeakWorkingSetSize / 1024);
+        stats.minorFaults = static_cast<long>(memory.PageFaultCount);
+    }
+    CloseHandle(info.hThread);
+    CloseHandle(info.hProcess);
+    CloseHandle(nul);
+    return stats;
+}
+
+std::vector<std::string> listFiles(const std::string& directory, const std::string& extension) {
+    std::vector<std::string> names;
+    WIN32_FIND_DATAA entry;
+    HANDLE find = FindFirstFileA((directory + "\\*" + extension).c_str(), &entry);
+    if (find == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Could not read directory '" + directory + "'");
+    }
+    do {
+        if (!(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+            names.push_back(entry.cFileName);
+        }
+    } while (FindNextFileA(find, &entry));
+    FindClose(find);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+void makeDirectory(const std::string& directory) {
+    _mkdir(directory.c_str());
+}
+#else
+ProcessStats runProcess(const std::string& program, const std::vector<std::string>& args) {
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(program.c_str()));
+    for (const std::string& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    pid_t pid;
+    const int error = posix_spawn(&pid, program.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (error != 0) {
+        throw std::runtime_error("Could not start '" + program + "'");
+    }
+
+    int status = 0;
+    struct rusage usage;
+    while (wait4(pid, &status, 0, &usage) < 0) {
+        if (errno != EINTR) {
+            throw std::runtime_error("Lost track of '" + program + "'");
+        }
+    }
+    ProcessStats stats;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+#if defined(__APPLE__)
+    stats.peakRssKb = usage.ru_maxrss / 1024;  // bytes on macOS
+#else
+    stats.peakRssKb = usage.ru_maxrss;
+#endif
+    stats.minorFaults = usage.ru_minflt;
+    stats.majorFaults = usage.ru_majflt;
+    return stats;
+}
+
+std::vector<std::string> listFiles(const std::string& directory, const std::string& extension) {
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        throw std::runtime_error("Could not read directory '" + directory + "'");
+    }
+    std::vector<std::string> names;
+    while (dirent* entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        struct stat info;
+        if (name.size() > extension.size() &&
+            name.compare(name.size() - extension.size(), extension.size(), extension) == 0 &&
+            stat((directory + "/" + name).c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+            names.push_back(name);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+void makeDirectory(const std::string& directory) {
+    mkdir(directory.c_str(), 0755);
+}
+#endif
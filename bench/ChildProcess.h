@@ -0,0 +1,31 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Runs a program as a child process and reports what it cost
+//              as a whole: wall time including startup and exit, peak
+//              resident set size and page faults. Uses posix_spawn/wait4 on
+//              POSIX and CreateProcess/GetProcessMemoryInfo on Windows.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include <string>
+#include <vector>
+
+struct ProcessStats {
+    int exitCode = -1;
+    double seconds = 0;
+    long peakRssKb = 0;
+    long minorFaults = 0;   // Windows reports all faults here
+    long majorFaults = 0;   // faults that had to read from disk (POSIX only)
+};
+
+// Runs program with args, discarding its stdout and stderr, and waits for it.
+// Throws std::runtime_error when the process cannot be started.
+ProcessStats runProcess(const std::string& program, const std::vector<std::string>& args);
+
+// Names of the regular files in directory ending in extension, sorted.
+// Throws std::runtime_error when the directory cannot be read.
+std::vector<std::string> listFiles(const std::string& directory, const std::string& extension);
+
+// Creates directory if it does not exist yet (the parent must exist).
+void makeDirectory(const std::string& directory);
@@ -0,0 +1,121 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// ----------------------------------------------------------------------------
+
+#include "ProgramGenerator.h"
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+class Random {
+private:
+    uint32_t state;
+
+public:
+    explicit Random(uint32_t seed) : state(seed ? seed : 1) {}
+
+    // xorshift32, so the generated text does not depend on the standard library
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    int below(int bound) { return static_cast<int>(next() % static_cast<uint32_t>(bound)); }
+};
+
+const char* const ALU_OPS[] = {"add", "sub", "and", "cmp", "mv"};
+const char* const REG_OPS[] = {"add", "sub", "and", "xor", "cmp", "mv"};
+const char* const SHIFT_OPS[] = {"lsl", "lsr", "asr", "ror"};
+
+std::string reg(Random& random) {
+    return "r" + std::to_string(random.below(5));   // keep sp, lr and pc intact
+}
+
+// One loop-body statement; returns the words it occupies.
+int bodyStatement(std::ostringstream& out, Random& random, int routine) {
+    out << "        ";
+    switch (random.below(8)) {
+    case 0:
+    case 1:
+        out << ALU_OPS[random.below(5)] << "   " << reg(random) << ", #" << random.below(256);
+        break;
+    case 2:
+    case 3:
+        out << REG_OPS[random.below(6)] << "   " << reg(random) << ", " << reg(random);
+        break;
+    case 4:
+        out << SHIFT_OPS[random.below(4)] << "   " << reg(random) << ", #" << 1 + random.below(15);
+        break;
+    case 5:
+        out << "ld    " << reg(random) << ", [r0]";
+        break;
+    case 6:
+        out << "st    " << reg(random) << ", [r0]";
+        break;
+    default:
+        out << "mv    " << reg(random) << ", =C" << routine << "\n";
+        return 2;
+    }
+    if (random.below(4) == 0) {
+        out << "      // step " << random.below(1000);
+    }
+    out << "\n";
+    return 1;
+}
+
+}
+
+std::string generateProgram(int words, uint32_t seed) {
+    if (words < 1 || words > 0xF000) {
+        throw std::runtime_error("Generated programs hold 1 to 0xF000 words");
+    }
+    Random random(seed);
+    int depth = 256;
+    while (depth < words + 64) depth *= 2;
+
+    std::ostringstream out;
+    out << "// DEPTH = " << depth << "\n"
+        << "// Generated benchmark program, " << words << " words\n\n"
+        << "        mv    sp, =0x" << std::hex << depth - 1 << std::dec << "\n"
+        << "MAIN:   bl    R0\n"
+        << "END:    b     END\n\n";
+    int emitted = 4;
+
+    for (int routine = 0; emitted < words; routine++) {
+        const int tableLength = 1 + random.below(8);
+        out << ".define C" << routine << " 0x" << std::hex << random.below(0x10000) << std::dec << "\n"
+            << "// Routine " << routine << ": walks T" << routine << " (" << tableLength << " words)\n"
+            << "R" << routine << ":" << (routine < 10 ? "     " : routine < 100 ? "    " : "  ")
+            << "push  r6\n"
+            << "        mv    r0, =T" << routine << "\n"
+            << "        mv    r1, #" << tableLength << "\n"
+            << "L" << routine << ":\n";
+        emitted += 5;
+
+        const int bodyLength = 4 + random.below(20);
+        for (int i = 0; i < bodyLength; i++) {
+            emitted += bodyStatement(out, random, routine);
+        }
+        out << "        add   r0, #1\n"
+            << "        sub   r1, #1\n"
+            << "        bne   L" << routine << "\n";
+        emitted += 3;
+        // Every routine but the last calls the next one.
+        if (emitted + 4 + tableLength < words) {
+            out << "        bl    R" << routine + 1 << "\n";
+            emitted++;
+        }
+        out << "        pop   r6\n"
+            << "        mv    pc, lr\n"
+            << "T" << routine << ":" << (routine < 10 ? "     " : routine < 100 ? "    " : "  ") << ".word ";
+        for (int i = 0; i < tableLength; i++) {
+            out << (i ? ", " : "") << random.below(0x10000);
+        }
+        out << "\n\n";
+        emitted += 2 + tableLength;
+    }
+    return out.str();
+}
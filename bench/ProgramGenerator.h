@@ -0,0 +1,16 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: Generates large, valid qCore programs for the benchmark: a
+//              chain of table-walking routines with loops, calls, .define
+//              constants, comments and .word tables, in the proportions the
+//              hand-written programs in bench/corpus have.
+// ----------------------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Returns a program of at least words memory words (at most 0xF000). The
+// same words and seed always give the same text.
+std::string generateProgram(int words, uint32_t seed);
@@ -0,0 +1,79 @@
+// DEPTH = 512
+// Software multiply and divide for a CPU without either, applied to a small
+// table of operand pairs. Results go to RESULTS as product, quotient, remainder.
+.define PAIRS 6
+
+        mv    sp, =0x1FF
+MAIN:   mv    r3, =OPERANDS
+        mv    r4, =RESULTS
+        mv    r2, #PAIRS
+EACH:   push  r2
+        ld    r0, [r3]
+        add   r3, #1
+        ld    r1, [r3]
+        add   r3, #1
+        push  r0
+        push  r1
+        bl    MUL
+        st    r0, [r4]
+        add   r4, #1
+        pop   r1
+        pop   r0
+        bl    DIV
+        st    r0, [r4]
+        add   r4, #1
+        st    r1, [r4]
+        add   r4, #1
+        pop   r2
+        sub   r2, #1
+        bne   EACH
+END:    b     END
+
+// r0 = r0 * r1 (low 16 bits), shift-and-add. Clobbers r1, r2.
+MUL:    mv    r2, #0
+MLOOP:  cmp   r1, #0
+        beq   MDONE
+        push  r1
+        and   r1, #1
+        beq   MSKIP
+        add   r2, r0
+MSKIP:  pop   r1
+        lsl   r0, #1
+        lsr   r1, #1
+        b     MLOOP
+MDONE:  mv    r0, r2
+        mv    pc, lr
+
+// r0 = r0 / r1, r1 = r0 % r1 (unsigned, restoring division).
+// Clobbers r2. Division by zero returns 0xFFFF and the dividend.
+DIV:    push  r3
+        push  r4
+        mv    r2, #0              // remainder
+        mv    r3, #0              // quotient
+        mv    r4, #16             // bits left
+DLOOP:  lsl   r3, #1
+        lsl   r2, #1
+        lsl   r0, #1
+        bcc   DZERO
+        add   r2, #1
+DZERO:  cmp   r2, r1
+        bcc   DNEXT               // remainder < divisor
+        sub   r2, r1
+        add   r3, #1
+DNEXT:  sub   r4, #1
+        bne   DLOOP
+        mv    r0, r3
+        mv    r1, r2
+        pop   r4
+        pop   r3
+        mv    pc, lr
+
+OPERANDS:
+        .word 7, 6
+        .word 1000, 33
+        .word 0x1234, 0x10
+        .word 255, 255
+        .word 40000, 3
+        .word 12, 0
+RESULTS:
+        .space 18
@@ -0,0 +1,53 @@
+// DEPTH = 256
+// Sorts ARRAY in place (ascending, signed) and shows the smallest value.
+.define LED_ADDRESS 0x1000
+.define LENGTH 12
+
+        mv    sp, #0xFF
+MAIN:   mv    r0, =ARRAY
+        mv    r1, #LENGTH
+        bl    SORT
+        mv    r0, =ARRAY
+        ld    r0, [r0]
+        mv    r4, =LED_ADDRESS
+        st    r0, [r4]
+END:    b     END
+
+// r0 = address of the first word, r1 = number of words
+SORT:   push  r4
+        push  r3
+        push  r2
+        sub   r1, #1
+        beq   DONE                // zero or one element
+PASS:   mv    r2, r0              // current element
+        mv    r3, r1              // comparisons left in this pass
+        mv    r4, #0              // swaps in this pass
+STEP:   push  r4
+        ld    r4, [r2]
+        add   r2, #1
+        push  r0
+        ld    r0, [r2]
+        cmp   r4, r0
+        bmi   KEEP                // r4 < r0: already in order
+        beq   KEEP
+        st    r4, [r2]            // swap the pair
+        sub   r2, #1
+        st    r0, [r2]
+        add   r2, #1
+        pop   r0
+        pop   r4
+        add   r4, #1
+        b     NEXT
+KEEP:   pop   r0
+        pop   r4
+NEXT:   sub   r3, #1
+        bne   STEP
+        cmp   r4, #0
+        bne   PASS                // sorted once a pass made no swaps
+DONE:   pop   r2
+        pop   r3
+        pop   r4
+        mv    pc, lr
+
+ARRAY:  .word 93, -4, 17, 0x7FFF, 250, 3
+        .word 3, -32768, 48, 1000, 0b1011, 12
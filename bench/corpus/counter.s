@@ -0,0 +1,25 @@
+// DEPTH = 256
+// Counts up on the LEDs, about once per second at 50 MHz.
+.define LED_ADDRESS 0x1000
+.define DELAY_OUTER 0x60
+
+        mv    sp, #0xFF           // stack at the top of memory
+MAIN:   mv    r4, =LED_ADDRESS
+        mv    r0, #0              // counter
+LOOP:   st    r0, [r4]            // show the counter
+        bl    DELAY
+        add   r0, #1
+        b     LOOP
+
+// Busy-waits DELAY_OUTER * 0x10000 iterations. Keeps r0 and r4.
+DELAY:  push  r1
+        push  r2
+        mv    r1, #DELAY_OUTER
+OUTER:  mv    r2, =0xFFFF
+INNER:  sub   r2, #1
+        bne   INNER
+        sub   r1, #1
+        bne   OUTER
+        pop   r2
+        pop   r1
+        mv    pc, lr
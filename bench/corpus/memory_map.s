@@ -0,0 +1,55 @@
+// DEPTH = 4096
+// A reset vector, an interrupt-style handler at a fixed address and a
+// frame buffer cleared and patterned with block copies.
+.define FRAME_WORDS 256
+.define PATTERN_WORDS 16
+.define BLOCKS 16                 // FRAME_WORDS / PATTERN_WORDS
+
+        b     RESET               // address 0
+        .org  0x10
+HANDLER:
+        push  r0
+        mv    r0, =TICKS
+        ld    r1, [r0]
+        add   r1, #1
+        st    r1, [r0]
+        pop   r0
+        mv    pc, lr
+
+        .org  0x100
+RESET:  mv    sp, =0xFFF
+        mv    r0, =FRAME
+        mv    r1, #0
+        mv    r2, =FRAME_WORDS
+        bl    MEMSET
+        mv    r3, #BLOCKS
+        mv    r1, =FRAME
+FILL:   mv    r0, =PATTERN
+        mv    r2, #PATTERN_WORDS
+        bl    MEMCPY
+        sub   r3, #1
+        bne   FILL
+END:    b     END
+
+// Stores r1 into r2 words from r0. Clobbers r0, r2.
+MEMSET: st    r1, [r0]
+        add   r0, #1
+        sub   r2, #1
+        bne   MEMSET
+        mv    pc, lr
+
+// Copies r2 words from r0 to r1; r1 ends after the copy. Clobbers r0, r2, r4.
+MEMCPY: ld    r4, [r0]
+        st    r4, [r1]
+        add   r0, #1
+        add   r1, #1
+        sub   r2, #1
+        bne   MEMCPY
+        mv    pc, lr
+
+        .org  0x400
+TICKS:  .word 0
+PATTERN:
+        .fill 8, 0x00FF
+        .fill 8, 0xFF00
+FRAME:  .space 256
@@ -0,0 +1,34 @@
+// DEPTH = 256
+// Shows the value of the switches in hexadecimal on HEX3..HEX0.
+.define SW_ADDRESS 0x3000
+.define HEX_ADDRESS 0x2000
+
+        mv    sp, #0xFF
+MAIN:   mv    r2, =SW_ADDRESS
+        ld    r0, [r2]            // read the switches
+        mv    r3, =HEX_ADDRESS
+        mv    r1, #4              // four digits
+DIGIT:  push  r0
+        and   r0, #0xF
+        bl    SEG7
+        st    r0, [r3]            // one display per address
+        add   r3, #1
+        pop   r0
+        lsr   r0, #4
+        sub   r1, #1
+        bne   DIGIT
+        b     MAIN
+
+// r0 = segment pattern for the hex digit in r0[3:0]
+SEG7:   push  r1
+        mv    r1, =SEG_TABLE
+        add   r1, r0
+        ld    r0, [r1]
+        pop   r1
+        mv    pc, lr
+
+SEG_TABLE:
+        .word 0b00111111, 0b00000110, 0b01011011, 0b01001111   // 0 1 2 3
+        .word 0b01100110, 0b01101101, 0b01111101, 0b00000111   // 4 5 6 7
+        .word 0b01111111, 0b01100111, 0b01110111, 0b01111100   // 8 9 A b
+        .word 0b00111001, 0b01011110, 0b01111001, 0b01110001   // C d E F
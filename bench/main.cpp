@@ -0,0 +1,368 @@
+// ----------------------------------------------------------------------------
+// Author: LeonW
+// Date: October 18, 2026
+// Description: End-to-end benchmark of the sbasmCpp executable. Every input
+//              is assembled by a fresh process, so the numbers include
+//              startup, reading the source, the DEPTH scan, the pipeline and
+//              writing the MIF. Input sets are the hand-written programs in
+//              bench/corpus (run as a batch, giving files/s) and generated
+//              programs of increasing size (giving MB/s). Results are
+//              written as JSON and compared against a stored baseline; any
+//              metric worse than the baseline by more than the threshold
+//              fails the run.
+// ----------------------------------------------------------------------------
+
+#include "ChildProcess.h"
+#include "ProgramGenerator.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct BenchResult {
+    std::string name;
+    int files = 0;              // files assembled per pass
+    long bytes = 0;             // source bytes per pass
+    double seconds = 0;         // median wall time of one pass
+    double filesPerSecond = 0;
+    double mbPerSecond = 0;
+    long peakRssKb = 0;         // largest of all runs
+    long minorFaults = 0;       // median per file
+    long majorFaults = 0;       // median per file
+};
+
+struct BenchOptions {
+    std::string assembler;
+    std::string corpus;
+    std::string workDirectory = ".";
+    std::string outputFile = "bench_results.json";
+    std::string baselineFile;
+    std::vector<int> sizes = {1000, 10000, 60000};
+    int runs = 7;
+    double threshold = 0.25;
+    bool updateBaseline = false;
+};
+
+static long fileSize(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        throw std::runtime_error("Could not open '" + path + "'");
+    }
+    return static_cast<long>(in.tellg());
+}
+
+template <typename T>
+static T median(std::vector<T> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+// Assembles every file once per run and summarizes the passes.
+static BenchResult measure(const std::string& name, const std::vector<std::string>& files,
+                           const BenchOptions& options) {
+    BenchResult result;
+    result.name = name;
+    result.files = static_cast<int>(files.size());
+    for (const std::string& file : files) {
+        result.bytes += fileSize(file);
+    }
+
+    const std::string output = options.workDirectory + "/bench_output.mif";
+    std::vector<double> passSeconds;
+    std::vector<long> minorFaults;
+    std::vector<long> majorFaults;
+    // One untimed pass warms the page cache so the first run is not an outlier.
+    for (int run = -1; run < options.runs; run++) {
+        double seconds = 0;
+        for (const std::string& file : files) {
+            // Without an old output every run writes the whole MIF.
+            std::remove(output.c_str());
+            ProcessStats stats = runProcess(options.assembler, {file, "-o", output});
+            if (stats.exitCode != 0) {
+                throw std::runtime_error("'" + options.assembler + " " + file + "' exited with " +
+                                         std::to_string(stats.exitCode));
+            }
+            if (run < 0) continue;
+            seconds += stats.seconds;
+            result.peakRssKb = std::max(result.peakRssKb, stats.peakRssKb);
+            minorFaults.push_back(stats.minorFaults);
+            majorFaults.push_back(stats.majorFaults);
+        }
+        if (run >= 0) passSeconds.push_back(seconds);
+    }
+    std::remove(output.c_str());
+
+    result.seconds = median(passSeconds);
+    result.filesPerSecond = result.files / result.seconds;
+    result.mbPerSecond = result.bytes / 1e6 / result.seconds;
+    result.minorFaults = median(minorFaults);
+    result.majorFaults = median(majorFaults);
+    return result;
+}
+
+static std::string toJson(const std::vector<BenchResult>& results, int runs) {
+    std::ostringstream out;
+    out << "{\n  \"runs\": " << runs << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"files\": " << r.files
+            << ", \"bytes\": " << r.bytes << std::fixed
+            << ", \"seconds\": " << std::setprecision(6) << r.seconds
+            << ", \"files_per_s\": " << std::setprecision(2) << r.filesPerSecond
+            << ", \"mb_per_s\": " << std::setprecision(3) << r.mbPerSecond
+            << ", \"peak_rss_kb\": " << r.peakRssKb
+            << ", \"minor_faults\": " << r.minorFaults
+            << ", \"major_faults\": " << r.majorFaults << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+        out.unsetf(std::ios::floatfield);
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+// Reads the "results" objects written by toJson(). Only flat objects with
+// string and number members are understood, which is all toJson() writes.
+static std::vector<BenchResult> parseResults(const std::string& text) {
+    std::vector<BenchResult> results;
+    size_t pos = text.find("\"results\"");
+    if (pos == std::string::npos) {
+        throw std::runtime_error("No \"results\" array");
+    }
+    while ((pos = text.find_first_of("{]", pos)) != std::string::npos && text[pos] == '{') {
+        const size_t end = text.find('}', pos);
+        if (end == std::string::npos) {
+            throw std::runtime_error("Unterminated result object");
+        }
+        BenchResult r;
+        size_t key = pos;
+        while ((key = text.find('"', key + 1)) < end) {
+            const size_t keyEnd = text.find('"', key + 1);
+            const std::string name = text.substr(key + 1, keyEnd - key - 1);
+            size_t value = text.find_first_not_of(" \t\r\n:", keyEnd + 1);
+            if (text[value] == '"') {
+                const size_t valueEnd = text.find('"', value + 1);
+                if (name == "name") r.name = text.substr(value + 1, valueEnd - value - 1);
+                key = valueEnd;
+                continue;
+            }
+            const double number = std::strtod(text.c_str() + value, nullptr);
+            if (name == "files") r.files = static_cast<int>(number);
+            else if (name == "bytes") r.bytes = static_cast<long>(number);
+            else if (name == "seconds") r.seconds = number;
+            else if (name == "files_per_s") r.filesPerSecond = number;
+            else if (name == "mb_per_s") r.mbPerSecond = number;
+            else if (name == "peak_rss_kb") r.peakRssKb = static_cast<long>(number);
+            else if (name == "minor_faults") r.minorFaults = static_cast<long>(number);
+            else if (name == "major_faults") r.majorFaults = static_cast<long>(number);
+            key = text.find_first_of(",}", value) - 1;
+        }
+        results.push_back(r);
+        pos = end + 1;
+    }
+    return results;
+}
+
+static void printResults(const std::vector<BenchResult>& results) {
+    std::cout << std::left << std::setw(18) << "input" << std::right
+              << std::setw(7) << "files" << std::setw(11) << "bytes"
+              << std::setw(11) << "files/s" << std::setw(9) << "MB/s"
+              << std::setw(13) << "peak RSS kB" << std::setw(14) << "minor faults"
+              << std::setw(14) << "major faults" << "\n";
+    for (const BenchResult& r : results) {
+        std::cout << std::left << std::setw(18) << r.name << std::right
+                  << std::setw(7) << r.files << std::setw(11) << r.bytes << std::fixed
+                  << std::setw(11) << std::setprecision(1) << r.filesPerSecond
+                  << std::setw(9) << std::setprecision(2) << r.mbPerSecond
+                  << std::setw(13) << r.peakRssKb << std::setw(14) << r.minorFaults
+                  << std::setw(14) << r.majorFaults << "\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+// Prints every metric that is worse than its baseline by more than the
+// threshold and returns how many there were. Inputs missing from either
+// side are reported but do not count.
+static int compareWithBaseline(const std::vector<BenchResult>& results,
+                               const std::vector<BenchResult>& baseline, double threshold) {
+    int regressions = 0;
+    auto check = [&](const std::string& name, const char* metric, double value, double reference,
+                     bool higherIsBetter) {
+        if (reference <= 0) return;
+        const double change = (value - reference) / reference;
+        const bool worse = higherIsBetter ? change < -threshold : change > threshold;
+        if (worse) {
+            std::cout << std::setprecision(6) << "REGRESSION " << name << " " << metric << ": " << value << " vs. baseline "
+                      << reference << " (" << std::fixed << std::showpos << std::setprecision(1)
+                      << change * 100 << std::noshowpos << "%, threshold " << threshold * 100 << "%)\n";
+            std::cout.unsetf(std::ios::floatfield);
+            regressions++;
+        }
+    };
+
+    for (const BenchResult& r : results) {
+        auto base = std::find_if(baseline.begin(), baseline.end(),
+                                 [&](const BenchResult& b) { return b.name == r.name; });
+        if (base == baseline.end()) {
+            std::cout << "note: " << r.name << " has no baseline\n";
+            continue;
+        }
+        if (base->bytes != r.bytes) {
+            std::cout << "note: " << r.name << " input changed since the baseline ("
+                      << base->bytes << " -> " << r.bytes << " bytes)\n";
+        }
+        check(r.name, "files/s", r.filesPerSecond, base->filesPerSecond, true);
+        check(r.name, "MB/s", r.mbPerSecond, base->mbPerSecond, true);
+        check(r.name, "peak RSS kB", r.peakRssKb, base->peakRssKb, false);
+        check(r.name, "minor faults", r.minorFaults, base->minorFaults, false);
+    }
+    for (const BenchResult& b : baseline) {
+        if (std::none_of(results.begin(), results.end(),
+                         [&](const BenchResult& r) { return r.name == b.name; })) {
+            std::cout << "note: baseline input " << b.name << " was not run\n";
+        }
+    }
+    return regressions;
+}
+
+static void writeText(const std::string& path, const std::string& text) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << text;
+    if (!out) {
+        throw std::runtime_error("Could not write '" + path + "'");
+    }
+}
+
+static void printHelp(const char* program) {
+    std::cout << "Usage: " << program << " --assembler <sbasmCpp> [options]\n"
+              << " --assembler <file>       sbasmCpp executable to measure\n"
+              << " --corpus <dir>           Directory of .s files assembled as one batch\n"
+              << " --sizes <n,n,...>        Words of the generated inputs (default 1000,10000,60000)\n"
+              << " --runs <n>               Timed runs per input, the median is reported (default 7)\n"
+              << " --work-dir <dir>         Where generated inputs and outputs go (default .)\n"
+              << " --output <file>          Results JSON (default bench_results.json)\n"
+              << " --baseline <file>        Fail when a metric is worse than this baseline\n"
+              << " --threshold <fraction>   Allowed slowdown/growth against the baseline (default 0.25)\n"
+              << " --update-baseline        Write the results to the --baseline file instead\n";
+}
+
+static BenchOptions parseArguments(int argc, const char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            printHelp(argv[0]);
+            std::exit(0);
+        }
+        if (arg == "--update-baseline") {
+            options.updateBaseline = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            throw std::runtime_error(arg + " requires a value");
+        }
+        const std::string value = argv[++i];
+        if (arg == "--assembler") {
+            options.assembler = value;
+        } else if (arg == "--corpus") {
+            options.corpus = value;
+        } else if (arg == "--work-dir") {
+            options.workDirectory = value;
+        } else if (arg == "--output") {
+            options.outputFile = value;
+        } else if (arg == "--baseline") {
+            options.baselineFile = value;
+        } else if (arg == "--runs") {
+            options.runs = std::stoi(value);
+        } else if (arg == "--threshold") {
+            options.threshold = std::stod(value);
+        } else if (arg == "--sizes") {
+            options.sizes.clear();
+            std::stringstream list(value);
+            std::string size;
+            while (std::getline(list, size, ',')) {
+                options.sizes.push_back(std::stoi(size));
+            }
+        } else {
+            throw std::runtime_error("Unknown option " + arg);
+        }
+    }
+    if (options.assembler.empty()) {
+        throw std::runtime_error("--assembler is required");
+    }
+    if (options.runs < 1) {
+        throw std::runtime_error("--runs must be at least 1");
+    }
+    if (options.updateBaseline && options.baselineFile.empty()) {
+        throw std::runtime_error("--update-baseline requires --baseline");
+    }
+    return options;
+}
+
+int main(int argc, const char* argv[]) {
+    BenchOptions options;
+    std::vector<BenchResult> results;
+    try {
+        options = parseArguments(argc, argv);
+        makeDirectory(options.workDirectory);
+
+        if (!options.corpus.empty()) {
+            std::vector<std::string> files;
+            for (const std::string& name : listFiles(options.corpus, ".s")) {
+                files.push_back(options.corpus + "/" + name);
+            }
+            if (files.empty()) {
+                throw std::runtime_error("No .s files in '" + options.corpus + "'");
+            }
+            results.push_back(measure("corpus", files, options));
+        }
+        for (int words : options.sizes) {
+            const std::string name = "generated_" + std::to_string(words);
+            const std::string path = options.workDirectory + "/" + name + ".s";
+            writeText(path, generateProgram(words, 0x5B45u + words));
+            results.push_back(measure(name, {path}, options));
+        }
+
+        printResults(results);
+        const std::string json = toJson(results, options.runs);
+        writeText(options.outputFile, json);
+        std::cout << "Results written to " << options.outputFile << "\n";
+        if (options.updateBaseline) {
+            writeText(options.baselineFile, json);
+            std::cout << "Baseline " << options.baselineFile << " updated\n";
+            return 0;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+
+    if (options.baselineFile.empty()) {
+        return 0;
+    }
+    std::vector<BenchResult> baseline;
+    try {
+        std::ifstream in(options.baselineFile, std::ios::binary);
+        if (!in.is_open()) {
+            throw std::runtime_error("Could not open baseline '" + options.baselineFile + "'");
+        }
+        std::stringstream text;
+        text << in.rdbuf();
+        baseline = parseResults(text.str());
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+    const int regressions = compareWithBaseline(results, baseline, options.threshold);
+    if (regressions > 0) {
+        std::cout << regressions << " metric(s) regressed against " << options.baselineFile << "\n";
+        return 1;
+    }
+    std::cout << "No regressions against " << options.baselineFile << "\n";
+    return 0;
+}
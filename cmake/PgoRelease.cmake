@@ -0,0 +1,117 @@
+# ----------------------------------------------------------------------------
+# Author: LeonW
+# Date: October 18, 2026
+# Description: Builds a profile-guided, link-time optimized sbasmCpp. Run
+#              through the release-pgo target, or directly:
+#
+#   cmake -DSOURCE_DIR=<repo> -DBUILD_DIR=<dir> [-DGENERATOR=<name>]
+#         [-DC_COMPILER=<cc>] [-DCXX_COMPILER=<c++>] -P cmake/PgoRelease.cmake
+#
+#              1. Release + SBASM_LTO build with SBASM_PGO=GENERATE.
+#              2. Training: sbasmCpp_bench over pgo/corpus and generated
+#                 programs, then every corpus file with the common flags.
+#              3. The same build directory reconfigured with SBASM_PGO=USE
+#                 (GCC finds its profiles by object path, so it must not
+#                 move) and rebuilt. The result is <BUILD_DIR>/bin/sbasmCpp.
+# ----------------------------------------------------------------------------
+
+cmake_minimum_required(VERSION 3.18)
+
+foreach(REQUIRED SOURCE_DIR BUILD_DIR)
+    if(NOT ${REQUIRED})
+        message(FATAL_ERROR "PgoRelease.cmake: -D${REQUIRED}=... is required")
+    endif()
+endforeach()
+
+set(PROFILE_DIR ${BUILD_DIR}/profile)
+set(TRAIN_DIR ${BUILD_DIR}/train)
+set(BIN_DIR ${BUILD_DIR}/bin)
+if(CMAKE_HOST_WIN32)
+    set(EXE ".exe")
+endif()
+set(ASSEMBLER ${BIN_DIR}/sbasmCpp${EXE})
+
+function(run_checked)
+    execute_process(COMMAND ${ARGN} RESULT_VARIABLE RESULT OUTPUT_QUIET)
+    if(NOT RESULT EQUAL 0)
+        string(REPLACE ";" " " COMMAND_LINE "${ARGN}")
+        message(FATAL_ERROR "Failed (${RESULT}): ${COMMAND_LINE}")
+    endif()
+endfunction()
+
+function(configure_stage STAGE)
+    set(ARGS -S ${SOURCE_DIR} -B ${BUILD_DIR}
+        -DCMAKE_BUILD_TYPE=Release
+        -DSBASM_LTO=ON
+        -DSBASM_PGO=${STAGE}
+        -DSBASM_PGO_DIR=${PROFILE_DIR}
+        -DSBASM_OUTPUT_DIR=${BIN_DIR}
+        -DSBASM_BUILD_SHARED=OFF
+        -DSBASM_BUILD_TESTS=OFF
+        -DSBASM_BUILD_BENCH=ON)
+    if(GENERATOR)
+        list(APPEND ARGS -G ${GENERATOR})
+    endif()
+    if(C_COMPILER)
+        list(APPEND ARGS -DCMAKE_C_COMPILER=${C_COMPILER})
+    endif()
+    if(CXX_COMPILER)
+        list(APPEND ARGS -DCMAKE_CXX_COMPILER=${CXX_COMPILER})
+    endif()
+    message(STATUS "release-pgo: configuring SBASM_PGO=${STAGE}")
+    run_checked(${CMAKE_COMMAND} ${ARGS})
+endfunction()
+
+# 1. Instrumented build.
+file(REMOVE_RECURSE ${PROFILE_DIR} ${TRAIN_DIR})
+file(MAKE_DIRECTORY ${PROFILE_DIR} ${TRAIN_DIR})
+configure_stage(GENERATE)
+message(STATUS "release-pgo: building the instrumented assembler")
+run_checked(${CMAKE_COMMAND} --build ${BUILD_DIR} --target sbasmCpp sbasmCpp_bench --parallel)
+
+# 2. Training run.
+message(STATUS "release-pgo: training on pgo/corpus, bench/corpus and generated programs")
+run_checked(${BIN_DIR}/sbasmCpp_bench${EXE}
+    --assembler ${ASSEMBLER}
+    --corpus ${SOURCE_DIR}/pgo/corpus
+    --sizes 1000,20000,60000
+    --runs 1
+    --work-dir ${TRAIN_DIR}
+    --output ${TRAIN_DIR}/results.json)
+
+file(GLOB TRAINING_FILES
+    ${SOURCE_DIR}/pgo/corpus/*.s
+    ${SOURCE_DIR}/bench/corpus/*.s
+    ${TRAIN_DIR}/generated_*.s)
+# One entry per run, arguments separated by '|'.
+set(FLAG_SETS
+    "-o|${TRAIN_DIR}/out.mif"
+    "-o|${TRAIN_DIR}/out.mif|-O"
+    "-o|${TRAIN_DIR}/out.mif|--strip-unused"
+    "-o|${TRAIN_DIR}/out.mif|-g|--mif-comments|code"
+    "-o|${TRAIN_DIR}/out.mif|--no-rle"
+    "-o|${TRAIN_DIR}/out.mif|-j|4"
+    "-o|${TRAIN_DIR}/out.mif|-D|BOARD=2|-D|TRACE")
+foreach(FILE ${TRAINING_FILES})
+    foreach(FLAG_SET ${FLAG_SETS})
+        string(REPLACE "|" ";" FLAGS "${FLAG_SET}")
+        run_checked(${ASSEMBLER} ${FILE} ${FLAGS})
+    endforeach()
+endforeach()
+
+# Clang writes raw profiles that have to be merged; GCC's .gcda files are
+# read as they are.
+file(GLOB RAW_PROFILES ${PROFILE_DIR}/*.profraw)
+if(RAW_PROFILES)
+    find_program(LLVM_PROFDATA NAMES llvm-profdata)
+    if(NOT LLVM_PROFDATA)
+        message(FATAL_ERROR "release-pgo: llvm-profdata is needed to merge Clang profiles")
+    endif()
+    run_checked(${LLVM_PROFDATA} merge -output=${PROFILE_DIR}/sbasm.profdata ${RAW_PROFILES})
+endif()
+
+# 3. Optimized rebuild.
+configure_stage(USE)
+message(STATUS "release-pgo: building the profile-optimized assembler")
+run_checked(${CMAKE_COMMAND} --build ${BUILD_DIR} --target sbasmCpp --parallel)
+message(STATUS "release-pgo: ${ASSEMBLER}")
@@ -0,0 +1,45 @@
+// DEPTH = 512
+// Debounced key reader shared by two boards; pass -D BOARD=2 for the
+// second one.
+.ifndef BOARD
+.define BOARD 1
+.endif
+
+.if BOARD == 1
+.define KEY_ADDRESS 0x3000
+.define LED_ADDRESS 0x1000
+.else
+.define KEY_ADDRESS 0x3800
+.define LED_ADDRESS 0x1800
+.endif
+.define SAMPLES 8
+
+        mv    sp, #0xFF
+MAIN:   mv    r5, =KEY_ADDRESS
+        mv    r4, =LED_ADDRESS
+POLL:   bl    DEBOUNCE
+        st    r0, [r4]
+.ifdef TRACE
+        push  r0
+        pop   r0
+.endif
+        b     POLL
+
+// Returns in r0 the key value that was stable for SAMPLES reads.
+DEBOUNCE:
+        push  r1
+        push  r2
+AGAIN:  ld    r0, [r5]
+        mv    r1, #SAMPLES
+SAME:   ld    r2, [r5]
+        cmp   r2, r0
+        bne   AGAIN
+        sub   r1, #1
+        bne   SAME
+.if BOARD >= 2
+        mv    r1, #0x0F           // keys are active low on this board
+        xor   r0, r1
+.endif
+        pop   r2
+        pop   r1
+        mv    pc, lr
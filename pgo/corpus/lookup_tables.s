@@ -0,0 +1,28 @@
+// DEPTH = 4096
+// Table-driven square and parity lookups with reserved work areas.
+.define RESULTS 0x800
+
+        mv    sp, #0xFF
+MAIN:   mv    r0, #0
+        mv    r4, =RESULTS
+NEXT:   mv    r1, =SQUARES
+        add   r1, r0
+        ld    r2, [r1]
+        st    r2, [r4]
+        mv    r1, =PARITY
+        add   r1, r0
+        ld    r2, [r1]
+        add   r4, #1
+        st    r2, [r4]
+        add   r4, #1
+        add   r0, #1
+        cmp   r0, #16
+        bne   NEXT
+END:    b     END
+
+SQUARES: .word 0, 1, 4, 9, 16, 25, 36, 49, 64, 81, 100, 121, 144, 169, 196, 225
+PARITY:  .word 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0
+SCRATCH: .space 64
+GUARD:   .fill 16, 0xDEAD
+        .org  0x800
+        .space 32
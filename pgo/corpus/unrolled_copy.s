@@ -0,0 +1,34 @@
+// DEPTH = 1024
+// Copies a 64-word table with an unrolled loop built from a macro.
+.define SOURCE 0x200
+.define TARGET 0x280
+
+.macro COPY4 from, to
+        ld    r2, [from]
+        st    r2, [to]
+        add   from, #1
+        add   to, #1
+        ld    r2, [from]
+        st    r2, [to]
+        add   from, #1
+        add   to, #1
+.endm
+
+        mv    sp, #0xFF
+MAIN:   mv    r0, =SOURCE
+        mv    r1, =TARGET
+        mv    r3, #8
+BLOCK:  COPY4 r0, r1
+        COPY4 r0, r1
+        COPY4 r0, r1
+        COPY4 r0, r1
+        sub   r3, #1
+        bne   BLOCK
+END:    b     END
+
+        .org  0x200
+TABLE:
+        .rept 4
+        .word 0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080
+        .word 0x0100, 0x0200, 0x0400, 0x0800, 0x1000, 0x2000, 0x4000, 0x8000
+        .endr
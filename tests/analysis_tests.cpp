@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "Analysis/ControlFlow.h"
+#include "Analysis/Wcet.h"
+
+static AssembleResult build(const std::string& source) {
+  AssembleOptions options;
+  options.debugInfo = true;
+  AssembleResult result = assemble(source, options);
+  EXPECT_TRUE(result.success) << (result.diagnostics.empty() ? "" : result.diagnostics[0].message);
+  return result;
+}
+
+const char* const NESTED =
+  "       mv   r0, #3\n"              // 0
+  "OUTER: mv   r1, #4\n"              // 1
+  "INNER: sub  r1, #1\n"              // 2
+  "       bne  INNER\n"               // 3
+  "       bl   LEAF\n"                // 4
+  "       sub  r0, #1\n"              // 5
+  "       bne  OUTER\n"               // 6
+  "END:   b    END\n"                 // 7
+  "LEAF:  add  r2, #1\n"              // 8
+  "       mv   pc, lr\n"              // 9
+  "       .word 0x1234\n";            // 10, never decoded
+
+TEST(AnalysisTest, BuildsBlocksRoutinesAndNestedLoops) {
+  AssembleResult result = build(NESTED);
+  ControlFlowGraph cfg;
+  cfg.build(result.words, result.isData);
+
+  // [0] [1] [2,3] [4] [5,6] [7] [8,9]
+  ASSERT_EQ(cfg.getBlocks().size(), 7);
+  EXPECT_EQ(cfg.blockAt(3), cfg.blockAt(2));
+  EXPECT_EQ(cfg.blockAt(10), -1);
+  EXPECT_EQ(cfg.getBlocks()[cfg.blockAt(4)].callee, 8);
+  EXPECT_TRUE(cfg.getBlocks()[cfg.blockAt(9)].returns);
+  EXPECT_TRUE(cfg.getBlocks()[cfg.blockAt(7)].stops);
+
+  ASSERT_EQ(cfg.getRoutines().size(), 2);
+  const Routine& main = cfg.getRoutines()[0];
+  EXPECT_EQ(main.entry, 0);
+  ASSERT_EQ(main.loops.size(), 2);
+  EXPECT_EQ(cfg.getBlocks()[main.loops[0].header].start, 2);
+  EXPECT_EQ(main.loops[0].parent, 1);
+  EXPECT_EQ(cfg.getBlocks()[main.loops[1].header].start, 1);
+  EXPECT_EQ(main.loops[1].body.size(), 4);
+}
+
+TEST(AnalysisTest, ComputesWorstCaseCycles) {
+  AssembleResult result = build(NESTED);
+  WcetAnalysis analysis(result);
+  analysis.addLoopBound("OUTER", 3);
+  analysis.addLoopBound("INNER", 4);
+  const std::vector<RoutineReport>& reports = analysis.run();
+
+  ASSERT_EQ(reports.size(), 2);
+  const CycleTable t;
+  const uint64_t leaf = t.alu + t.move;
+  EXPECT_EQ(reports[1].name, "LEAF");
+  EXPECT_EQ(reports[1].cycles, leaf);
+
+  const uint64_t inner = 4 * (t.alu + t.branch);
+  const uint64_t outer = 3 * (t.move + inner + t.branch + leaf + t.alu + t.branch);
+  ASSERT_TRUE(reports[0].bounded) << reports[0].problem;
+  EXPECT_EQ(reports[0].cycles, t.move + outer + t.branch);
+  EXPECT_EQ(reports[0].words, 8);
+  EXPECT_EQ(reports[0].loops.size(), 2);
+}
+
+TEST(AnalysisTest, ReadsBoundsFromComments) {
+  const std::string source =
+    "     mv  r0, #10\n"
+    "L:   sub r0, #1      // @bound 10\n"
+    "     bne L\n"
+    "E:   b   E\n";
+  AssembleResult result = build(source);
+  WcetAnalysis analysis(result);
+  analysis.addSourceBounds(source);
+  const CycleTable t;
+  EXPECT_EQ(analysis.run()[0].cycles, t.move + 10 * (t.alu + t.branch) + t.branch);
+}
+
+TEST(AnalysisTest, ReportsUnboundedRoutines) {
+  AssembleResult result = build(
+    "L:   bl  F\n"
+    "     b   L\n"
+    "F:   bl  F\n"
+    "     mv  pc, lr\n");
+  WcetAnalysis analysis(result);
+  const std::vector<RoutineReport>& reports = analysis.run();
+  ASSERT_EQ(reports.size(), 2);
+  EXPECT_FALSE(reports[0].bounded);
+  EXPECT_FALSE(reports[1].bounded);
+  EXPECT_NE(reports[1].problem.find("recursive"), std::string::npos);
+
+  EXPECT_THROW(analysis.addLoopBound("MISSING", 1), std::runtime_error);
+}
+
+TEST(AnalysisTest, RejectsIndirectJumpsAndRunningIntoData) {
+  ControlFlowGraph cfg;
+  AssembleResult indirect = build("mv pc, r1\n");
+  EXPECT_THROW(cfg.build(indirect.words, indirect.isData), std::runtime_error);
+
+  AssembleResult data = build("mv r0, #1\n.word 5\n");
+  EXPECT_THROW(cfg.build(data.words, data.isData), std::runtime_error);
+}
@@ -0,0 +1,379 @@
+#include <gtest/gtest.h>
+#include "Assembler/Assembler.h"
+#include "Assembler/IncrementalAssembler.h"
+#include "Assembler/sbasm.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+const char* const PROGRAM =
+    "// DEPTH = 512\n"
+    ".define LED 0x1000\n"
+    "MAIN:  mv   r0, =LED\n"
+    "LOOP:  add  r1, #1\n"
+    "       st   r1, [r0]\n"
+    "       b    LOOP\n"
+    "DATA:  .word 0xBEEF\n";
+
+TEST(AssemblerTest, AssemblesInMemory) {
+  AssembleResult result = assemble(PROGRAM);
+
+  ASSERT_TRUE(result.success);
+  EXPECT_EQ(result.depth, 512);
+  ASSERT_EQ(result.words.size(), 6);
+  EXPECT_EQ(result.words[0], 0x3010);
+  EXPECT_EQ(result.words[4], 0x21FD);
+  EXPECT_EQ(result.words[5], 0xBEEF);
+  EXPECT_EQ(result.isData, std::vector<bool>({false, false, false, false, false, true}));
+
+  ASSERT_EQ(result.symbols.size(), 4);
+  EXPECT_EQ(result.symbols[0].name, "MAIN");
+  EXPECT_EQ(result.symbols[1].name, "LOOP");
+  EXPECT_EQ(result.symbols[1].value, 2);
+  EXPECT_EQ(result.symbols[3].name, "LED");
+  EXPECT_FALSE(result.symbols[3].isLabel);
+}
+
+TEST(AssemblerTest, PlacesSegmentsWithOrgSpaceAndFill) {
+  AssembleResult result = assemble(
+      "       b    MAIN\n"
+      "       .org 0x10\n"
+      "MAIN:  ld   r0, [r1]\n"
+      "       b    VECTOR\n"
+      "BUF:   .space 4\n"
+      "TABLE: .fill 3, -1\n"
+      "       .org 0x8\n"
+      "VECTOR: b   MAIN\n");
+
+  ASSERT_TRUE(result.success) << result.diagnostics[0].message;
+  EXPECT_EQ(result.words, std::vector<uint16_t>({0x200F, 0x8001, 0x21F6, 0xFFFF, 0xFFFF, 0xFFFF, 0x2007}));
+  ASSERT_EQ(result.segments.size(), 4);
+  EXPECT_EQ(result.segments[0].base, 0);
+  EXPECT_EQ(result.segments[1].base, 0x8);
+  EXPECT_EQ(result.segments[1].offset, 6);
+  EXPECT_EQ(result.segments[2].base, 0x10);
+  EXPECT_EQ(result.segments[2].length, 2);
+  EXPECT_FALSE(result.segments[2].isData);
+  EXPECT_EQ(result.segments[3].base, 0x16);
+  EXPECT_EQ(result.segments[3].length, 3);
+  EXPECT_TRUE(result.segments[3].isData);
+  EXPECT_EQ(wordIndex(result.segments, 0x17), 4);
+  EXPECT_EQ(wordIndex(result.segments, 0x13), -1);
+
+  auto table = std::find_if(result.symbols.begin(), result.symbols.end(),
+                            [](const SymbolInfo& symbol) { return symbol.name == "TABLE"; });
+  ASSERT_NE(table, result.symbols.end());
+  EXPECT_EQ(table->value, 0x16);
+}
+
+TEST(AssemblerTest, RejectsOverlappingAndOutOfRangeSegments) {
+  AssembleResult overlap = assemble("mv r0, #1\nmv r0, #2\n.org 1\n.word 3\n");
+  ASSERT_FALSE(overlap.success);
+  EXPECT_EQ(overlap.diagnostics[0].line, 4);
+  EXPECT_NE(overlap.diagnostics[0].message.find("overlaps"), std::string::npos);
+
+  AssembleResult outside = assemble(".org 0xFFFF\n.space 2\n");
+  ASSERT_FALSE(outside.success);
+  EXPECT_EQ(outside.diagnostics[0].line, 2);
+
+  EXPECT_TRUE(assemble("// DEPTH = 65536\n.org 0xFFFF\n.word 1\n").success);
+}
+
+TEST(AssemblerTest, RejectsWordsPastDepth) {
+  AssembleResult result = assemble("mv pc, =MAIN\n.org 0x300\nMAIN: b MAIN\n");
+  ASSERT_FALSE(result.success);
+  EXPECT_EQ(result.diagnostics[0].line, 2);
+  EXPECT_NE(result.diagnostics[0].message.find("0x300"), std::string::npos);
+  EXPECT_NE(result.diagnostics[0].message.find("DEPTH = 256"), std::string::npos);
+
+  EXPECT_TRUE(assemble("// DEPTH = 1024\nmv pc, =MAIN\n.org 0x300\nMAIN: b MAIN\n").success);
+  EXPECT_FALSE(assemble("// DEPTH = 2\nmv r0, #1\nmv r0, #2\nmv r0, #3\n").success);
+}
+
+TEST(AssemblerTest, IncludesBinaryFiles) {
+  const std::string directory = ::testing::TempDir();
+  {
+    std::ofstream out(directory + "incbin_test.bin", std::ios::binary);
+    const char bytes[] = {0x34, 0x12, 0x78, 0x56, 0x01, 0x00, 0x7f};
+    out.write(bytes, sizeof(bytes));
+  }
+
+  AssembleOptions options;
+  options.includeDirectory = directory;
+  AssembleResult result = assemble(
+      "mv r0, =TABLE\n"
+      "TABLE: .incbin \"incbin_test.bin\", 0, 6\n"
+      "       .incbin \"incbin_test.bin\", 2, 2\n"
+      "       .word 7, 8\n", options);
+  ASSERT_TRUE(result.success) << result.diagnostics[0].message;
+  EXPECT_EQ(result.words, std::vector<uint16_t>({0x3000, 0x5002, 0x1234, 0x5678, 0x0001, 0x5678, 7, 8}));
+  EXPECT_EQ(result.isData, std::vector<bool>({false, false, true, true, true, true, true, true}));
+
+  options.incbinBigEndian = true;
+  result = assemble(".incbin \"incbin_test.bin\", 0, 4\n", options);
+  ASSERT_TRUE(result.success);
+  EXPECT_EQ(result.words, std::vector<uint16_t>({0x3412, 0x7856}));
+
+  // Seven bytes do not make whole words; ranges must stay inside the file.
+  result = assemble("mv r0, #1\n.incbin \"incbin_test.bin\"\n", options);
+  ASSERT_FALSE(result.success);
+  EXPECT_EQ(result.diagnostics[0].line, 2);
+  EXPECT_NE(result.diagnostics[0].message.find("odd"), std::string::npos);
+  EXPECT_FALSE(assemble(".incbin \"incbin_test.bin\", 4, 8\n", options).success);
+  EXPECT_FALSE(assemble(".incbin \"missing.bin\"\n", options).success);
+
+  // --watch also watches the included files.
+  IncrementalAssembler incremental;
+  ASSERT_TRUE(incremental.update(".incbin \"incbin_test.bin\", 0, 2\n", options).success);
+  EXPECT_EQ(incremental.getIncludedFiles(), std::vector<std::string>({directory + "/incbin_test.bin"}));
+  ASSERT_TRUE(incremental.update("mv r0, #1\n", options).success);
+  EXPECT_TRUE(incremental.getIncludedFiles().empty());
+  std::remove((directory + "incbin_test.bin").c_str());
+}
+
+TEST(AssemblerTest, ExpandsMacrosAndRept) {
+  AssembleResult expanded = assemble(
+      ".macro DELAY reg, count\n"
+      "       mv   reg, count\n"
+      "WAIT:  sub  reg, #1\n"
+      "       bne  WAIT\n"
+      ".endm\n"
+      ".macro TWICE reg\n"
+      "       DELAY reg, #2\n"
+      "       DELAY reg, =LIMIT\n"
+      ".endm\n"
+      "MAIN:  TWICE r3\n"
+      "       .rept 2\n"
+      "       .rept 2\n"
+      "       add  r0, #1\n"
+      "       .endr\n"
+      "       .word 7\n"
+      "       .endr\n"
+      "LIMIT: .word 9\n");
+  AssembleResult manual = assemble(
+      "MAIN:  mv   r3, #2\n"
+      "W1:    sub  r3, #1\n"
+      "       bne  W1\n"
+      "       mv   r3, =LIMIT\n"
+      "W2:    sub  r3, #1\n"
+      "       bne  W2\n"
+      "       add  r0, #1\n"
+      "       add  r0, #1\n"
+      "       .word 7\n"
+      "       add  r0, #1\n"
+      "       add  r0, #1\n"
+      "       .word 7\n"
+      "LIMIT: .word 9\n");
+  ASSERT_TRUE(expanded.success) << expanded.diagnostics[0].message;
+  ASSERT_TRUE(manual.success);
+  EXPECT_EQ(expanded.words, manual.words);
+  EXPECT_EQ(expanded.isData, manual.isData);
+
+  // Expanded statements report the line of the outermost invocation.
+  AssembleResult inRange = assemble(".macro ADDI reg, n\nadd reg, #n\n.endm\nmv r0, r1\nADDI r0, 999\n");
+  ASSERT_FALSE(inRange.success);
+  EXPECT_EQ(inRange.diagnostics[0].line, 5);
+
+  EXPECT_FALSE(assemble(".macro M a\nmv a, #1\n.endm\nM r0, r1\n").success);
+  EXPECT_FALSE(assemble(".macro M\nM\n.endm\nM\n").success);
+  EXPECT_FALSE(assemble(".macro M\nmv r0, #1\n").success);
+  EXPECT_FALSE(assemble(".rept 2\nmv r0, #1\n").success);
+  EXPECT_FALSE(assemble("mv r0, #1\n.endm\n").success);
+  EXPECT_FALSE(assemble(".rept -1\n.endr\n").success);
+}
+
+TEST(AssemblerTest, SelectsVariantsWithDefines) {
+  const char* source =
+      ".ifndef LEDS\n"
+      ".define LEDS 0x1000\n"
+      ".endif\n"
+      "      mv r0, =LEDS\n"
+      ".if LEDS >= 0x2000\n"
+      "      mv r1, #1\n"
+      ".endif\n";
+  AssembleResult standard = assemble(source);
+  ASSERT_TRUE(standard.success) << standard.diagnostics[0].message;
+  EXPECT_EQ(standard.words, std::vector<uint16_t>({0x3010, 0x5000}));
+
+  AssembleOptions options;
+  options.defines.push_back({"LEDS", 0x2000});
+  AssembleResult variant = assemble(source, options);
+  ASSERT_TRUE(variant.success) << variant.diagnostics[0].message;
+  EXPECT_EQ(variant.words, std::vector<uint16_t>({0x3020, 0x5000, 0x1201}));
+}
+
+TEST(AssemblerTest, AssemblesSeveralFilesIntoOneImage) {
+  std::vector<SourceFile> files = {
+      {"main.s", "// DEPTH = 128\nMAIN:  b    ENTRY\n.define LED 0x10\n"},
+      {"lib/io.s", "ENTRY: mv   r0, #LED\n       b    MAIN\n"},
+      {"data.s", "       .org 0x20\nDATA:  .word 5, 6\n"},
+  };
+  std::string joined;
+  for (const SourceFile& file : files) joined += file.text;
+  AssembleResult single = assemble(joined);
+  ASSERT_TRUE(single.success);
+
+  for (unsigned jobs : {1u, 4u}) {
+    AssembleOptions options;
+    options.jobs = jobs;
+    AssemblerContext context;
+    const AssembleResult& result = context.assembleFiles(files, options);
+    ASSERT_TRUE(result.success) << result.diagnostics[0].message;
+    EXPECT_EQ(result.depth, 128);
+    EXPECT_EQ(result.words, single.words);
+    EXPECT_EQ(result.segments.size(), single.segments.size());
+  }
+
+  // Errors name the file; duplicates also name the first definition.
+  files[2].text = "\nMAIN:  .word 1\n";
+  AssemblerContext context;
+  const AssembleResult& duplicate = context.assembleFiles(files);
+  ASSERT_FALSE(duplicate.success);
+  EXPECT_EQ(duplicate.diagnostics[0].file, "data.s");
+  EXPECT_EQ(duplicate.diagnostics[0].line, 2);
+  EXPECT_NE(duplicate.diagnostics[0].message.find("first defined at main.s:2"), std::string::npos)
+      << duplicate.diagnostics[0].message;
+
+  files[2].text = "mv r0, #1\nadd r0, #999\n";
+  const AssembleResult& range = context.assembleFiles(files);
+  ASSERT_FALSE(range.success);
+  EXPECT_EQ(range.diagnostics[0].file, "data.s");
+  EXPECT_EQ(range.diagnostics[0].line, 2);
+
+  files[1].text = "mv r0, # ,\n";
+  const AssembleResult& lexed = context.assembleFiles(files);
+  ASSERT_FALSE(lexed.success);
+  EXPECT_EQ(lexed.diagnostics[0].file, "lib/io.s");
+}
+
+TEST(AssemblerTest, ReportsDiagnosticsWithPosition) {
+  AssembleResult result = assemble("mv r0, #1\nadd r0, #999\n");
+
+  EXPECT_FALSE(result.success);
+  EXPECT_TRUE(result.words.empty());
+  ASSERT_EQ(result.diagnostics.size(), 1);
+  EXPECT_EQ(result.diagnostics[0].line, 2);
+  EXPECT_NE(result.diagnostics[0].message.find("9 bits"), std::string::npos);
+}
+
+TEST(AssemblerTest, ContextCanBeReused) {
+  AssemblerContext context;
+  EXPECT_FALSE(context.assemble("b NOWHERE").success);
+
+  const AssembleResult& result = context.assemble("L: b L");
+  ASSERT_TRUE(result.success);
+  EXPECT_TRUE(result.diagnostics.empty());
+  ASSERT_EQ(result.words.size(), 1);
+  EXPECT_EQ(result.words[0], 0x21FF);
+}
+
+TEST(AssemblerTest, CApiRoundTrip) {
+  EXPECT_EQ(sbasm_abi_version(), SBASM_ABI_VERSION);
+
+  sbasm_context* context = sbasm_context_create();
+  ASSERT_NE(context, nullptr);
+
+  sbasm_options options;
+  sbasm_options_init(&options);
+  options.default_depth = 128;
+
+  const std::string source = "mv r0, #3\n.word 7\n";
+  ASSERT_EQ(sbasm_assemble(context, source.data(), source.size(), &options), 1);
+  EXPECT_EQ(sbasm_depth(context), 128);
+  ASSERT_EQ(sbasm_word_count(context), 2);
+  EXPECT_EQ(sbasm_words(context)[0], 0x1003);
+  EXPECT_EQ(sbasm_data_flags(context)[1], 1);
+  ASSERT_EQ(sbasm_segment_count(context), 2);
+  sbasm_segment segment;
+  ASSERT_EQ(sbasm_get_segment(context, 1, &segment), 1);
+  EXPECT_EQ(segment.base, 1);
+  EXPECT_EQ(segment.is_data, 1);
+  EXPECT_EQ(sbasm_get_segment(context, 2, &segment), 0);
+
+  const std::string broken = "mv r0, #3\nfoo";
+  EXPECT_EQ(sbasm_assemble(context, broken.data(), broken.size(), nullptr), 0);
+  ASSERT_EQ(sbasm_diagnostic_count(context), 1);
+  sbasm_diagnostic diagnostic;
+  ASSERT_EQ(sbasm_get_diagnostic(context, 0, &diagnostic), 1);
+  EXPECT_EQ(diagnostic.line, 2);
+  EXPECT_EQ(sbasm_get_diagnostic(context, 1, &diagnostic), 0);
+
+  EXPECT_EQ(sbasm_assemble(nullptr, source.data(), source.size(), nullptr), -1);
+  sbasm_context_destroy(context);
+}
+
+TEST(AssemblerTest, IncrementalUpdatesMatchFullAssembly) {
+  const std::vector<std::string> edits = {
+    PROGRAM,
+    // change an immediate only
+    std::string(PROGRAM).replace(std::string(PROGRAM).find("#1"), 2, "#2"),
+    // insert a line: every later address and the backward branch move
+    std::string("       mv   r2, r3\n") + PROGRAM,
+    // redefine a symbol used by an unchanged line
+    std::string(PROGRAM).replace(std::string(PROGRAM).find("0x1000"), 6, "0x2345"),
+    // statement split across lines: falls back to the full pipeline
+    std::string(PROGRAM) + "mv r3,\nr4\n",
+    // move the data block: the branch target and a segment change
+    std::string(PROGRAM) + ".org 0x40\nEND: b MAIN\n",
+    // undefined label
+    std::string(PROGRAM) + "b NOWHERE\n",
+    PROGRAM,
+  };
+
+  IncrementalAssembler incremental;
+  for (const auto& source : edits) {
+    AssembleResult expected = assemble(source);
+    const AssembleResult& actual = incremental.update(source);
+
+    ASSERT_EQ(actual.success, expected.success) << source;
+    EXPECT_EQ(actual.depth, expected.depth);
+    EXPECT_EQ(actual.words, expected.words) << source;
+    EXPECT_EQ(actual.isData, expected.isData);
+    ASSERT_EQ(actual.segments.size(), expected.segments.size());
+    for (size_t i = 0; i < actual.segments.size(); i++) {
+      EXPECT_EQ(actual.segments[i].base, expected.segments[i].base);
+      EXPECT_EQ(actual.segments[i].length, expected.segments[i].length);
+    }
+    ASSERT_EQ(actual.symbols.size(), expected.symbols.size());
+    for (size_t i = 0; i < actual.symbols.size(); i++) {
+      EXPECT_EQ(actual.symbols[i].name, expected.symbols[i].name);
+      EXPECT_EQ(actual.symbols[i].value, expected.symbols[i].value);
+    }
+    ASSERT_EQ(actual.diagnostics.size(), expected.diagnostics.size());
+    if (!expected.diagnostics.empty()) {
+      EXPECT_EQ(actual.diagnostics[0].line, expected.diagnostics[0].line);
+      EXPECT_EQ(actual.diagnostics[0].message, expected.diagnostics[0].message);
+    }
+  }
+
+  // Only the edited line is re-lexed and only statements it affects re-encoded.
+  std::string source = PROGRAM;
+  incremental.update(source);
+  source.replace(source.find("#1"), 2, "#3");
+  ASSERT_TRUE(incremental.update(source).success);
+  EXPECT_FALSE(incremental.getStats().fullRebuild);
+  EXPECT_EQ(incremental.getStats().linesRelexed, 1);
+  EXPECT_EQ(incremental.getStats().statementsEncoded, 1);
+}
+
+// A label at N + 1 and a define of N are different inputs to the encoding
+// of a line that names them; the cached word must not survive the switch.
+TEST(AssemblerTest, IncrementalNoticesLabelTurnedIntoDefine) {
+  const std::string withLabel =
+    "       mv   r0, =FOO\n"     // mvt, add
+    "       mv   r1, #0\n"
+    "       mv   r1, #0\n"
+    "       mv   r1, #0\n"
+    "FOO:   mv   r1, #0\n";     // address 5
+  std::string withDefine = withLabel;
+  withDefine.replace(withDefine.find("FOO:"), 4, ".define FOO 4\n    ");
+
+  IncrementalAssembler incremental;
+  ASSERT_TRUE(incremental.update(withLabel).success);
+  EXPECT_EQ(incremental.update(withLabel).words, assemble(withLabel).words);
+  const AssembleResult expected = assemble(withDefine);
+  const AssembleResult& actual = incremental.update(withDefine);
+  ASSERT_TRUE(actual.success);
+  EXPECT_FALSE(incremental.getStats().fullRebuild);
+  EXPECT_EQ(actual.words, expected.words);
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "DebugInfo/DebugInfo.h"
+#include "Assembler/IncrementalAssembler.h"
+#include <cstring>
+
+static AssembleResult assembleWithLines(const std::string& source, unsigned jobs = 1) {
+  AssembleOptions options;
+  options.debugInfo = true;
+  options.jobs = jobs;
+  return assemble(source, options);
+}
+
+TEST(DebugInfoTest, RoundTripsLinesAndLabels) {
+  AssembleResult result = assembleWithLines(
+    ".define LED 0x1000\n"
+    "MAIN:  mv   r0, =LED\n"
+    "\n"
+    "LOOP:  add  r1, #1\n"
+    "  st r1, [r0]\n"
+    "       b    LOOP\n"
+    "DATA:  .word 0xBEEF\n");
+  ASSERT_TRUE(result.success);
+  ASSERT_EQ(result.lineTable.size(), 5);
+
+  DebugInfo info;
+  info.load(DebugInfo::serialize(result));
+  EXPECT_EQ(info.getWordCount(), 6);
+  EXPECT_EQ(info.rowCount(), 5);
+  EXPECT_EQ(info.labelCount(), 3);
+
+  int line = 0, column = 0;
+  // both words of the mv =LED pair map to its line
+  ASSERT_TRUE(info.findLine(1, line, column));
+  EXPECT_EQ(line, 2);
+  EXPECT_EQ(column, 8);
+  ASSERT_TRUE(info.findLine(3, line, column));
+  EXPECT_EQ(line, 5);
+  EXPECT_EQ(column, 3);
+  EXPECT_FALSE(info.findLine(6, line, column));
+
+  uint32_t offset = 0;
+  EXPECT_STREQ(info.findLabel(3, offset), "LOOP");
+  EXPECT_EQ(offset, 1);
+  EXPECT_STREQ(info.findLabel(5, offset), "DATA");
+  EXPECT_EQ(offset, 0);
+  EXPECT_STREQ(info.findLabel(100, offset), "DATA");
+}
+
+TEST(DebugInfoTest, MapsNoLineToAddressesSkippedByOrg) {
+  AssembleResult result = assembleWithLines(
+    "       b    MAIN\n"
+    "       .org 0x10\n"
+    "MAIN:  mv   r0, =MAIN\n"
+    "END:   b    END\n");
+  ASSERT_TRUE(result.success);
+
+  DebugInfo info;
+  info.load(DebugInfo::serialize(result));
+  EXPECT_EQ(info.getWordCount(), 0x13);
+  EXPECT_EQ(info.segmentCount(), 2);
+
+  int line = 0, column = 0;
+  ASSERT_TRUE(info.findLine(0, line, column));
+  EXPECT_EQ(line, 1);
+  EXPECT_FALSE(info.findLine(1, line, column));
+  EXPECT_FALSE(info.findLine(0xF, line, column));
+  ASSERT_TRUE(info.findLine(0x11, line, column));
+  EXPECT_EQ(line, 3);
+  ASSERT_TRUE(info.findLine(0x12, line, column));
+  EXPECT_EQ(line, 4);
+  EXPECT_FALSE(info.findLine(0x13, line, column));
+}
+
+TEST(DebugInfoTest, RejectsCorruptInput) {
+  DebugInfo info;
+  EXPECT_THROW(info.load("ELF"), std::runtime_error);
+
+  std::string bytes = DebugInfo::serialize(assembleWithLines("L: b L\n"));
+  EXPECT_THROW(info.load(bytes.substr(0, bytes.size() - 1)), std::runtime_error);
+  bytes[4] = 99;
+  EXPECT_THROW(info.load(bytes), std::runtime_error);
+}
+
+TEST(DebugInfoTest, LineTableIsTheSameForEveryEncodingPath) {
+  std::string source = "// DEPTH = 16384\n";
+  for (int i = 0; i < 5000; i++) {
+    source += "L" + std::to_string(i) + ": mv r0, =L" + std::to_string(i) + "\n  add r1, #1\n";
+  }
+  AssembleResult serial = assembleWithLines(source);
+  AssembleResult parallel = assembleWithLines(source, 4);
+
+  AssembleOptions options;
+  options.debugInfo = true;
+  IncrementalAssembler incremental;
+  const AssembleResult& cached = incremental.update(source, options);
+
+  ASSERT_TRUE(serial.success);
+  std::string expected = DebugInfo::serialize(serial);
+  EXPECT_EQ(DebugInfo::serialize(parallel), expected);
+  EXPECT_EQ(DebugInfo::serialize(cached), expected);
+  // about 3 bytes per row plus the labels
+  EXPECT_LT(expected.size(), serial.lineTable.size() * 3 + 5000 * 8);
+}
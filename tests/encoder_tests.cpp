@@ -125,4 +125,52 @@ TEST_F(EncoderTest, HandlesWordDirective) {
   
   ASSERT_EQ(result.size(), 1);
   EXPECT_EQ(result[0], 0xABCD);
-}
\ No newline at end of file
+}
+
+TEST_F(EncoderTest, ParallelEncodingMatchesSerial) {
+  std::vector<std::unique_ptr<Statement>> ast;
+  SymbolTable table;
+  int address = 0;
+
+  for (int i = 0; i < 6000; i++) {
+    if (i % 50 == 0) {
+      const std::string name = "L" + std::to_string(i);
+      table.addLabel(name, address);
+      ast.push_back(std::make_unique<Label>(name, i + 1, 1));
+    }
+    if (i % 7 == 0) {
+      ast.push_back(std::make_unique<Instruction>("mv", "r1", "0x1234", true, true, true, i + 1, 1));
+    } else if (i % 50 == 49) {
+      ast.push_back(std::make_unique<Instruction>("bne", "L" + std::to_string(i - 49), "", false, false, false, i + 1, 1));
+    } else if (i % 11 == 0) {
+      ast.push_back(std::make_unique<Directive>(".word", "", std::to_string(i), i + 1, 1));
+    } else {
+      ast.push_back(std::make_unique<Instruction>("add", "r2", std::to_string(i % 200), true, false, true, i + 1, 1));
+    }
+    address += Encoder::wordCount(ast.back().get());
+  }
+
+  Encoder serial(table);
+  Encoder parallel(table);
+  auto expected = serial.encode(ast);
+  auto actual = parallel.encodeParallel(ast, 4);
+
+  ASSERT_EQ(expected.size(), static_cast<size_t>(address));
+  EXPECT_EQ(actual, expected);
+}
+
+TEST_F(EncoderTest, ParallelEncodingReportsFirstErrorInSourceOrder) {
+  std::vector<std::unique_ptr<Statement>> ast;
+  for (int i = 0; i < 8000; i++) {
+    ast.push_back(std::make_unique<Instruction>("add", "r0", "1", true, false, true, i + 1, 1));
+  }
+  ast[7000] = std::make_unique<Instruction>("add", "r0", "999", true, false, true, 7001, 1);
+  ast[2000] = std::make_unique<Instruction>("add", "r0", "999", true, false, true, 2001, 1);
+
+  try {
+    encoder.encodeParallel(ast, 4);
+    FAIL() << "expected an encoding error";
+  } catch (const std::runtime_error& e) {
+    EXPECT_NE(std::string(e.what()).find("line 2001"), std::string::npos);
+  }
+}
@@ -92,4 +92,147 @@ TEST(LexerTest, TokenizesDirectives) {
   EXPECT_EQ(tokens[0].value, ".word");
   EXPECT_EQ(tokens[2].type, TokenType::DIRECTIVE);
   EXPECT_EQ(tokens[2].value, ".define");
-}
\ No newline at end of file
+}
+
+TEST(LexerTest, ParallelTokenizeMatchesSerial) {
+  std::string input;
+  for (int i = 0; input.size() < (3u << 20); i++) {
+    input += "LOOP" + std::to_string(i) + ": add r1, #" + std::to_string(i % 200) + "   // step\n";
+    input += "\tmv r0, =0x" + std::to_string(1000 + i % 9000) + "\r\n";
+    input += "\n  beq LOOP" + std::to_string(i) + "\n";
+  }
+
+  Lexer lexer(input);
+  std::vector<Token> expected = lexer.tokenize();
+  std::vector<Token> actual = Lexer::tokenizeParallel(input, 4);
+
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_EQ(actual[i].type, expected[i].type) << "token " << i;
+    ASSERT_EQ(actual[i].value, expected[i].value) << "token " << i;
+    ASSERT_EQ(actual[i].line, expected[i].line) << "token " << i;
+    ASSERT_EQ(actual[i].column, expected[i].column) << "token " << i;
+  }
+}
+
+TEST(LexerTest, ParallelTokenizeReportsErrorLine) {
+  std::string input;
+  for (int i = 0; i < 200000; i++) {
+    input += "add r0, #1\n";
+  }
+  input += "add r0, # ,\n";
+
+  try {
+    Lexer::tokenizeParallel(input, 4);
+    FAIL() << "expected a lexer error";
+  } catch (const std::runtime_error& e) {
+    EXPECT_NE(std::string(e.what()).find("line 200001"), std::string::npos);
+  }
+}
+
+TEST(LexerTest, TracksColumnsAcrossLongBlankRunsAndComments) {
+  std::string input = std::string(70, ' ') + "mv" + std::string(37, '\t') + "r0, r1 // " +
+                      std::string(200, 'c') + "\n" + std::string(33, ' ') + "b LOOP";
+  Lexer lexer(input);
+  std::vector<Token> tokens = lexer.tokenize();
+
+  ASSERT_EQ(tokens.size(), 7);
+  EXPECT_EQ(tokens[0].column, 71);
+  EXPECT_EQ(tokens[1].column, 110);
+  EXPECT_EQ(tokens[4].line, 2);
+  EXPECT_EQ(tokens[4].column, 34);
+  EXPECT_EQ(tokens[5].value, "LOOP");
+}
+
+TEST(LexerTest, SimdScannersMatchScalar) {
+  std::string buffer;
+  for (int i = 0; i < 300; i++) {
+    buffer += (i % 17 == 0) ? '\n' : (i % 5 == 0 ? '\t' : ' ');
+    if (i % 41 == 0) buffer += 'x';
+  }
+
+  for (size_t offset = 0; offset < buffer.size(); offset++) {
+    const char* p = buffer.data() + offset;
+    const size_t n = buffer.size() - offset;
+    EXPECT_EQ(charscan::spanBlanks(p, n), charscan::spanBlanksScalar(p, n)) << "offset " << offset;
+    EXPECT_EQ(charscan::findByte(p, n, '\n'), charscan::findByteScalar(p, n, '\n')) << "offset " << offset;
+    EXPECT_EQ(charscan::findByte(p, n, 'x'), charscan::findByteScalar(p, n, 'x')) << "offset " << offset;
+  }
+}
+
+TEST(LexerTest, DecodesNumericLiteralsOnce) {
+  std::string input = ".word 0xABCD\n.word -32768\n.word 0b1010\nadd r0, #-5\nmv r1, =0x1234\nmv r2, #SYM";
+  Lexer lexer(input);
+  std::vector<Token> tokens = lexer.tokenize();
+
+  ASSERT_EQ(tokens.size(), 19);
+  EXPECT_TRUE(tokens[1].hasNumber);
+  EXPECT_EQ(tokens[1].number, 0xABCD);
+  EXPECT_EQ(tokens[3].number, -32768);
+  EXPECT_EQ(tokens[5].number, 10);
+  EXPECT_EQ(tokens[9].type, TokenType::NUMBER_IMMEDIATE);
+  EXPECT_EQ(tokens[9].number, -5);
+  EXPECT_EQ(tokens[13].type, TokenType::LABEL_IMMEDIATE);
+  EXPECT_EQ(tokens[13].number, 0x1234);
+  EXPECT_FALSE(tokens[17].hasNumber);
+}
+
+TEST(LexerTest, DetectsNumericOverflowAndMalformedLiterals) {
+  int64_t value = 0;
+
+  const std::string max = "9223372036854775807";
+  const std::string min = "-9223372036854775808";
+  const std::string over = "9223372036854775808";
+  const std::string hexOver = "0x10000000000000000";
+  EXPECT_EQ(parseNumericLiteral(max.data(), max.data() + max.size(), value), NumberStatus::OK);
+  EXPECT_EQ(value, INT64_MAX);
+  EXPECT_EQ(parseNumericLiteral(min.data(), min.data() + min.size(), value), NumberStatus::OK);
+  EXPECT_EQ(value, INT64_MIN);
+  EXPECT_EQ(parseNumericLiteral(over.data(), over.data() + over.size(), value), NumberStatus::OUT_OF_RANGE);
+  EXPECT_EQ(parseNumericLiteral(hexOver.data(), hexOver.data() + hexOver.size(), value), NumberStatus::OUT_OF_RANGE);
+
+  Lexer overflow(".word 99999999999999999999");
+  EXPECT_THROW(overflow.tokenize(), std::runtime_error);
+  Lexer malformed(".word 0b102");
+  EXPECT_THROW(malformed.tokenize(), std::runtime_error);
+}
+
+TEST(LexerTest, SkipsDisabledConditionalBlocks) {
+  const std::string input =
+      ".define BOARD 2\n"
+      ".if BOARD == 1\n"
+      "  mv r0, # ,      // never lexed\n"
+      "  .ifdef ANY\n"
+      "  .else\n"
+      "  .endif\n"
+      ".else\n"
+      "  .ifndef FAST\n"
+      "  add r1, #1\n"
+      "  .endif\n"
+      ".endif\n"
+      ".ifdef FAST\n"
+      "  sub r2, #2\n"
+      ".endif\n";
+
+  Lexer lexer(input);
+  std::vector<Token> tokens = lexer.tokenize();
+  ASSERT_EQ(tokens.size(), 8);
+  EXPECT_EQ(tokens[3].value, "add");
+  EXPECT_EQ(tokens[3].line, 9);
+  EXPECT_EQ(tokens[7].type, TokenType::END_OF_FILE);
+
+  SymbolTable predefined;
+  predefined.addDefine("FAST", 1);
+  std::vector<Token> fast;
+  Lexer::tokenizeParallel(input, 1, fast, &predefined);
+  ASSERT_EQ(fast.size(), 8);
+  EXPECT_EQ(fast[3].value, "sub");
+  EXPECT_EQ(fast[3].line, 13);
+
+  EXPECT_THROW(Lexer(".if 1\nmv r0, r1\n").tokenize(), AssemblyError);
+  EXPECT_THROW(Lexer(".if 0\nmv r0, r1\n").tokenize(), AssemblyError);
+  EXPECT_THROW(Lexer(".endif\n").tokenize(), AssemblyError);
+  EXPECT_THROW(Lexer(".if UNDEFINED\n.endif\n").tokenize(), AssemblyError);
+  EXPECT_THROW(Lexer(".if 1 =< 2\n.endif\n").tokenize(), AssemblyError);
+  EXPECT_THROW(Lexer(".if 1\n.else\n.else\n.endif\n").tokenize(), AssemblyError);
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "Lsp/Json.h"
+#include "Lsp/LanguageServer.h"
+#include "Assembler/IncrementalAssembler.h"
+#include <algorithm>
+#include <sstream>
+
+static const char* SOURCE =
+    ".define COUNT 3\n"
+    "MAIN: mv r0, #COUNT\n"
+    "LOOP: sub r0, #1\n"
+    "      bne LOOP\n"
+    "      mv r1, =DATA\n"
+    "END:  b END\n"
+    "DATA: .word 7\n";
+
+static std::string frame(const std::string& body) {
+  return "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+static std::vector<JsonValue> unframe(const std::string& stream) {
+  std::vector<JsonValue> messages;
+  size_t pos = 0;
+  while ((pos = stream.find("Content-Length: ", pos)) != std::string::npos) {
+    const size_t length = std::stoul(stream.substr(pos + 16));
+    const size_t body = stream.find("\r\n\r\n", pos) + 4;
+    messages.push_back(JsonValue::parse(stream.substr(body, length)));
+    pos = body + length;
+  }
+  return messages;
+}
+
+static std::string position(const char* method, int id, int line, int character) {
+  return std::string("{\"jsonrpc\":\"2.0\",\"id\":") + std::to_string(id) + ",\"method\":\"" + method +
+         "\",\"params\":{\"textDocument\":{\"uri\":\"file:///work/a.s\"},\"position\":{\"line\":" +
+         std::to_string(line) + ",\"character\":" + std::to_string(character) + "}}}";
+}
+
+TEST(LspTest, ParsesAndSerializesJson) {
+  JsonValue value = JsonValue::parse(
+      " {\"a\": [1, -2.5, true, null], \"s\": \"x\\\"\\n\\u00e9\\ud83d\\ude00\", \"o\": {}} ");
+  ASSERT_TRUE(value.isObject());
+  EXPECT_EQ(value.get("a").size(), 4u);
+  EXPECT_EQ(value.get("a")[0].asInt(), 1);
+  EXPECT_DOUBLE_EQ(value.get("a")[1].asNumber(), -2.5);
+  EXPECT_TRUE(value.get("a")[2].asBool());
+  EXPECT_TRUE(value.get("a")[3].isNull());
+  EXPECT_EQ(value.get("s").asString(), "x\"\n\xc3\xa9\xf0\x9f\x98\x80");
+  EXPECT_TRUE(value.get("missing").isNull());
+  EXPECT_EQ(value.serialize(),
+            "{\"a\":[1,-2.5,true,null],\"s\":\"x\\\"\\n\xc3\xa9\xf0\x9f\x98\x80\",\"o\":{}}");
+
+  EXPECT_THROW(JsonValue::parse("{\"a\": }"), std::runtime_error);
+  EXPECT_THROW(JsonValue::parse("[1, 2"), std::runtime_error);
+  EXPECT_THROW(JsonValue::parse("1 2"), std::runtime_error);
+}
+
+TEST(LspTest, SymbolIndexFollowsEdits) {
+  IncrementalAssembler assembler(true);
+  std::string source = SOURCE;
+  ASSERT_TRUE(assembler.update(source).success);
+
+  auto lines = [&](const std::string& name, bool definition) {
+    std::vector<int> found;
+    for (const SymbolReference& ref : assembler.getSymbolIndex().find(name)) {
+      if (ref.definition == definition) found.push_back(assembler.lineNumber(ref.lineId));
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+  };
+  EXPECT_EQ(lines("COUNT", true), std::vector<int>({1}));
+  EXPECT_EQ(lines("COUNT", false), std::vector<int>({2}));
+  EXPECT_EQ(lines("LOOP", true), std::vector<int>({3}));
+  EXPECT_EQ(lines("LOOP", false), std::vector<int>({4}));
+  EXPECT_EQ(lines("DATA", false), std::vector<int>({5}));
+  EXPECT_EQ(lines("END", false), std::vector<int>({6}));
+
+  // Uses on the edited line move; lines below the edit are renumbered.
+  source.insert(0, "// header\n        b LOOP\n");
+  ASSERT_TRUE(assembler.update(source).success);
+  EXPECT_EQ(assembler.getStats().linesRelexed, 2u);
+  EXPECT_EQ(lines("LOOP", true), std::vector<int>({5}));
+  EXPECT_EQ(lines("LOOP", false), std::vector<int>({2, 6}));
+
+  int address = 0;
+  std::vector<uint16_t> words;
+  ASSERT_TRUE(assembler.lineEncoding(7, address, words));   // mv r1, =DATA
+  EXPECT_EQ(address, 4);
+  EXPECT_EQ(words, std::vector<uint16_t>({0x3200, 0x5207}));
+  EXPECT_FALSE(assembler.lineEncoding(1, address, words));
+
+  // A line that does not parse is reported without dropping the cache.
+  std::string broken = source;
+  broken.erase(broken.find("sub r0, #1") + 6, 1);
+  const AssembleResult& result = assembler.update(broken);
+  ASSERT_FALSE(result.success);
+  EXPECT_EQ(result.diagnostics[0].line, 5);
+  EXPECT_EQ(result.diagnostics[0].message, assemble(broken).diagnostics[0].message);
+  EXPECT_EQ(assembler.getStats().linesRelexed, 1u);
+  EXPECT_EQ(lines("LOOP", true), std::vector<int>());
+  EXPECT_EQ(lines("LOOP", false), std::vector<int>({2, 6}));
+
+  ASSERT_TRUE(assembler.update(source).success);
+  EXPECT_EQ(assembler.getStats().linesRelexed, 1u);
+  EXPECT_EQ(lines("LOOP", true), std::vector<int>({5}));
+}
+
+TEST(LspTest, ServesDiagnosticsDefinitionAndHover) {
+  JsonValue item = JsonValue::object();
+  item.set("uri", "file:///work/a.s");
+  item.set("languageId", "qcore");
+  item.set("version", 1);
+  item.set("text", SOURCE);
+  JsonValue params = JsonValue::object();
+  params.set("textDocument", item);
+  JsonValue open = JsonValue::object();
+  open.set("jsonrpc", "2.0");
+  open.set("method", "textDocument/didOpen");
+  open.set("params", params);
+
+  std::string input;
+  input += frame("{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"initialize\",\"params\":{}}");
+  input += frame(open.serialize());
+  input += frame(position("textDocument/definition", 2, 3, 11));   // bne LOOP
+  input += frame(position("textDocument/hover", 3, 4, 14));        // mv r1, =DATA
+  input += frame(position("textDocument/references", 4, 2, 1));    // LOOP:
+  // Delete the comma on line 3 (a syntax error), then put it back.
+  input += frame("{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/didChange\",\"params\":{\"textDocument\":"
+                 "{\"uri\":\"file:///work/a.s\",\"version\":2},\"contentChanges\":[{\"range\":"
+                 "{\"start\":{\"line\":2,\"character\":12},\"end\":{\"line\":2,\"character\":13}},\"text\":\"\"}]}}");
+  input += frame("{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/didChange\",\"params\":{\"textDocument\":"
+                 "{\"uri\":\"file:///work/a.s\",\"version\":3},\"contentChanges\":[{\"range\":"
+                 "{\"start\":{\"line\":2,\"character\":12},\"end\":{\"line\":2,\"character\":12}},\"text\":\",\"}]}}");
+  input += frame("{\"jsonrpc\":\"2.0\",\"id\":5,\"method\":\"unknown/request\"}");
+  input += frame("{\"jsonrpc\":\"2.0\",\"id\":6,\"method\":\"shutdown\"}");
+  input += frame("{\"jsonrpc\":\"2.0\",\"method\":\"exit\"}");
+
+  std::istringstream in(input);
+  std::ostringstream out;
+  LanguageServer server(in, out);
+  EXPECT_EQ(server.run(), 0);
+
+  std::vector<JsonValue> messages = unframe(out.str());
+  ASSERT_EQ(messages.size(), 9u);
+  EXPECT_TRUE(messages[0].get("result").get("capabilities").get("hoverProvider").asBool());
+  EXPECT_EQ(messages[0].get("result").get("capabilities").get("textDocumentSync").get("change").asInt(), 2);
+
+  EXPECT_EQ(messages[1].get("method").asString(), "textDocument/publishDiagnostics");
+  EXPECT_EQ(messages[1].get("params").get("diagnostics").size(), 0u);
+
+  const JsonValue& definition = messages[2].get("result");
+  ASSERT_EQ(definition.size(), 1u);
+  EXPECT_EQ(definition[0].get("range").get("start").get("line").asInt(), 2);
+  EXPECT_EQ(definition[0].get("range").get("start").get("character").asInt(), 0);
+  EXPECT_EQ(definition[0].get("range").get("end").get("character").asInt(), 4);
+
+  const std::string hover = messages[3].get("result").get("contents").get("value").asString();
+  EXPECT_NE(hover.find("label `DATA` at address `0x0006`"), std::string::npos) << hover;
+  EXPECT_NE(hover.find("0x0003  3200  mvt  r1, #0x0"), std::string::npos) << hover;
+  EXPECT_NE(hover.find("0x0004  5206  add  r1, #0x6"), std::string::npos) << hover;
+
+  EXPECT_EQ(messages[4].get("result").size(), 2u);
+
+  const JsonValue& broken = messages[5].get("params").get("diagnostics");
+  ASSERT_EQ(broken.size(), 1u);
+  EXPECT_EQ(broken[0].get("range").get("start").get("line").asInt(), 2);
+  EXPECT_EQ(messages[6].get("params").get("diagnostics").size(), 0u);
+
+  EXPECT_EQ(messages[7].get("error").get("code").asInt(), -32601);
+  EXPECT_TRUE(messages[8].get("result").isNull());
+  EXPECT_EQ(messages[8].get("id").asInt(), 6);
+}
+
+TEST(LspTest, DecodesFileUris) {
+  EXPECT_EQ(pathFromUri("file:///home/a%20b/x.s"), "/home/a b/x.s");
+  EXPECT_EQ(pathFromUri("file:///C:/src/x.s"), "C:/src/x.s");
+  EXPECT_EQ(pathFromUri("untitled:1"), "untitled:1");
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include "Assembler/Assembler.h"
+#include "Simulator/Simulator.h"
+#include <algorithm>
+
+static AssembleResult build(const std::string& source, bool stripUnused) {
+  AssembleOptions options;
+  options.eliminateDeadCode = stripUnused;
+  return assemble(source, options);
+}
+
+const char* const WITH_DEAD_CODE =
+  "MAIN:   mv   r0, =USED\n"
+  "        ld   r1, [r0]\n"
+  "        bl   F\n"
+  "DONE:   b    DONE\n"
+  "OLD:    mv   r2, #1\n"
+  "        b    DONE\n"
+  "F:      add  r1, #1\n"
+  "        mv   pc, lr\n"
+  "G:      sub  r1, #1\n"
+  "        mv   pc, lr\n"
+  "USED:   .word 41\n"
+  "        .word 2\n"
+  "TABLE:  .word 3\n"
+  "TAB2:   .word 4\n"
+  ".define N 1\n"
+  "        .word 5\n";
+
+TEST(OptimizerTest, RemovesUnreachableCodeAndUnusedData) {
+  AssembleResult full = build(WITH_DEAD_CODE, false);
+  AssembleResult stripped = build(WITH_DEAD_CODE, true);
+  ASSERT_TRUE(stripped.success) << stripped.diagnostics[0].message;
+
+  const EliminationReport& report = stripped.elimination;
+  ASSERT_EQ(report.removed.size(), 3);
+  EXPECT_EQ(report.removed[0].name, "OLD");
+  EXPECT_EQ(report.removed[0].line, 5);
+  EXPECT_FALSE(report.removed[0].isData);
+  EXPECT_EQ(report.removed[1].name, "G");
+  EXPECT_EQ(report.removed[2].name, "TABLE");
+  EXPECT_EQ(report.removed[2].words, 3);
+  EXPECT_TRUE(report.removed[2].isData);
+  EXPECT_EQ(report.wordsSaved, 7);
+  EXPECT_EQ(stripped.words.size(), full.words.size() - 7);
+
+  // Labels were laid out again and the program still computes the same.
+  for (const auto& symbol : stripped.symbols) {
+    EXPECT_NE(symbol.name, "G");
+  }
+  auto used = std::find_if(stripped.symbols.begin(), stripped.symbols.end(),
+                           [](const SymbolInfo& symbol) { return symbol.name == "USED"; });
+  ASSERT_NE(used, stripped.symbols.end());
+  EXPECT_EQ(used->value, 7);
+  Simulator before, after;
+  before.load(full.words);
+  after.load(stripped.words);
+  before.run(100);
+  after.run(100);
+  EXPECT_EQ(after.getRegister(1), 42);
+  EXPECT_EQ(after.getRegister(1), before.getRegister(1));
+}
+
+TEST(OptimizerTest, KeepsProgramsWithoutDeadCode) {
+  const char* source = "L: add r0, #1\n bne L\nE: b E\n";
+  AssembleResult stripped = build(source, true);
+  ASSERT_TRUE(stripped.success);
+  EXPECT_TRUE(stripped.elimination.removed.empty());
+  EXPECT_EQ(stripped.words, build(source, false).words);
+}
+
+TEST(OptimizerTest, RefusesToDropCodeWhoseAddressIsUsed) {
+  AssembleResult result = build(
+    "  mv r0, =HANDLER\n"
+    "E: b E\n"
+    "HANDLER: mv r1, #1\n"
+    "  mv pc, lr\n", true);
+  EXPECT_FALSE(result.success);
+  ASSERT_EQ(result.diagnostics.size(), 1);
+  EXPECT_EQ(result.diagnostics[0].line, 3);
+
+  EXPECT_FALSE(build("mv r0, #1\n mv pc, r0\n", true).success);
+}
+
+static AssembleResult optimize(const std::string& source) {
+  AssembleOptions options;
+  options.optimize = true;
+  return assemble(source, options);
+}
+
+static int applied(const AssembleResult& result, const std::string& rule) {
+  for (const auto& count : result.peephole.rules) {
+    if (count.rule == rule) return count.applied;
+  }
+  return -1;
+}
+
+TEST(OptimizerTest, PeepholeRulesPreserveBehavior) {
+  const std::string source =
+    "        mv   r0, #3\n"
+    "        mv   r1, r1\n"
+    "LOOP:   sub  r0, #1\n"
+    "        add  r2, #0\n"     // flags overwritten by cmp: removable
+    "        cmp  r0, #0\n"
+    "        bne  HOP\n"
+    "        b    NEXT\n"
+    "NEXT:   push r3\n"
+    "        pop  r3\n"
+    "        add  r0, #0\n"     // beq reads its flags: kept
+    "        beq  DONE\n"
+    "HOP:    b    LOOP\n"
+    "DONE:   b    DONE\n";
+  AssembleResult plain = assemble(source);
+  AssembleResult optimized = optimize(source);
+  ASSERT_TRUE(optimized.success);
+
+  EXPECT_EQ(applied(optimized, "add/sub #0 with dead flags"), 1);
+  EXPECT_EQ(applied(optimized, "mv rX, rX"), 1);
+  EXPECT_EQ(applied(optimized, "branch to next word"), 1);
+  EXPECT_EQ(applied(optimized, "branch threading"), 1);
+  EXPECT_EQ(applied(optimized, "push/pop pair"), 1);
+  EXPECT_EQ(optimized.peephole.wordsSaved, 5);
+  EXPECT_EQ(optimized.words.size(), plain.words.size() - 5);
+  EXPECT_EQ(optimized.words[3], 0x25FD);    // bne LOOP
+
+  Simulator before, after;
+  before.load(plain.words);
+  after.load(optimized.words);
+  Simulator::RunResult a = before.run(1000);
+  Simulator::RunResult b = after.run(1000);
+  EXPECT_EQ(a.reason, Simulator::StopReason::BRANCH_TO_SELF);
+  EXPECT_EQ(b.reason, a.reason);
+  EXPECT_LT(b.steps, a.steps);
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(after.getRegister(i), before.getRegister(i));
+  }
+}
+
+TEST(OptimizerTest, KeepsFlagsLiveAcrossControlFlow) {
+  // The flags of add #0 may reach the caller or a branch target.
+  const char* source =
+    "  bl F\n"
+    "  beq E\n"
+    "  mv r1, #1\n"
+    "E: b E\n"
+    "F: add r0, #0\n"
+    "  mv pc, lr\n";
+  AssembleResult result = optimize(source);
+  ASSERT_TRUE(result.success);
+  EXPECT_EQ(result.words, assemble(source).words);
+  EXPECT_EQ(result.peephole.wordsSaved, 0);
+}
+
+TEST(OptimizerTest, ThreadsOnlyWithinBranchRange) {
+  // beq HOP -> b MID (address 200) -> b FAR (address 400): FAR is out of
+  // range for the beq at address 0, so it stops at MID.
+  std::string source = "// DEPTH = 512\n  beq HOP\n  mv r1, #1\nHOP: b MID\n";
+  for (int i = 3; i < 200; i++) source += "  .word 0\n";
+  source += "MID: b FAR\n";
+  for (int i = 201; i < 400; i++) source += "  .word 0\n";
+  source += "FAR: b FAR\n";
+
+  AssembleResult result = optimize(source);
+  ASSERT_TRUE(result.success) << result.diagnostics[0].message;
+  EXPECT_EQ(applied(result, "branch threading"), 1);
+  EXPECT_EQ(result.words[0], 0x2200 | 199);    // beq MID
+}
+
+TEST(OptimizerTest, KeepsPushPopSplitByALabel) {
+  const char* source =
+    "  push r1\n"
+    "L: pop r1\n"
+    "E: b E\n";
+  EXPECT_EQ(optimize(source).words, assemble(source).words);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "Output/MifWriter.h"
+#include "Output/FileUpdate.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+static std::string render(const std::vector<uint16_t>& words, const std::vector<bool>& isData,
+                          int depth, const MifOptions& options = MifOptions()) {
+  std::ostringstream out;
+  writeMIF(out, words, isData, depth, options);
+  std::string text = out.str();
+  // only the CONTENT lines
+  size_t begin = text.find("BEGIN\n") + 6;
+  return text.substr(begin, text.find("END;") - begin);
+}
+
+TEST(OutputTest, DisassemblesWords) {
+  EXPECT_EQ(disassembleWord(0x1003, 0), "mv   r0, #0x3");
+  EXPECT_EQ(disassembleWord(0x25FD, 3), "bne 0x1");
+  EXPECT_EQ(disassembleWord(0xB205, 0), "push r1");
+  EXPECT_EQ(disassembleWord(0xE110, 0), "xor  r0, r0");
+}
+
+TEST(OutputTest, WritesSingleWordsUnchanged) {
+  EXPECT_EQ(render({0x1003, 0x21FF, 0xBEEF}, {false, false, true}, 4),
+            "0       : 1003;        % mv   r0, #0x3 %\n"
+            "1       : 21ff;        % b   0x1 %\n"
+            "2       : beef;        % data %\n"
+            "[3..3] : 0000;\n");
+}
+
+TEST(OutputTest, CompressesRunsOfIdenticalWords) {
+  std::vector<uint16_t> words = {0x1000, 0x1000, 7, 7, 7, 0, 0};
+  std::vector<bool> isData = {false, false, true, true, true, true, true};
+
+  EXPECT_EQ(render(words, isData, 7),
+            "[0..1] : 1000;        % mv   r0, #0x0 %\n"
+            "[2..4] : 0007;        % data %\n"
+            "[5..6] : 0000;        % data %\n");
+
+  MifOptions codeOnly;
+  codeOnly.comments = MifComments::INSTRUCTIONS;
+  EXPECT_EQ(render(words, isData, 7, codeOnly),
+            "0       : 1000;        % mv   r0, #0x0 %\n"
+            "1       : 1000;        % mv   r0, #0x0 %\n"
+            "[2..4] : 0007;\n"
+            "[5..6] : 0000;\n");
+
+  MifOptions none;
+  none.comments = MifComments::NONE;
+  EXPECT_EQ(render(words, isData, 8, none),
+            "[0..1] : 1000;\n"
+            "[2..4] : 0007;\n"
+            "[5..6] : 0000;\n"
+            "[7..7] : 0000;\n");
+
+  MifOptions uncompressed;
+  uncompressed.compressRuns = false;
+  uncompressed.comments = MifComments::NONE;
+  EXPECT_EQ(render({7, 7}, {true, true}, 2, uncompressed),
+            "0       : 0007;\n"
+            "1       : 0007;\n");
+}
+
+TEST(OutputTest, DoesNotMergeDataWithEqualInstructions) {
+  EXPECT_EQ(render({0x1000, 0x1000}, {false, true}, 2),
+            "0       : 1000;        % mv   r0, #0x0 %\n"
+            "1       : 1000;        % data %\n");
+}
+
+TEST(OutputTest, WritesSegmentsWithFillBetween) {
+  std::ostringstream out;
+  MifOptions none;
+  none.comments = MifComments::NONE;
+  // Packed in source order: code at 0x10, then the vector at 0x2.
+  writeMIF(out, {0x1003, 0x21FF, 0x200D}, {false, false, false},
+           {{0x2, 1, 2, false}, {0x10, 2, 0, false}}, 0x20, none);
+  const std::string text = out.str();
+  EXPECT_NE(text.find("BEGIN\n"
+                      "[0..1] : 0000;\n"
+                      "2       : 200d;\n"
+                      "[3..f] : 0000;\n"
+                      "10      : 1003;\n"
+                      "11      : 21ff;\n"
+                      "[12..1f] : 0000;\n"
+                      "END;"), std::string::npos) << text;
+}
+
+TEST(OutputTest, RewritesFilesOnlyWhenTheyChange) {
+  std::string path = ::testing::TempDir() + "output_test.mif";
+  std::remove(path.c_str());
+
+  std::string written = path;
+  EXPECT_TRUE(writeMIF({0x1003}, {false}, {{0, 1, 0, false}}, written, 4));
+  EXPECT_EQ(written, path);
+  EXPECT_FALSE(writeMIF({0x1003}, {false}, {{0, 1, 0, false}}, written, 4));
+  EXPECT_TRUE(writeMIF({0x1004}, {false}, {{0, 1, 0, false}}, written, 4));
+
+  std::ifstream in(path);
+  std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  EXPECT_NE(text.find("0       : 1004;"), std::string::npos);
+
+  // Same size, different bytes.
+  EXPECT_TRUE(writeFileIfChanged(path, "abc"));
+  EXPECT_TRUE(writeFileIfChanged(path, "abd"));
+  EXPECT_FALSE(writeFileIfChanged(path, "abd"));
+  std::remove(path.c_str());
+}
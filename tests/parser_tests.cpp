@@ -175,4 +175,45 @@ TEST(ParserTest, ParsesDirectives) {
     auto* word = static_cast<Directive*>(statements[1].get());
     EXPECT_EQ(word->name, ".word");
     EXPECT_EQ(word->value, "0xABCD");
-}
\ No newline at end of file
+}
+
+TEST(ParserTest, CarriesLexedNumbersIntoStatements) {
+    auto statements = parseInput("mv r0, =0x1234\nadd r1, #-3\n.define MAX 0b11\nmv r2, #MAX");
+    
+    ASSERT_EQ(statements.size(), 4);
+    
+    auto* mv = static_cast<Instruction*>(statements[0].get());
+    EXPECT_TRUE(mv->hasNumber);
+    EXPECT_EQ(mv->number, 0x1234);
+    
+    auto* add = static_cast<Instruction*>(statements[1].get());
+    EXPECT_EQ(add->number, -3);
+    
+    auto* define = static_cast<Directive*>(statements[2].get());
+    EXPECT_TRUE(define->hasNumber);
+    EXPECT_EQ(define->number, 3);
+    
+    auto* symbolic = static_cast<Instruction*>(statements[3].get());
+    EXPECT_FALSE(symbolic->hasNumber);
+}
+
+TEST(ParserTest, ParsesMultiValueWordAndIncbin) {
+    auto statements = parseInput("T: .word 1, 0x2, -3\n.incbin \"font.bin\", 16, 64\n.incbin \"a b.bin\"\n");
+
+    ASSERT_EQ(statements.size(), 4);
+    auto* words = static_cast<Directive*>(statements[1].get());
+    EXPECT_EQ(words->values, std::vector<int64_t>({1, 2, -3}));
+
+    auto* slice = static_cast<Directive*>(statements[2].get());
+    EXPECT_EQ(slice->name, ".incbin");
+    EXPECT_EQ(slice->value, "font.bin");
+    EXPECT_EQ(slice->byteOffset, 16);
+    EXPECT_EQ(slice->byteLength, 64);
+
+    auto* whole = static_cast<Directive*>(statements[3].get());
+    EXPECT_EQ(whole->value, "a b.bin");
+    EXPECT_EQ(whole->byteLength, -1);
+
+    EXPECT_THROW(parseInput(".word 1,\n"), AssemblyError);
+    EXPECT_THROW(parseInput(".incbin \"open\n"), AssemblyError);
+}
@@ -0,0 +1,572 @@
+#include <gtest/gtest.h>
+#include "Simulator/Simulator.h"
+#include "Simulator/LockstepSimulator.h"
+#include "Simulator/Profiler.h"
+#include "Simulator/TestRunner.h"
+#include <sstream>
+
+static AssembleResult build(const std::string& source) {
+  AssembleOptions options;
+  options.debugInfo = true;
+  AssembleResult result = assemble(source, options);
+  EXPECT_TRUE(result.success) << (result.diagnostics.empty() ? "" : result.diagnostics[0].message);
+  return result;
+}
+
+TEST(SimulatorTest, ExecutesArithmeticMemoryAndCalls) {
+  AssembleResult result = build(
+    "       mv   sp, =0x1000\n"
+    "       mv   r0, #5\n"
+    "       mv   r1, #0\n"
+    "LOOP:  add  r1, r0\n"
+    "       sub  r0, #1\n"
+    "       bne  LOOP\n"
+    "       bl   STORE\n"
+    "END:   b    END\n"
+    "STORE: push r1\n"
+    "       mv   r2, =0x0800\n"
+    "       st   r1, [r2]\n"
+    "       pop  r3\n"
+    "       mvt  r4, #0xAB\n"
+    "       lsr  r4, #4\n"
+    "       mv   pc, lr\n");
+
+  Simulator simulator;
+  simulator.load(result.words);
+  Simulator::RunResult run = simulator.run(1000);
+
+  EXPECT_EQ(run.reason, Simulator::StopReason::BRANCH_TO_SELF);
+  EXPECT_EQ(simulator.getRegister(1), 15);
+  EXPECT_EQ(simulator.readMemory(0x0800), 15);
+  EXPECT_EQ(simulator.getRegister(3), 15);
+  EXPECT_EQ(simulator.getRegister(4), 0x0AB0);
+  EXPECT_EQ(simulator.getRegister(Simulator::SP), 0x1000);
+  EXPECT_FALSE(simulator.zeroFlag());
+}
+
+TEST(SimulatorTest, ComparesAndSetsCarryLikeSubtraction) {
+  AssembleResult result = build(
+    "  mv  r0, #3\n"
+    "  cmp r0, #5\n"
+    "  bcs WRONG\n"
+    "  mv  r1, #1\n"
+    "  mv  r2, #-1\n"
+    "  add r2, #1\n"
+    "END: b END\n"
+    "WRONG: mv r1, #2\n"
+    "  b END\n");
+
+  Simulator simulator;
+  simulator.load(result.words);
+  simulator.run(100);
+  EXPECT_EQ(simulator.getRegister(1), 1);
+  EXPECT_EQ(simulator.getRegister(2), 0);
+  EXPECT_TRUE(simulator.carryFlag());
+  EXPECT_TRUE(simulator.zeroFlag());
+}
+
+// c is the last bit shifted out (for ror the bit rotated into the msb) on
+// every engine; shifts by 0 keep it.
+TEST(SimulatorTest, ShiftsSetCarryToTheLastBitOut) {
+  struct Case {
+    const char* source;
+    uint16_t r0;
+    bool carry;
+  };
+  const Case cases[] = {
+    {"mv r0, =0x8001\nlsl r0, #1", 0x0002, true},
+    {"mv r0, =0x4001\nlsl r0, #1", 0x8002, false},
+    {"mv r0, =0x0100\nmv r1, #8\nlsl r0, r1", 0x0000, true},
+    {"mv r0, #3\nlsr r0, #1", 0x0001, true},
+    {"mv r0, #2\nlsr r0, #1", 0x0001, false},
+    {"mv r0, =0x8002\nasr r0, #2", 0xE000, true},
+    {"mv r0, #16\nmv r1, #5\nror r0, r1", 0x8000, true},
+    {"mv r0, #8\nror r0, #3", 0x0001, false},
+    {"mv r0, #1\nmv r1, #16\nlsl r0, r1", 0x0001, true},     // amount 16 & 0xF = 0
+    {"mv r0, #1\nlsr r0, #0", 0x0001, true},
+  };
+  for (const Case& test : cases) {
+    AssembleResult result = build(std::string(test.source) + "\nEND: b END\n");
+    for (Simulator::Engine engine : {Simulator::Engine::INTERPRETER, Simulator::Engine::BLOCKS,
+                                     Simulator::Engine::JIT}) {
+      Simulator simulator;
+      simulator.setEngine(engine);
+      simulator.setJitThreshold(0);
+      simulator.load(result.words, result.segments);
+      simulator.setFlags(false, false, true);
+      simulator.run(100);
+      EXPECT_EQ(simulator.getRegister(0), test.r0) << test.source;
+      EXPECT_EQ(simulator.carryFlag(), test.carry) << test.source << ", engine " << static_cast<int>(engine);
+    }
+    LockstepSimulator lockstep;
+    lockstep.load(result.words, result.segments);
+    uint64_t maxSteps[LockstepSimulator::LANES] = {100};
+    Simulator::RunResult runs[LockstepSimulator::LANES];
+    lockstep.setFlags(0, false, false, true);
+    lockstep.run(maxSteps, runs);
+    EXPECT_EQ(lockstep.getRegister(0, 0), test.r0) << test.source;
+    EXPECT_EQ(lockstep.carryFlag(0), test.carry) << test.source << ", lockstep";
+  }
+}
+
+TEST(SimulatorTest, StopsAtStepLimit) {
+  AssembleResult result = build("L: add r0, #1\n b L\n");
+  Simulator simulator;
+  simulator.load(result.words);
+  Simulator::RunResult run = simulator.run(11);
+  EXPECT_EQ(run.reason, Simulator::StopReason::STEP_LIMIT);
+  EXPECT_EQ(run.steps, 11);
+  EXPECT_EQ(simulator.getRegister(0), 6);
+}
+
+TEST(SimulatorTest, ProfilesLinesAndBranches) {
+  const std::string source =
+    "  mv  r0, #4\n"
+    "LOOP:\n"
+    "  sub r0, #1\n"
+    "  bne LOOP\n"
+    "  cmp r0, #0\n"
+    "  bne NEVER\n"
+    "END: b END\n"
+    "NEVER: mv r1, #1\n"
+    "  .word 7\n";
+  AssembleResult result = build(source);
+
+  Simulator simulator;
+  Simulator::Profile profile;
+  simulator.load(result.words);
+  Simulator::RunResult run = simulator.run(1000, profile);
+  EXPECT_EQ(run.steps, 1 + 4 * 2 + 2 + 1);
+
+  std::vector<LineProfile> lines = profileLines(result, profile, 9);
+  EXPECT_FALSE(lines[1].hasCode);
+  EXPECT_EQ(lines[2].executions, 4);
+  EXPECT_EQ(lines[3].taken, 3);
+  EXPECT_EQ(lines[3].notTaken, 1);
+  EXPECT_EQ(lines[5].taken, 0);
+  EXPECT_EQ(lines[5].notTaken, 1);
+  EXPECT_EQ(lines[7].executions, 0);
+  EXPECT_FALSE(lines[8].hasCode);     // data
+
+  CoverageSummary summary = summarizeCoverage(lines);
+  EXPECT_EQ(summary.codeLines, 7);
+  EXPECT_EQ(summary.executedLines, 6);
+  EXPECT_EQ(summary.conditionalBranches, 2);
+  EXPECT_EQ(summary.branchesBothWays, 1);
+
+  std::ostringstream report;
+  writeProfileReport(report, source, result, profile, run);
+  EXPECT_NE(report.str().find("#####"), std::string::npos);
+  EXPECT_NE(report.str().find("3/1"), std::string::npos);
+  EXPECT_NE(report.str().find("Lines executed:        6 of 7"), std::string::npos);
+}
+
+TEST(SimulatorTest, ProfiledRunMatchesPlainRun) {
+  AssembleResult result = build(
+    "  mv r0, =1000\n"
+    "L: lsl r1, #1\n"
+    "  xor r2, r1\n"
+    "  sub r0, #1\n"
+    "  bne L\n"
+    "END: b END\n");
+
+  Simulator plain, profiled;
+  Simulator::Profile profile;
+  plain.load(result.words);
+  profiled.load(result.words);
+  Simulator::RunResult a = plain.run(100000);
+  Simulator::RunResult b = profiled.run(100000, profile);
+  EXPECT_EQ(a.steps, b.steps);
+  for (int i = 0; i < 8; i++) {
+    EXPECT_EQ(plain.getRegister(i), profiled.getRegister(i));
+  }
+  EXPECT_EQ(profile.executions[2], 1000);
+}
+
+TEST(SimulatorTest, RunsManifestCasesOnAThreadPool) {
+  const std::string manifestJson = R"({
+    "name": "grading",
+    "programs": [
+      {"name": "sum", "source": "sum.s", "cases": [
+        {"name": "four", "registers": {"r0": "DATA", "r1": 4}, "memory": {"DATA": [1, 2, 3, -1]},
+         "expect": {"registers": {"r2": 5}, "memory": {"RESULT": 5}}},
+        {"name": "wrong", "registers": {"r0": "DATA", "r1": 2}, "memory": {"DATA": [1, 2]},
+         "expect": {"registers": {"r2": "0xB"}}},
+        {"name": "runaway", "maxSteps": 200, "registers": {"r1": 0}, "expect": {"stop": "step-limit"}},
+        {"name": "no halt", "maxSteps": 200, "registers": {"r1": 0}}
+      ]},
+      {"source": "broken.s", "cases": [{"name": "never runs"}]}
+    ]
+  })";
+  TestManifest manifest = parseTestManifest(manifestJson, "grading", 1000);
+  ASSERT_EQ(manifest.programs.size(), 2u);
+  EXPECT_EQ(manifest.programs[0].path, "grading/sum.s");
+  EXPECT_EQ(manifest.programs[1].name, "broken.s");
+  EXPECT_EQ(manifest.programs[0].cases[0].maxSteps, 1000u);
+  manifest.programs[0].text =
+    "        mv   r2, #0\n"
+    "LOOP:   ld   r3, [r0]\n"
+    "        add  r2, r3\n"
+    "        add  r0, #1\n"
+    "        sub  r1, #1\n"
+    "        bne  LOOP\n"
+    "        mv   r3, =RESULT\n"
+    "        st   r2, [r3]\n"
+    "END:    b    END\n"
+    "RESULT: .word 0\n"
+    "DATA:   .word 0, 0, 0, 0\n";
+  manifest.programs[1].text = "mv r9, #1\n";
+
+  for (bool lockstep : {false, true}) {
+    for (unsigned jobs : {1u, 4u}) {
+      TestReport report = runTests(manifest, jobs, Simulator::fastestEngine(), lockstep);
+      EXPECT_EQ(report.passed, 2u);
+      EXPECT_EQ(report.failed, 2u);
+      EXPECT_EQ(report.errors, 1u);
+      EXPECT_FALSE(report.assemblyErrors[1].empty());
+
+      const std::vector<TestCaseResult>& sum = report.cases[0];
+      EXPECT_TRUE(sum[0].passed) << (sum[0].failures.empty() ? "" : sum[0].failures[0]);
+      EXPECT_EQ(sum[0].stop, Simulator::StopReason::BRANCH_TO_SELF);
+      ASSERT_EQ(sum[1].failures.size(), 1u);
+      EXPECT_EQ(sum[1].failures[0], "r2: expected 0x000B, got 0x0003");
+      EXPECT_TRUE(sum[2].passed);
+      EXPECT_EQ(sum[2].steps, 200u);
+      ASSERT_FALSE(sum[3].passed);
+      EXPECT_EQ(sum[3].failures[0], "did not halt within 200 steps");
+      EXPECT_TRUE(report.cases[1][0].error);
+
+      std::ostringstream junit, json;
+      writeJUnitReport(junit, manifest, report);
+      writeJsonReport(json, manifest, report);
+      EXPECT_NE(junit.str().find("<testsuites name=\"grading\" tests=\"5\" failures=\"2\" errors=\"1\""),
+                std::string::npos);
+      EXPECT_NE(junit.str().find("<failure message=\"did not halt within 200 steps\">"), std::string::npos);
+      EXPECT_NE(junit.str().find("<testcase name=\"never runs\" classname=\"broken.s\""), std::string::npos);
+      EXPECT_NE(json.str().find("\"status\":\"failed\""), std::string::npos);
+    }
+  }
+
+  EXPECT_THROW(parseTestManifest(R"({"programs": [{"source": "a.s", "cases": [{"registers": {"r8": 1}}]}]})",
+                                 "", 1000),
+               std::runtime_error);
+  try {
+    parseTestManifest(R"({"programs": [{"source": "a.s", "cases": [{"expect": {"stop": "soon"}}]}]})", "", 1000);
+    FAIL() << "expected an invalid manifest";
+  } catch (const std::runtime_error& e) {
+    EXPECT_NE(std::string(e.what()).find("programs[0].cases[0].expect.stop"), std::string::npos);
+  }
+}
+
+static void expectSameState(const Simulator& expected, const Simulator& actual, const std::string& context) {
+  for (int i = 0; i < 8; i++) {
+    ASSERT_EQ(expected.getRegister(i), actual.getRegister(i)) << "r" << i << ", " << context;
+  }
+  ASSERT_EQ(expected.zeroFlag(), actual.zeroFlag()) << context;
+  ASSERT_EQ(expected.negativeFlag(), actual.negativeFlag()) << context;
+  ASSERT_EQ(expected.carryFlag(), actual.carryFlag()) << context;
+}
+
+// Runs source on the interpreter and on engine for every step limit up to
+// the interpreter's full run and compares the complete machine state.
+static void expectEnginesAgree(const std::string& source, uint64_t maxSteps, Simulator::Engine engine,
+                               unsigned jitThreshold = JitCompiler::DEFAULT_THRESHOLD) {
+  AssembleResult result = build(source);
+  Simulator reference;
+  reference.load(result.words, result.segments);
+  const uint64_t total = reference.run(maxSteps).steps;
+
+  Simulator candidate;
+  candidate.setEngine(engine);
+  candidate.setJitThreshold(jitThreshold);
+  for (uint64_t limit = 0; limit <= total + 1; limit++) {
+    Simulator interpreter;
+    interpreter.load(result.words, result.segments);
+    candidate.load(result.words, result.segments);
+    Simulator::RunResult a = interpreter.run(limit);
+    Simulator::RunResult b = candidate.run(limit);
+    ASSERT_EQ(a.reason, b.reason) << "limit " << limit;
+    ASSERT_EQ(a.steps, b.steps) << "limit " << limit;
+    expectSameState(interpreter, candidate, "limit " + std::to_string(limit));
+    for (uint32_t address = 0; address < Simulator::MEMORY_WORDS; address++) {
+      ASSERT_EQ(interpreter.readMemory(address), candidate.readMemory(address)) << "address " << address;
+    }
+  }
+}
+
+// Fused constants, compare-and-branch, calls, shifts and the stack.
+static const char* const MIXED_PROGRAM =
+  "       mv   sp, =0x1000\n"
+  "       mv   r0, =0x1234\n"
+  "       mv   r1, =0xFFFF\n"
+  "       mv   r4, #0\n"
+  "LOOP:  add  r4, #3\n"
+  "       cmp  r4, #20\n"
+  "       bcc  LOOP\n"
+  "       bl   SUB\n"
+  "       sub  r1, #1\n"
+  "       bne  SKIP\n"
+  "SKIP:  ror  r0, #4\n"
+  "       mv   r2, #3\n"
+  "       asr  r1, r2\n"
+  "       xor  r0, r1\n"
+  "       mv   r3, pc\n"
+  "       b    END\n"
+  "SUB:   push lr\n"
+  "       push r4\n"
+  "       pop  r2\n"
+  "       and  r2, #0xF\n"
+  "       mv   r3, =DATA\n"
+  "       ld   r3, [r3]\n"
+  "       pop  lr\n"
+  "       mv   pc, lr\n"
+  "END:   b    END\n"
+  "DATA:  .word 0xBEEF\n";
+
+// Self-modifying code: the loop body rewrites its own add #1 into add #2
+// after the first pass, and the store lands inside the block.
+static const char* const SELF_MODIFYING_PROGRAM =
+  "       mv   r0, #0\n"
+  "       mv   r1, #4\n"
+  "       mv   r3, =PATCH\n"
+  "       mv   r4, =NEW\n"
+  "       ld   r4, [r4]\n"
+  "LOOP:  st   r4, [r3]\n"
+  "PATCH: add  r0, #1\n"
+  "       sub  r1, #1\n"
+  "       bne  LOOP\n"
+  "END:   b    END\n"
+  "NEW:   add  r0, #2\n";
+
+TEST(SimulatorTest, BlockEngineMatchesInterpreter) {
+  expectEnginesAgree(MIXED_PROGRAM, 1000, Simulator::Engine::BLOCKS);
+  expectEnginesAgree(SELF_MODIFYING_PROGRAM, 1000, Simulator::Engine::BLOCKS);
+}
+
+TEST(SimulatorTest, JitMatchesInterpreter) {
+  if (!JitCompiler::isSupported()) {
+    GTEST_SKIP() << "no JIT for this platform";
+  }
+  for (unsigned threshold : {0u, 2u}) {
+    expectEnginesAgree(MIXED_PROGRAM, 1000, Simulator::Engine::JIT, threshold);
+    expectEnginesAgree(SELF_MODIFYING_PROGRAM, 1000, Simulator::Engine::JIT, threshold);
+  }
+}
+
+// Every instruction form, as the assembler encodes it.
+static const char* const INSTRUCTION_FORMS[] = {
+  "mv r1, r4", "mv lr, #-7", "mvt r3, #0xA5", "mv r2, =0x1234", "mv sp, =0xFF00",
+  "add r0, r1", "add sp, #255", "add r4, #-256", "add lr, lr",
+  "sub r1, r2", "sub lr, #1", "sub r0, r0", "cmp r3, r0", "cmp r4, #5", "cmp sp, #-1",
+  "and r2, sp", "and r1, #0xF0", "xor r0, r4", "xor lr, r1",
+  "lsl r1, r2", "lsl r4, #15", "lsr r3, #4", "lsr sp, r0", "asr r4, r0", "asr r2, #15",
+  "ror r0, #1", "ror sp, r3", "ror lr, #8",
+  "ld r1, [r4]", "ld sp, [lr]", "ld r0, [r0]", "st r2, [r3]", "st lr, [sp]", "st r4, [r4]",
+  "push r1", "push sp", "push lr", "pop r3", "pop sp", "pop lr",
+  "beq T\nmv r0, #1\nT: mv r1, #2", "bne T\nmv r0, #1\nT: mv r1, #2",
+  "bcc T\nmv r0, #1\nT: mv r1, #2", "bcs T\nmv r0, #1\nT: mv r1, #2",
+  "bpl T\nmv r0, #1\nT: mv r1, #2", "bmi T\nmv r0, #1\nT: mv r1, #2",
+  "cmp r0, r1\nbcs T\nmv r0, #1\nT: mv r1, #2", "sub r2, #1\nbne T\nmv r0, #1\nT: mv r1, #2",
+  "bl T\nmv r0, #1\nT: mv r1, lr", "b T\nmv r0, #1\nT: mv r1, #2",
+};
+
+// Every instruction form, compiled on first use and run from random
+// registers, flags and memory.
+TEST(SimulatorTest, JitMatchesInterpreterPerInstruction) {
+  if (!JitCompiler::isSupported()) {
+    GTEST_SKIP() << "no JIT for this platform";
+  }
+  uint32_t seed = 12345;
+  auto random = [&seed]() {
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<uint16_t>(seed >> 8);
+  };
+
+  Simulator jit;
+  jit.setEngine(Simulator::Engine::JIT);
+  jit.setJitThreshold(0);
+  for (const char* form : INSTRUCTION_FORMS) {
+    AssembleResult result = build(std::string(form) + "\nEND: b END\n");
+    for (int trial = 0; trial < 40; trial++) {
+      Simulator interpreter;
+      interpreter.load(result.words, result.segments);
+      jit.load(result.words, result.segments);
+      std::vector<uint16_t> probes;
+      for (int i = 0; i < 7; i++) {
+        const uint16_t value = trial == 0 ? static_cast<uint16_t>(i) : random();
+        interpreter.setRegister(i, value);
+        jit.setRegister(i, value);
+        probes.push_back(value);
+        probes.push_back(static_cast<uint16_t>(value - 1));
+      }
+      for (uint16_t address : probes) {
+        if (address >= result.words.size()) {
+          const uint16_t value = random();
+          interpreter.writeMemory(address, value);
+          jit.writeMemory(address, value);
+        }
+      }
+      const uint16_t flags = random();
+      interpreter.setFlags(flags & 1, flags & 2, flags & 4);
+      jit.setFlags(flags & 1, flags & 2, flags & 4);
+
+      Simulator::RunResult a = interpreter.run(20);
+      Simulator::RunResult b = jit.run(20);
+      const std::string context = std::string(form) + ", trial " + std::to_string(trial);
+      ASSERT_EQ(a.reason, b.reason) << context;
+      ASSERT_EQ(a.steps, b.steps) << context;
+      expectSameState(interpreter, jit, context);
+      for (uint16_t address : probes) {
+        ASSERT_EQ(interpreter.readMemory(address), jit.readMemory(address)) << context << ", address " << address;
+      }
+    }
+  }
+}
+
+// Start state of one lockstep lane.
+struct LaneStart {
+  uint16_t registers[8] = {};
+  bool z = false, n = false, c = false;
+  std::vector<std::pair<uint16_t, uint16_t>> memory;
+  uint64_t maxSteps = 0;
+};
+
+// Runs starts (one per lane) as one lockstep batch and each of them on its
+// own interpreter, then compares stop reasons, steps, registers, flags and
+// the words at probes lane by lane.
+static void expectLockstepAgrees(LockstepSimulator& lockstep, const AssembleResult& result,
+                                 const std::vector<LaneStart>& starts, const std::vector<uint16_t>& probes,
+                                 const std::string& context) {
+  ASSERT_EQ(starts.size(), static_cast<size_t>(LockstepSimulator::LANES));
+  lockstep.load(result.words, result.segments);
+  uint64_t maxSteps[LockstepSimulator::LANES];
+  Simulator::RunResult runs[LockstepSimulator::LANES];
+  for (int lane = 0; lane < LockstepSimulator::LANES; lane++) {
+    const LaneStart& start = starts[lane];
+    for (int i = 0; i < 8; i++) lockstep.setRegister(lane, i, start.registers[i]);
+    for (const auto& word : start.memory) lockstep.writeMemory(lane, word.first, word.second);
+    lockstep.setFlags(lane, start.z, start.n, start.c);
+    maxSteps[lane] = start.maxSteps;
+  }
+  lockstep.run(maxSteps, runs);
+
+  for (int lane = 0; lane < LockstepSimulator::LANES; lane++) {
+    const LaneStart& start = starts[lane];
+    Simulator interpreter;
+    interpreter.load(result.words, result.segments);
+    for (int i = 0; i < 8; i++) interpreter.setRegister(i, start.registers[i]);
+    for (const auto& word : start.memory) interpreter.writeMemory(word.first, word.second);
+    interpreter.setFlags(start.z, start.n, start.c);
+    const Simulator::RunResult expected = interpreter.run(start.maxSteps);
+
+    const std::string where = context + ", lane " + std::to_string(lane);
+    ASSERT_EQ(expected.reason, runs[lane].reason) << where;
+    ASSERT_EQ(expected.steps, runs[lane].steps) << where;
+    for (int i = 0; i < 8; i++) {
+      ASSERT_EQ(interpreter.getRegister(i), lockstep.getRegister(lane, i)) << "r" << i << ", " << where;
+    }
+    ASSERT_EQ(interpreter.zeroFlag(), lockstep.zeroFlag(lane)) << where;
+    ASSERT_EQ(interpreter.negativeFlag(), lockstep.negativeFlag(lane)) << where;
+    ASSERT_EQ(interpreter.carryFlag(), lockstep.carryFlag(lane)) << where;
+    for (uint16_t address : probes) {
+      ASSERT_EQ(interpreter.readMemory(address), lockstep.readMemory(lane, address)) << where << ", address "
+                                                                                      << address;
+    }
+  }
+}
+
+// Every instruction form with a different random state and step limit in
+// each lane, so branches, shift amounts and addresses disagree across lanes.
+TEST(SimulatorTest, LockstepMatchesInterpreterPerInstruction) {
+  uint32_t seed = 777;
+  auto random = [&seed]() {
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<uint16_t>(seed >> 8);
+  };
+  LockstepSimulator lockstep;
+  for (const char* form : INSTRUCTION_FORMS) {
+    AssembleResult result = build(std::string(form) + "\nEND: b END\n");
+    for (int batch = 0; batch < 3; batch++) {
+      std::vector<LaneStart> starts(LockstepSimulator::LANES);
+      std::vector<uint16_t> probes;
+      for (int lane = 0; lane < LockstepSimulator::LANES; lane++) {
+        LaneStart& start = starts[lane];
+        // Batch 0 keeps most lanes identical to check the uniform paths.
+        const bool same = batch == 0 && lane % 4 != 3;
+        for (int i = 0; i < 7; i++) {
+          start.registers[i] = same ? static_cast<uint16_t>(0x40 + i) : random();
+          probes.push_back(start.registers[i]);
+          probes.push_back(static_cast<uint16_t>(start.registers[i] - 1));
+        }
+        const uint16_t flags = same ? 5 : random();
+        start.z = flags & 1;
+        start.n = (flags & 2) != 0;
+        start.c = (flags & 4) != 0;
+        start.maxSteps = lane % 5 == 4 ? random() % 4 : 20;
+      }
+      for (LaneStart& start : starts) {
+        for (uint16_t address : probes) {
+          if (address >= result.words.size()) start.memory.push_back({address, random()});
+        }
+      }
+      expectLockstepAgrees(lockstep, result, starts, probes,
+                           std::string(form) + ", batch " + std::to_string(batch));
+    }
+  }
+}
+
+// Whole programs whose lanes leave loops after different trip counts, halt
+// at different steps and rewrite their own code in only some lanes.
+TEST(SimulatorTest, LockstepHandlesDivergentLanes) {
+  const char* const partlyPatched =
+    "       mv   r0, #0\n"
+    "       mv   r3, =PATCH\n"
+    "       mv   r4, =NEW\n"
+    "       ld   r4, [r4]\n"
+    "       cmp  r2, #0\n"
+    "       beq  LOOP\n"
+    "       st   r4, [r3]\n"
+    "LOOP:\n"
+    "PATCH: add  r0, #1\n"
+    "       sub  r1, #1\n"
+    "       bne  LOOP\n"
+    "END:   b    END\n"
+    "NEW:   add  r0, #2\n";
+  std::vector<uint16_t> probes;
+  for (uint16_t address = 0; address < 64; address++) probes.push_back(address);
+  for (uint16_t address = 0xFF0; address < 0x1000; address++) probes.push_back(address);
+
+  LockstepSimulator lockstep;
+  for (const char* source : {MIXED_PROGRAM, SELF_MODIFYING_PROGRAM}) {
+    AssembleResult result = build(source);
+    Simulator reference;
+    reference.load(result.words, result.segments);
+    const uint64_t total = reference.run(1000).steps;
+    // Every limit up to one past the full run, spread over the lanes.
+    for (uint64_t first = 0; first <= total + 1; first += LockstepSimulator::LANES) {
+      std::vector<LaneStart> starts(LockstepSimulator::LANES);
+      for (int lane = 0; lane < LockstepSimulator::LANES; lane++) {
+        starts[lane].maxSteps = std::min(first + lane, total + 1);
+      }
+      expectLockstepAgrees(lockstep, result, starts, probes, "limit " + std::to_string(first));
+    }
+    EXPECT_EQ(lockstep.getDivergentSteps(), 0u) << "lanes of one program only differ in their limits";
+  }
+
+  AssembleResult result = build(partlyPatched);
+  std::vector<LaneStart> starts(LockstepSimulator::LANES);
+  for (int lane = 0; lane < LockstepSimulator::LANES; lane++) {
+    starts[lane].registers[1] = static_cast<uint16_t>(lane % 6);     // 0 loops until the step limit
+    starts[lane].registers[2] = static_cast<uint16_t>(lane % 3 == 0);
+    starts[lane].maxSteps = 2000 + lane;
+  }
+  expectLockstepAgrees(lockstep, result, starts, probes, "partly patched");
+  EXPECT_GT(lockstep.getDivergentSteps(), 0u);
+
+  for (LaneStart& start : starts) {
+    start.registers[1] = 5;
+    start.registers[2] = 1;
+  }
+  expectLockstepAgrees(lockstep, result, starts, probes, "uniform");
+  EXPECT_EQ(lockstep.getDivergentSteps(), 0u);
+}
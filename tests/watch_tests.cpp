@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include "Watch/FileWatcher.h"
+#include <cstdio>
+#include <fstream>
+
+static void touch(const std::string& path, const std::string& text) {
+  std::ofstream out(path);
+  out << text;
+}
+
+TEST(WatchTest, SeesEveryFileOfOneDirectorySpelledDifferently) {
+  // --watch with main.s and an .incbin "./table.bin" next to it: both
+  // spellings name the same directory and must both stay watched.
+  const std::string directory = ::testing::TempDir();
+  const std::string main = directory + "watch_main.s";
+  const std::string table = directory + "./watch_table.bin";
+  const std::string other = directory + "watch_other.txt";
+  touch(main, "b 0\n");
+  touch(table, "");
+
+  FileWatcher watcher;
+  watcher.setFiles({main, table});
+  EXPECT_FALSE(watcher.waitForChange(50));
+
+  touch(main, "b 1\n");
+  EXPECT_TRUE(watcher.waitForChange(2000));
+  touch(table, "xx");
+  EXPECT_TRUE(watcher.waitForChange(2000));
+  touch(other, "not watched");
+  EXPECT_FALSE(watcher.waitForChange(200));
+
+  std::remove(main.c_str());
+  std::remove(table.c_str());
+  std::remove(other.c_str());
+}